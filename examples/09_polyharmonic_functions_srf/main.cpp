@@ -48,7 +48,8 @@ int main(int argc, char **argv)
 
     // visual controls to setup the level of harmonicity (1,2,...)
     // and to compute and reset the field
-    Profiler profiler;
+    Profiler      profiler;
+    OperatorCache cache; // re-computing the field with the same constraints and n only costs a back substitution
     gui.callback_app_controls = [&]()
     {
         static int n_harmonic = 1;
@@ -58,7 +59,7 @@ int main(int argc, char **argv)
             if(dirichlet_bcs.size()>=2 && has_at_least_one_max && has_at_least_one_min)
             {
                 profiler.push("harmonic_map");
-                harmonic_map(m, dirichlet_bcs, (uint)n_harmonic, COTANGENT).copy_to_mesh(m);
+                harmonic_map(m, cache, dirichlet_bcs, (uint)n_harmonic, COTANGENT).copy_to_mesh(m);
                 profiler.pop();
                 m.show_texture1D(TEXTURE_1D_PARULA_W_ISOLINES);
             }
@@ -17,7 +17,8 @@ int main(int argc, char **argv)
 
     // visual controls to setup the level of harmonicity (1,2,...)
     // and to compute and reset the field
-    Profiler profiler;
+    Profiler      profiler;
+    OperatorCache cache; // re-computing the field with the same constraints and n only costs a back substitution
     gui.callback_app_controls = [&]()
     {
         static int n_harmonic = 1;
@@ -26,7 +27,7 @@ int main(int argc, char **argv)
         {
             std::map<uint,double> bc = {{0,0.0}, {999,1.0}}; // Dirichlet boundary conditions
             profiler.push("harmonic_map");
-            harmonic_map(m, bc, (uint)n_harmonic, COTANGENT).copy_to_mesh(m);
+            harmonic_map(m, cache, bc, (uint)n_harmonic, COTANGENT).copy_to_mesh(m);
             profiler.pop();
             m.show_in_texture1D (TEXTURE_1D_PARULA_W_ISOLINES);
             m.show_out_texture1D(TEXTURE_1D_PARULA_W_ISOLINES);
@@ -0,0 +1,127 @@
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/vertex_mass.h>
+#include <cinolib/linear_solvers.h>
+#include <cinolib/iterative_solvers.h>
+#include <cinolib/multigrid.h>
+#include <cinolib/icosphere.h>
+#include <cinolib/grid_mesh.h>
+#include <cinolib/tetrahedralization.h>
+#include <cinolib/subdivision_1_to_4.h>
+#include <cinolib/profiler.h>
+
+/* Scaling benchmark of the solvers for mesh Laplacian systems. For subdivided
+ * icospheres and tetrahedral grids of increasing size, solves the (screened)
+ * Poisson system (M - L) x = b with:
+ *
+ *  - a direct solver (only for small meshes)
+ *  - CG with Jacobi preconditioner
+ *  - multigrid, with algebraic and geometric coarsening
+ *  - CG with multigrid preconditioner
+ *
+ * reporting setup time, solve time and number of iterations. The time of
+ * multigrid and CG_MULTIGRID grows linearly with the mesh size, whereas
+ * the iterations of plain CG grow with its resolution.
+*/
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void icosphere(const uint n_subd, Trimesh<> & m)
+{
+    // icosphere() returns a triangle soup: start from the icosahedron, with
+    // shared vertices, and use the mesh subdivision to keep it conforming
+    std::vector<double> coords;
+    std::vector<uint>   tris;
+    icosphere(1.f, 0, coords, tris);
+    std::vector<vec3d>  verts;
+    std::map<vec3d,uint> vmap;
+    for(uint & vid : tris)
+    {
+        vec3d p(coords.at(3*vid), coords.at(3*vid+1), coords.at(3*vid+2));
+        auto it = vmap.find(p);
+        if(it==vmap.end())
+        {
+            it = vmap.insert(std::make_pair(p,uint(verts.size()))).first;
+            verts.push_back(p);
+        }
+        vid = it->second;
+    }
+    m = Trimesh<>(verts,tris);
+    for(uint i=0; i<n_subd; ++i) subdivision_1_to_4(m);
+    for(uint vid=0; vid<m.num_verts(); ++vid) m.vert(vid).normalize();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void benchmark(Mesh & m, const bool run_direct)
+{
+    Eigen::SparseMatrix<double> A = mass_matrix(m) - laplacian(m, COTANGENT);
+    Eigen::VectorXd b = mass_matrix(m) * Eigen::VectorXd::Random(m.num_verts());
+    Eigen::VectorXd x;
+    Profiler p;
+
+    printf("%8d verts\n", m.num_verts());
+
+    if(run_direct)
+    {
+        p.push("direct");
+        solve_square_system(A, b, x, SIMPLICIAL_LLT);
+        printf("    %-16s %9.3fs\n", "SIMPLICIAL_LLT", p.pop(false));
+    }
+
+    IterativeSolver cg(CG, JACOBI);
+    cg.compute(A);
+    p.push("cg");
+    cg.solve(b,x);
+    printf("    %-16s %9.3fs %6d iterations\n", "CG_JACOBI", p.pop(false), cg.iterations());
+
+    for(int geometric=0; geometric<2; ++geometric)
+    {
+        MultigridSolver mg;
+        p.push("setup");
+        if(geometric) mg.compute(A,m); else mg.compute(A);
+        double t_setup = p.pop(false);
+        p.push("solve");
+        mg.solve(b,x);
+        printf("    %-16s %9.3fs %6d iterations (setup %.3fs, %d levels)\n", geometric ? "MULTIGRID (geo)" : "MULTIGRID (alg)", p.pop(false), mg.iterations(), t_setup, mg.num_levels());
+    }
+
+    IterativeSolver cg_mg(CG, MULTIGRID_V_CYCLE);
+    p.push("setup");
+    cg_mg.compute(A);
+    double t_setup = p.pop(false);
+    p.push("cg_mg");
+    cg_mg.solve(b,x);
+    printf("    %-16s %9.3fs %6d iterations (setup %.3fs)\n", "CG_MULTIGRID", p.pop(false), cg_mg.iterations(), t_setup);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint max_subd = (argc>1) ? atoi(argv[1]) : 8;
+    uint max_grid = (argc>2) ? atoi(argv[2]) : 64;
+
+    printf("\nSubdivided icospheres\n\n");
+    for(uint n_subd=4; n_subd<=max_subd; ++n_subd)
+    {
+        Trimesh<> m;
+        icosphere(n_subd, m);
+        benchmark(m, m.num_verts()<200000);
+    }
+
+    printf("\nTetrahedral grids\n\n");
+    for(uint n=8; n<=max_grid; n*=2)
+    {
+        Hexmesh<> hm;
+        grid_mesh(n, n, n, hm);
+        Tetmesh<> m;
+        hex_to_tets(hm, m);
+        m.normalize_bbox();
+        benchmark(m, m.num_verts()<20000);
+    }
+    return 0;
+}
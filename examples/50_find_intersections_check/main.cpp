@@ -0,0 +1,144 @@
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/find_intersections.h>
+#include <cinolib/predicates.h>
+
+/* Regression checks for find_intersections. For a few synthetic inputs, and
+ * for the mesh passed as argument (if any), the pairs found by the octree
+ * based search are compared with an exhaustive all-pairs test. The synthetic
+ * inputs include flat meshes, whose bounding box has zero extent along one
+ * or more axes. Returns a non zero value if any check fails.
+*/
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void brute_force(const std::vector<vec3d> & verts,
+                 const std::vector<uint>  & tris,
+                       std::vector<ipair> & intersections)
+{
+    intersections.clear();
+    for(uint i=0;   i<tris.size()/3; ++i)
+    for(uint j=i+1; j<tris.size()/3; ++j)
+    {
+        auto res = triangle_triangle_intersect_3d(verts.at(tris.at(3*i+0)), verts.at(tris.at(3*i+1)), verts.at(tris.at(3*i+2)),
+                                                  verts.at(tris.at(3*j+0)), verts.at(tris.at(3*j+1)), verts.at(tris.at(3*j+2)));
+        if(res>SIMPLICIAL_COMPLEX) intersections.push_back(std::make_pair(i,j));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void brute_force(const std::vector<vec3d> & verts0,
+                 const std::vector<uint>  & tris0,
+                 const std::vector<vec3d> & verts1,
+                 const std::vector<uint>  & tris1,
+                       std::vector<ipair> & intersections)
+{
+    intersections.clear();
+    for(uint i=0; i<tris0.size()/3; ++i)
+    for(uint j=0; j<tris1.size()/3; ++j)
+    {
+        auto res = triangle_triangle_intersect_3d(verts0.at(tris0.at(3*i+0)), verts0.at(tris0.at(3*i+1)), verts0.at(tris0.at(3*i+2)),
+                                                  verts1.at(tris1.at(3*j+0)), verts1.at(tris1.at(3*j+1)), verts1.at(tris1.at(3*j+2)));
+        if(res>=SIMPLICIAL_COMPLEX) intersections.push_back(std::make_pair(i,j));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// n x n grid of triangles in the plane spanned by axes a0 and a1, at height h along the third axis
+void planar_grid(const uint n, const int a0, const int a1, const double h, std::vector<vec3d> & verts, std::vector<uint> & tris)
+{
+    int a2 = 3 - a0 - a1;
+    uint base = uint(verts.size());
+    for(uint i=0; i<=n; ++i)
+    for(uint j=0; j<=n; ++j)
+    {
+        vec3d p(0,0,0);
+        p[a0] = double(i)/n;
+        p[a1] = double(j)/n;
+        p[a2] = h;
+        verts.push_back(p);
+    }
+    for(uint i=0; i<n; ++i)
+    for(uint j=0; j<n; ++j)
+    {
+        uint v00 = base + i*(n+1) + j;
+        uint v10 = v00 + n + 1;
+        tris.insert(tris.end(), { v00, v10, v10+1 });
+        tris.insert(tris.end(), { v00, v10+1, v00+1 });
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+bool check(const std::string & name, const std::vector<ipair> & found, const std::vector<ipair> & expected)
+{
+    bool ok = (found==expected);
+    std::cout << (ok ? "[ OK ] " : "[FAIL] ") << name << ": " << found.size() << " pairs found, " << expected.size() << " expected" << std::endl;
+    return ok;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    bool ok = true;
+    std::vector<ipair> found, expected;
+
+    // two overlapping coplanar triangles (flat along z)
+    {
+        std::vector<vec3d> verts = { vec3d(0,0,0), vec3d(1,0,0), vec3d(0,1,0),
+                                     vec3d(0.2,0.2,0), vec3d(1.2,0.2,0), vec3d(0.2,1.2,0) };
+        std::vector<uint>  tris  = { 0,1,2, 3,4,5 };
+        find_intersections(verts, tris, found);
+        ok &= check("two coplanar triangles", found, { std::make_pair(0u,1u) });
+
+        std::vector<vec3d> verts0(verts.begin(), verts.begin()+3), verts1(verts.begin()+3, verts.end());
+        std::vector<uint>  tri = { 0,1,2 };
+        find_intersections(verts0, tri, verts1, tri, found);
+        ok &= check("two coplanar triangles (two meshes)", found, { std::make_pair(0u,0u) });
+    }
+
+    // planar grids (flat along each axis), large enough to subdivide the octree,
+    // with an extra triangle lying on the grid plane and overlapping some of its triangles
+    for(int axis=0; axis<3; ++axis)
+    {
+        int a0 = (axis+1)%3;
+        int a1 = (axis+2)%3;
+        std::vector<vec3d> verts;
+        std::vector<uint>  tris;
+        planar_grid(40, a0, a1, 0.0, verts, tris);
+        std::vector<vec3d> verts1;
+        std::vector<uint>  tris1 = { 0,1,2 };
+        vec3d p0(0,0,0), p1(0,0,0), p2(0,0,0);
+        p0[a0] = 0.31; p0[a1] = 0.27;
+        p1[a0] = 0.83; p1[a1] = 0.42;
+        p2[a0] = 0.45; p2[a1] = 0.91;
+        verts1 = { p0, p1, p2 };
+
+        find_intersections(verts, tris, verts1, tris1, found);
+        brute_force(verts, tris, verts1, tris1, expected);
+        ok &= check("planar grid vs triangle (flat along axis " + std::to_string(axis) + ")", found, expected);
+
+        uint off = uint(verts.size());
+        verts.insert(verts.end(), verts1.begin(), verts1.end());
+        tris.insert(tris.end(), { off, off+1, off+2 });
+        find_intersections(verts, tris, found);
+        brute_force(verts, tris, expected);
+        ok &= check("planar grid with overlapping triangle (flat along axis " + std::to_string(axis) + ")", found, expected);
+    }
+
+    // user provided mesh
+    if(argc==2)
+    {
+        Trimesh<> m(argv[1]);
+        auto tris = serialized_vids_from_polys(m.vector_polys());
+        find_intersections(m.vector_verts(), tris, found);
+        brute_force(m.vector_verts(), tris, expected);
+        ok &= check(argv[1], found, expected);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -115,8 +115,8 @@ void ARAP(AbstractMesh<M,V,E,P> & m, ARAP_data & data)
         }
         data.A = Eigen::SparseMatrix<double>(size, (data.use_soft_constraints) ? m.num_verts() : size);
         data.A.setFromTriplets(entries.begin(), entries.end());
-        if(data.use_soft_constraints) data.cache.derived().compute(data.A.transpose()*data.W.asDiagonal()*data.A);
-        else data.cache.derived().compute(data.A);
+        if(data.use_soft_constraints) data.cache.compute(data.A.transpose()*data.W.asDiagonal()*data.A);
+        else data.cache.compute(data.A);
 
         if(data.warm_start_with_laplacian)
         {
@@ -145,9 +145,9 @@ void ARAP(AbstractMesh<M,V,E,P> & m, ARAP_data & data)
             }
             if(data.use_soft_constraints)
             {
-                auto x = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_x).eval();
-                auto y = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_y).eval();
-                auto z = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_z).eval();
+                Eigen::VectorXd x = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_x);
+                Eigen::VectorXd y = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_y);
+                Eigen::VectorXd z = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_z);
                 data.xyz_out.resize(m.num_verts());
                 for(uint vid=0; vid<m.num_verts(); ++vid)
                 {
@@ -156,9 +156,9 @@ void ARAP(AbstractMesh<M,V,E,P> & m, ARAP_data & data)
             }
             else
             {
-                auto x = data.cache.solve(rhs_x).eval();
-                auto y = data.cache.solve(rhs_y).eval();
-                auto z = data.cache.solve(rhs_z).eval();
+                Eigen::VectorXd x = data.cache.solve(rhs_x);
+                Eigen::VectorXd y = data.cache.solve(rhs_y);
+                Eigen::VectorXd z = data.cache.solve(rhs_z);
                 data.xyz_out.resize(m.num_verts());
                 for(uint vid=0; vid<m.num_verts(); ++vid)
                 {
@@ -247,9 +247,9 @@ void ARAP(AbstractMesh<M,V,E,P> & m, ARAP_data & data)
                 rhs_z[new_row] = bc.second.z();
                 ++new_row;
             }
-            auto x = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_x).eval();
-            auto y = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_y).eval();
-            auto z = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_z).eval();
+            Eigen::VectorXd x = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_x);
+            Eigen::VectorXd y = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_y);
+            Eigen::VectorXd z = data.cache.solve(data.A.transpose()*data.W.asDiagonal()*rhs_z);
             for(uint vid=0; vid<m.num_verts(); ++vid)
             {
                 data.xyz_out[vid] = vec3d(x[vid],y[vid],z[vid]);
@@ -257,9 +257,9 @@ void ARAP(AbstractMesh<M,V,E,P> & m, ARAP_data & data)
         }
         else
         {
-            auto x = data.cache.solve(rhs_x).eval();
-            auto y = data.cache.solve(rhs_y).eval();
-            auto z = data.cache.solve(rhs_z).eval();
+            Eigen::VectorXd x = data.cache.solve(rhs_x);
+            Eigen::VectorXd y = data.cache.solve(rhs_y);
+            Eigen::VectorXd z = data.cache.solve(rhs_z);
             for(uint vid=0; vid<m.num_verts(); ++vid)
             {
                 int col = data.col_map[vid];
@@ -274,7 +274,25 @@ void ARAP(AbstractMesh<M,V,E,P> & m, ARAP_data & data)
 
     //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+    // soft constraint weights changed since the last call: same
+    // pattern, different values (no need to re-analyze the matrix)
+    auto update_weights = [&]()
+    {
+        uint nv   = m.num_verts();
+        uint size = uint(data.W.size());
+        bool changed = false;
+        for(uint i=0;  i<nv;   ++i) changed |= (data.W[i] != data.w_laplace);
+        for(uint i=nv; i<size; ++i) changed |= (data.W[i] != data.w_constr);
+        if(!changed) return;
+        data.W.head(nv).setConstant(data.w_laplace);
+        data.W.tail(size-nv).setConstant(data.w_constr);
+        data.cache.refactorize(data.A.transpose()*data.W.asDiagonal()*data.A);
+    };
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
     if(data.init) init();
+    else if(data.use_soft_constraints) update_weights();
 
     for(uint i=0; i<data.n_iters; ++i)
     {
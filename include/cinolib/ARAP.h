@@ -64,7 +64,7 @@ struct ARAP_data
     std::vector<double> w;       // edge weights { UNIFORM, COTANGENT }
     int w_type = UNIFORM;        // WARNING: cot weights seem rather unstable on volume meshes in interactive deformations
 
-    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> cache; // factorized matrix
+    SparseFactorization cache; // factorized matrix
 
     // In my experience replacing hard with soft constraints works
     // much better for interactive shape deformation (no artifacts
@@ -72,6 +72,8 @@ struct ARAP_data
     // On the other hand, things like simplicial volume maps require
     // the use of hard constraints to ensure boundary conformity.
     bool   use_soft_constraints = true;
+    // Weights can be changed between calls without re-initializing: the matrix
+    // will be numerically refactorized, reusing its symbolic analysis
     double w_constr  = 100.0;      // weight for soft constraints
     double w_laplace = 1.0;        // weight for the laplacian component of the matrix
     Eigen::VectorXd W;             // diagonal matrix of weights
@@ -101,7 +101,7 @@ void ARAP_2D_mapping(Trimesh<M,V,E,P> & m, ARAP_2D_map_data & data)
         }
         Eigen::SparseMatrix<double> A(m.num_verts()-1, m.num_verts()-1);
         A.setFromTriplets(entries.begin(), entries.end());
-        data.cache.derived().compute(A);
+        data.cache.compute(A);
     };
 
     auto local_step = [&]()
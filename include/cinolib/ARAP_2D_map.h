@@ -61,7 +61,7 @@ struct ARAP_2D_map_data
     std::vector<vec2d>  uv_loc; // per triangle uv targets (100% rigid)
     std::vector<double> w;      // edge weights (cotangent)
 
-    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> cache; // factorized matrix
+    SparseFactorization cache; // factorized matrix
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -65,6 +65,10 @@ void solve_IRLS(const Eigen::SparseMatrix<double> & A,
     Eigen::VectorXd w(A.rows());
     for(int i=0; i<A.rows(); ++i) w[i] = 1.0;
 
+    // weights change at each iteration, but the pattern of the normal equations
+    // does not: the symbolic analysis of the matrix is done only once
+    SparseFactorization factorization(solver);
+
     double res      = 0;
     double prev_res = 0;
     int    iter     = 0;
@@ -73,7 +77,7 @@ void solve_IRLS(const Eigen::SparseMatrix<double> & A,
         prev_res = res;
 
         // minimize L2
-        solve_weighted_least_squares(A, w, b, x, solver);
+        solve_weighted_least_squares(A, w, b, x, factorization);
 
         // update weights
         for(int i=0; i<A.rows(); ++i)
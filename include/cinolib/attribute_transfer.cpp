@@ -0,0 +1,433 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/attribute_transfer.h>
+#include <cinolib/octree.h>
+#include <cinolib/tet_locator.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+namespace
+{
+    // source elements (vertices) and weights that contribute to a target value
+    struct TransferStencil
+    {
+        uint   n = 0;
+        uint   id[4];
+        double w [4];
+
+        void push(const uint i, const double wi) { id[n] = i; w[n] = wi; ++n; }
+    };
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // the value with the highest total weight (the first one wins ties)
+    template<typename T>
+    CINO_INLINE
+    T vote(const std::vector<T> & f, const uint * ids, const double * w, const uint n)
+    {
+        uint   best   = 0;
+        double best_w = -1;
+        for(uint i=0; i<n; ++i)
+        {
+            double sum = 0;
+            for(uint j=0; j<n; ++j) if(f.at(ids[j])==f.at(ids[i])) sum += w[j];
+            if(sum>best_w)
+            {
+                best   = i;
+                best_w = sum;
+            }
+        }
+        return f.at(ids[best]);
+    }
+
+    template<typename T>
+    CINO_INLINE
+    T vote(const std::vector<T> & f, const TransferStencil & s)
+    {
+        return vote(f, s.id, s.w, s.n);
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    template<typename T>
+    CINO_INLINE
+    T interpolate(const std::vector<T> & f, const TransferStencil & s)
+    {
+        T res = f.at(s.id[0]) * s.w[0];
+        for(uint i=1; i<s.n; ++i) res = res + f.at(s.id[i]) * s.w[i];
+        return res;
+    }
+
+    CINO_INLINE
+    Color interpolate(const std::vector<Color> & f, const TransferStencil & s)
+    {
+        Color res(0,0,0,0);
+        for(uint i=0; i<s.n; ++i)
+        for(uint c=0; c<4; ++c) res[c] += float(s.w[i]) * f.at(s.id[i])[c];
+        return res;
+    }
+
+    // labels cannot be interpolated
+    CINO_INLINE
+    int interpolate(const std::vector<int> & f, const TransferStencil & s)
+    {
+        return vote(f, s);
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // nearest source vertex for each query point
+    template<class M, class V, class E, class P>
+    CINO_INLINE
+    void nearest_vert_stencils(const AbstractMesh<M,V,E,P>   & src,
+                               const std::vector<vec3d>      & q,
+                                     std::vector<TransferStencil> & s)
+    {
+        Octree o;
+        o.build_from_mesh_points(src);
+        std::vector<uint>  index;
+        std::vector<vec3d> pos;
+        std::vector<vec4d> bc;
+        o.closest_points(q, index, pos, bc);
+        s.resize(q.size());
+        for(uint i=0; i<q.size(); ++i)
+        {
+            s.at(i).n = 0;
+            s.at(i).push(o.items.at(index.at(i))->id, 1.0);
+        }
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // nearest point on the source surface for each query point
+    template<class M, class V, class E, class P>
+    CINO_INLINE
+    void vert_stencils(const AbstractPolygonMesh<M,V,E,P> & src,
+                       const std::vector<vec3d>           & q,
+                       const TransferMode                   mode,
+                             std::vector<TransferStencil> & s)
+    {
+        if(mode==TRANSFER_NEAREST)
+        {
+            nearest_vert_stencils(src, q, s);
+            return;
+        }
+
+        // octree items are the triangles of the poly tessellations (in this order)
+        std::vector<uint> tris;
+        for(uint pid=0; pid<src.num_polys(); ++pid)
+        {
+            const std::vector<uint> & tess = src.poly_tessellation(pid);
+            tris.insert(tris.end(), tess.begin(), tess.end());
+        }
+        Octree o;
+        o.build_from_mesh_polys(src);
+        assert(o.items.size()*3==tris.size());
+
+        std::vector<uint>  index;
+        std::vector<vec3d> pos;
+        std::vector<vec4d> bc;
+        o.closest_points(q, index, pos, bc);
+        s.resize(q.size());
+        PARALLEL_FOR(0, uint(q.size()), 1000, [&](uint i)
+        {
+            s.at(i).n = 0;
+            for(uint k=0; k<3; ++k) s.at(i).push(tris.at(3*index.at(i)+k), bc.at(i)[k]);
+        });
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // containing source tet for each query point (or nearest vertex, if none)
+    template<class M, class V, class E, class F, class P>
+    CINO_INLINE
+    void vert_stencils(const AbstractPolyhedralMesh<M,V,E,F,P> & src,
+                       const std::vector<vec3d>                & q,
+                       const TransferMode                        mode,
+                             std::vector<TransferStencil>      & s)
+    {
+        if(mode==TRANSFER_NEAREST || src.mesh_type()!=TETMESH)
+        {
+            nearest_vert_stencils(src, q, s);
+            return;
+        }
+
+        std::vector<uint> tets;
+        tets.reserve(4*src.num_polys());
+        for(uint pid=0; pid<src.num_polys(); ++pid)
+        for(uint off=0; off<4; ++off) tets.push_back(src.poly_vert_id(pid,off));
+
+        TetLocator locator(src.vector_verts(), tets);
+        std::vector<int>   pids;
+        std::vector<vec4d> bc;
+        locator.locate(q, pids, bc);
+
+        std::vector<uint>  misses;
+        std::vector<vec3d> miss_q;
+        s.resize(q.size());
+        for(uint i=0; i<q.size(); ++i)
+        {
+            s.at(i).n = 0;
+            if(pids.at(i)>=0)
+            {
+                for(uint k=0; k<4; ++k) s.at(i).push(tets.at(4*pids.at(i)+k), bc.at(i)[k]);
+            }
+            else
+            {
+                misses.push_back(i);
+                miss_q.push_back(q.at(i));
+            }
+        }
+        if(misses.empty()) return;
+
+        std::vector<TransferStencil> miss_s;
+        nearest_vert_stencils(src, miss_q, miss_s);
+        for(uint i=0; i<misses.size(); ++i) s.at(misses.at(i)) = miss_s.at(i);
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // source poly with the closest centroid to each query point
+    template<class M, class V, class E, class P>
+    CINO_INLINE
+    void nearest_centroid_polys(const AbstractMesh<M,V,E,P> & src,
+                                const std::vector<vec3d>    & q,
+                                      std::vector<uint>     & ids)
+    {
+        Octree o;
+        for(uint pid=0; pid<src.num_polys(); ++pid) o.push_point(pid, src.poly_centroid(pid));
+        o.build();
+        std::vector<uint>  index;
+        std::vector<vec3d> pos;
+        std::vector<vec4d> bc;
+        o.closest_points(q, index, pos, bc);
+        ids.resize(q.size());
+        for(uint i=0; i<q.size(); ++i) ids.at(i) = o.items.at(index.at(i))->id;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // source poly closest to each query point
+    template<class M, class V, class E, class P>
+    CINO_INLINE
+    void source_polys(const AbstractPolygonMesh<M,V,E,P> & src,
+                      const std::vector<vec3d>           & q,
+                            std::vector<uint>            & ids)
+    {
+        Octree o;
+        o.build_from_mesh_polys(src);
+        std::vector<uint>  index;
+        std::vector<vec3d> pos;
+        std::vector<vec4d> bc;
+        o.closest_points(q, index, pos, bc);
+        ids.resize(q.size());
+        for(uint i=0; i<q.size(); ++i) ids.at(i) = o.items.at(index.at(i))->id;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // source tet containing each query point (or poly with the closest centroid, if none)
+    template<class M, class V, class E, class F, class P>
+    CINO_INLINE
+    void source_polys(const AbstractPolyhedralMesh<M,V,E,F,P> & src,
+                      const std::vector<vec3d>                & q,
+                            std::vector<uint>                 & ids)
+    {
+        if(src.mesh_type()!=TETMESH)
+        {
+            nearest_centroid_polys(src, q, ids);
+            return;
+        }
+
+        std::vector<uint> tets;
+        tets.reserve(4*src.num_polys());
+        for(uint pid=0; pid<src.num_polys(); ++pid)
+        for(uint off=0; off<4; ++off) tets.push_back(src.poly_vert_id(pid,off));
+
+        TetLocator locator(src.vector_verts(), tets);
+        std::vector<int>   pids;
+        std::vector<vec4d> bc;
+        locator.locate(q, pids, bc);
+
+        std::vector<uint>  misses;
+        std::vector<vec3d> miss_q;
+        ids.resize(q.size());
+        for(uint i=0; i<q.size(); ++i)
+        {
+            if(pids.at(i)>=0) ids.at(i) = uint(pids.at(i));
+            else
+            {
+                misses.push_back(i);
+                miss_q.push_back(q.at(i));
+            }
+        }
+        if(misses.empty()) return;
+
+        std::vector<uint> miss_ids;
+        nearest_centroid_polys(src, miss_q, miss_ids);
+        for(uint i=0; i<misses.size(); ++i) ids.at(misses.at(i)) = miss_ids.at(i);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1, typename T>
+CINO_INLINE
+void transfer_vert_field(const Mesh0          & src,
+                         const std::vector<T> & src_field,
+                         const Mesh1          & tgt,
+                               std::vector<T> & tgt_field,
+                         const TransferMode     mode)
+{
+    assert(src_field.size()==src.num_verts());
+
+    std::vector<TransferStencil> s;
+    vert_stencils(src, tgt.vector_verts(), mode, s);
+
+    tgt_field.resize(tgt.num_verts());
+    PARALLEL_FOR(0, tgt.num_verts(), 1000, [&](uint vid)
+    {
+        tgt_field.at(vid) = (mode==TRANSFER_MAJORITY) ? vote(src_field, s.at(vid))
+                                                      : interpolate(src_field, s.at(vid));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1, typename T>
+CINO_INLINE
+void transfer_poly_field(const Mesh0          & src,
+                         const std::vector<T> & src_field,
+                         const Mesh1          & tgt,
+                               std::vector<T> & tgt_field,
+                         const TransferMode     mode)
+{
+    assert(src_field.size()==src.num_polys());
+
+    // query points: centroids, plus midpoints between centroids and vertices (for majority)
+    std::vector<vec3d> q;
+    std::vector<uint>  beg(tgt.num_polys()+1);
+    for(uint pid=0; pid<tgt.num_polys(); ++pid)
+    {
+        beg.at(pid) = uint(q.size());
+        vec3d c = tgt.poly_centroid(pid);
+        q.push_back(c);
+        if(mode==TRANSFER_MAJORITY)
+        {
+            for(uint vid : tgt.adj_p2v(pid)) q.push_back((c + tgt.vert(vid)) * 0.5);
+        }
+    }
+    beg.back() = uint(q.size());
+
+    std::vector<uint> ids;
+    source_polys(src, q, ids);
+
+    tgt_field.resize(tgt.num_polys());
+    PARALLEL_FOR(0, tgt.num_polys(), 1000, [&](uint pid)
+    {
+        if(mode!=TRANSFER_MAJORITY)
+        {
+            tgt_field.at(pid) = src_field.at(ids.at(beg.at(pid)));
+            return;
+        }
+        uint n = beg.at(pid+1) - beg.at(pid);
+        std::vector<double> w(n, 1.0);
+        w.front() = 1.5; // the centroid breaks ties
+        tgt_field.at(pid) = vote(src_field, &ids.at(beg.at(pid)), w.data(), n);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_vert_labels(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode)
+{
+    std::vector<int> labels;
+    transfer_vert_field(src, src.vector_vert_labels(), tgt, labels, mode);
+    for(uint vid=0; vid<tgt.num_verts(); ++vid) tgt.vert_data(vid).label = labels.at(vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_vert_colors(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode)
+{
+    std::vector<Color> src_colors(src.num_verts()), colors;
+    for(uint vid=0; vid<src.num_verts(); ++vid) src_colors.at(vid) = src.vert_data(vid).color;
+    transfer_vert_field(src, src_colors, tgt, colors, mode);
+    for(uint vid=0; vid<tgt.num_verts(); ++vid) tgt.vert_data(vid).color = colors.at(vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_vert_uvw(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode)
+{
+    std::vector<vec3d> src_uvw(src.num_verts()), uvw;
+    for(uint vid=0; vid<src.num_verts(); ++vid) src_uvw.at(vid) = src.vert_data(vid).uvw;
+    transfer_vert_field(src, src_uvw, tgt, uvw, mode);
+    for(uint vid=0; vid<tgt.num_verts(); ++vid) tgt.vert_data(vid).uvw = uvw.at(vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_poly_labels(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode)
+{
+    std::vector<int> labels;
+    transfer_poly_field(src, src.vector_poly_labels(), tgt, labels, mode);
+    for(uint pid=0; pid<tgt.num_polys(); ++pid) tgt.poly_data(pid).label = labels.at(pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_poly_colors(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode)
+{
+    std::vector<Color> src_colors(src.num_polys()), colors;
+    for(uint pid=0; pid<src.num_polys(); ++pid) src_colors.at(pid) = src.poly_data(pid).color;
+    transfer_poly_field(src, src_colors, tgt, colors, mode);
+    for(uint pid=0; pid<tgt.num_polys(); ++pid) tgt.poly_data(pid).color = colors.at(pid);
+}
+
+}
@@ -0,0 +1,139 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_ATTRIBUTE_TRANSFER_H
+#define CINO_ATTRIBUTE_TRANSFER_H
+
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Transfer of per vertex and per element attributes (labels, colors, uvw,
+ * scalar fields,...) from a source mesh to a target mesh, e.g. after
+ * remeshing, decimation or deformation. Both meshes can be either surface
+ * or volume meshes, and do not need to share any connectivity.
+ *
+ * For each target vertex (or element) the source is queried at its position
+ * (or centroid), and the value is obtained according to the transfer mode:
+ *
+ *  - TRANSFER_NEAREST:       vertex attributes are copied from the nearest
+ *                            source vertex, element attributes from the source
+ *                            element closest to (or containing) the centroid;
+ *
+ *  - TRANSFER_CLOSEST_POINT: vertex attributes are linearly interpolated at the
+ *                            closest point of the source surface (for surfaces)
+ *                            or inside the source tet containing the query point
+ *                            (for tetmeshes). Element attributes are the same
+ *                            as TRANSFER_NEAREST;
+ *
+ *  - TRANSFER_MAJORITY:      for discrete attributes, such as labels. Vertex
+ *                            attributes get the value with the highest total
+ *                            barycentric weight at the closest point; element
+ *                            attributes get the most frequent value among the
+ *                            source elements found at the centroid and at the
+ *                            midpoints between centroid and vertices of the
+ *                            target element (ties are broken by the centroid).
+ *
+ * Queries are answered in batch (Octree::closest_points for surfaces, and
+ * TetLocator for tetmeshes), and values are computed in parallel. For volume
+ * meshes other than tetmeshes, and for target points outside a source
+ * tetmesh, interpolation falls back to the nearest vertex (or element).
+ * Interpolation requires T to support sums and products by a scalar (e.g.
+ * double, vec3d). Colors are interpolated channel by channel, whereas int
+ * attributes (i.e. labels) are always transferred by majority.
+*/
+
+typedef enum
+{
+    TRANSFER_NEAREST,
+    TRANSFER_CLOSEST_POINT,
+    TRANSFER_MAJORITY,
+}
+TransferMode;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1, typename T>
+CINO_INLINE
+void transfer_vert_field(const Mesh0          & src,
+                         const std::vector<T> & src_field,
+                         const Mesh1          & tgt,
+                               std::vector<T> & tgt_field,
+                         const TransferMode     mode = TRANSFER_CLOSEST_POINT);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh0, class Mesh1, typename T>
+CINO_INLINE
+void transfer_poly_field(const Mesh0          & src,
+                         const std::vector<T> & src_field,
+                         const Mesh1          & tgt,
+                               std::vector<T> & tgt_field,
+                         const TransferMode     mode = TRANSFER_NEAREST);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// shortcuts for the standard mesh attributes
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_vert_labels(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode = TRANSFER_MAJORITY);
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_vert_colors(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode = TRANSFER_CLOSEST_POINT);
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_vert_uvw(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode = TRANSFER_CLOSEST_POINT);
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_poly_labels(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode = TRANSFER_MAJORITY);
+
+template<class Mesh0, class Mesh1>
+CINO_INLINE
+void transfer_poly_colors(const Mesh0 & src, Mesh1 & tgt, const TransferMode mode = TRANSFER_NEAREST);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "attribute_transfer.cpp"
+#endif
+
+#endif // CINO_ATTRIBUTE_TRANSFER_H
@@ -0,0 +1,283 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/batch_intersection_tests.h>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cinolib
+{
+
+namespace
+{
+    // Pack of 4 doubles, mapped on one AVX register, two SSE2 registers
+    // or a plain array, depending on the instruction sets available at
+    // compilation time. Comparisons return a bit mask, with one bit per lane
+    struct Pack4d
+    {
+#if defined(__AVX__)
+        __m256d v;
+        Pack4d() {}
+        Pack4d(const __m256d & x) : v(x) {}
+        explicit Pack4d(const double x) : v(_mm256_set1_pd(x)) {}
+        explicit Pack4d(const double * x) : v(_mm256_loadu_pd(x)) {}
+#elif defined(__SSE2__)
+        __m128d lo, hi;
+        Pack4d() {}
+        Pack4d(const __m128d & l, const __m128d & h) : lo(l), hi(h) {}
+        explicit Pack4d(const double x) : lo(_mm_set1_pd(x)), hi(_mm_set1_pd(x)) {}
+        explicit Pack4d(const double * x) : lo(_mm_loadu_pd(x)), hi(_mm_loadu_pd(x+2)) {}
+#else
+        double v[4];
+        Pack4d() {}
+        explicit Pack4d(const double x) { v[0] = v[1] = v[2] = v[3] = x; }
+        explicit Pack4d(const double * x) { for(int i=0; i<4; ++i) v[i] = x[i]; }
+#endif
+    };
+
+#if defined(__AVX__)
+    inline Pack4d operator+(const Pack4d & a, const Pack4d & b) { return _mm256_add_pd(a.v, b.v); }
+    inline Pack4d operator-(const Pack4d & a, const Pack4d & b) { return _mm256_sub_pd(a.v, b.v); }
+    inline Pack4d operator*(const Pack4d & a, const Pack4d & b) { return _mm256_mul_pd(a.v, b.v); }
+    inline int    gt       (const Pack4d & a, const Pack4d & b) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)); }
+    inline int    lt       (const Pack4d & a, const Pack4d & b) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)); }
+    inline int    eq       (const Pack4d & a, const Pack4d & b) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)); }
+#elif defined(__SSE2__)
+    inline Pack4d operator+(const Pack4d & a, const Pack4d & b) { return Pack4d(_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)); }
+    inline Pack4d operator-(const Pack4d & a, const Pack4d & b) { return Pack4d(_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)); }
+    inline Pack4d operator*(const Pack4d & a, const Pack4d & b) { return Pack4d(_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)); }
+    inline int    gt       (const Pack4d & a, const Pack4d & b) { return _mm_movemask_pd(_mm_cmpgt_pd(a.lo, b.lo)) | (_mm_movemask_pd(_mm_cmpgt_pd(a.hi, b.hi)) << 2); }
+    inline int    lt       (const Pack4d & a, const Pack4d & b) { return _mm_movemask_pd(_mm_cmplt_pd(a.lo, b.lo)) | (_mm_movemask_pd(_mm_cmplt_pd(a.hi, b.hi)) << 2); }
+    inline int    eq       (const Pack4d & a, const Pack4d & b) { return _mm_movemask_pd(_mm_cmpeq_pd(a.lo, b.lo)) | (_mm_movemask_pd(_mm_cmpeq_pd(a.hi, b.hi)) << 2); }
+#else
+    inline Pack4d operator+(const Pack4d & a, const Pack4d & b) { Pack4d r; for(int i=0; i<4; ++i) r.v[i] = a.v[i] + b.v[i]; return r; }
+    inline Pack4d operator-(const Pack4d & a, const Pack4d & b) { Pack4d r; for(int i=0; i<4; ++i) r.v[i] = a.v[i] - b.v[i]; return r; }
+    inline Pack4d operator*(const Pack4d & a, const Pack4d & b) { Pack4d r; for(int i=0; i<4; ++i) r.v[i] = a.v[i] * b.v[i]; return r; }
+    inline int    gt       (const Pack4d & a, const Pack4d & b) { int m = 0; for(int i=0; i<4; ++i) m |= (a.v[i] > b.v[i]) << i; return m; }
+    inline int    lt       (const Pack4d & a, const Pack4d & b) { int m = 0; for(int i=0; i<4; ++i) m |= (a.v[i] < b.v[i]) << i; return m; }
+    inline int    eq       (const Pack4d & a, const Pack4d & b) { int m = 0; for(int i=0; i<4; ++i) m |= (a.v[i]== b.v[i]) << i; return m; }
+#endif
+
+    const int ALL_LANES = 0xF;
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // floating point orient3d, evaluated exactly as in the fast predicate
+    // (this is required for the static filter to be valid)
+    inline Pack4d orient3d_det(const Pack4d a[3], const Pack4d b[3], const Pack4d c[3], const Pack4d d[3])
+    {
+        Pack4d adx = a[0] - d[0];
+        Pack4d bdx = b[0] - d[0];
+        Pack4d cdx = c[0] - d[0];
+        Pack4d ady = a[1] - d[1];
+        Pack4d bdy = b[1] - d[1];
+        Pack4d cdy = c[1] - d[1];
+        Pack4d adz = a[2] - d[2];
+        Pack4d bdz = b[2] - d[2];
+        Pack4d cdz = c[2] - d[2];
+        return adx * (bdy * cdz - bdz * cdy)
+             + bdx * (cdy * adz - cdz * ady)
+             + cdx * (ady * bdz - adz * bdy);
+    }
+
+    // Bit mask of the lanes where the three vertices of a triangle lie strictly on the
+    // same side of a plane (i.e. their orient3d are all above the bound, or all below
+    // minus the bound). Vertices flagged as coincident with a vertex of the other
+    // triangle are exempted, provided that at least one vertex lies strictly off plane
+    inline int strictly_one_side(const Pack4d d[3], const int coincident[3], const double bound)
+    {
+        Pack4d pos_bound(bound), neg_bound(-bound);
+        int pos[3], neg[3];
+        for(int i=0; i<3; ++i)
+        {
+            pos[i] = gt(d[i],pos_bound);
+            neg[i] = lt(d[i],neg_bound);
+        }
+        return ((pos[0]|coincident[0]) & (pos[1]|coincident[1]) & (pos[2]|coincident[2]) & (pos[0]|pos[1]|pos[2])) |
+               ((neg[0]|coincident[0]) & (neg[1]|coincident[1]) & (neg[2]|coincident[2]) & (neg[0]|neg[1]|neg[2]));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void triangle_boxes_intersect(const vec3d                t[3],
+                              const std::vector<AABB>  & boxes,
+                                    std::vector<bool>  & res)
+{
+    res.assign(boxes.size(), false);
+
+    // Work in a reference frame centered at the first vertex of the triangle, to limit
+    // round off. Separating axes are: the coordinate axes (i.e. the triangle bbox), the
+    // triangle normal, and the 9 cross products between coordinate axes and triangle edges
+    const vec3d & o = t[0];
+    vec3d v[3] = { vec3d(0,0,0), t[1]-o, t[2]-o };
+    vec3d f[3] = { v[1]-v[0], v[2]-v[1], v[0]-v[2] };
+
+    vec3d tmin = v[0].min(v[1]).min(v[2]);
+    vec3d tmax = v[0].max(v[1]).max(v[2]);
+
+    const int n_axes = 10;
+    double axes[n_axes][3], amin[n_axes], amax[n_axes];
+    vec3d n = f[0].cross(f[1]);
+    axes[0][0] = n[0];
+    axes[0][1] = n[1];
+    axes[0][2] = n[2];
+    amin[0] = amax[0] = 0; // the plane passes through v[0]
+    vec3d XYZ[3] = { vec3d(1,0,0), vec3d(0,1,0), vec3d(0,0,1) };
+    for(int i=0; i<3; ++i)
+    for(int j=0; j<3; ++j)
+    {
+        int   id = 1 + 3*i + j;
+        vec3d a  = XYZ[i].cross(f[j]);
+        double p0 = a.dot(v[0]);
+        double p1 = a.dot(v[1]);
+        double p2 = a.dot(v[2]);
+        for(int k=0; k<3; ++k) axes[id][k] = a[k];
+        amin[id] = std::min(p0,std::min(p1,p2));
+        amax[id] = std::max(p0,std::max(p1,p2));
+    }
+
+    // boxes are processed in groups of 4 (the last group is padded by replicating its last box)
+    for(size_t beg=0; beg<boxes.size(); beg+=4)
+    {
+        double bmin[3][4], bmax[3][4];
+        for(size_t l=0; l<4; ++l)
+        {
+            const AABB & b = boxes.at(std::min(beg+l, boxes.size()-1));
+            for(int k=0; k<3; ++k)
+            {
+                bmin[k][l] = b.min[k] - o[k];
+                bmax[k][l] = b.max[k] - o[k];
+            }
+        }
+        Pack4d min[3] = { Pack4d(bmin[0]), Pack4d(bmin[1]), Pack4d(bmin[2]) };
+        Pack4d max[3] = { Pack4d(bmax[0]), Pack4d(bmax[1]), Pack4d(bmax[2]) };
+
+        // conservative early reject: box vs triangle bbox
+        int sep = 0;
+        for(int k=0; k<3; ++k) sep |= lt(max[k],Pack4d(tmin[k])) | gt(min[k],Pack4d(tmax[k]));
+
+        if(sep!=ALL_LANES)
+        {
+            Pack4d half(0.5);
+            Pack4d c[3], e[3];
+            for(int k=0; k<3; ++k)
+            {
+                c[k] = (min[k] + max[k]) * half;
+                e[k] =  max[k] - c[k];
+            }
+            for(int i=0; i<n_axes && sep!=ALL_LANES; ++i)
+            {
+                Pack4d s = Pack4d(axes[i][0]) * c[0] + Pack4d(axes[i][1]) * c[1] + Pack4d(axes[i][2]) * c[2];
+                Pack4d r = Pack4d(std::fabs(axes[i][0])) * e[0] +
+                           Pack4d(std::fabs(axes[i][1])) * e[1] +
+                           Pack4d(std::fabs(axes[i][2])) * e[2];
+                sep |= gt(s-r,Pack4d(amax[i])) | lt(s+r,Pack4d(amin[i]));
+            }
+        }
+
+        for(size_t l=0; l<4 && beg+l<boxes.size(); ++l) res.at(beg+l) = !(sep & (1<<l));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void triangle_triangles_separated(const vec3d                t[3],
+                                  const std::vector<vec3d> & verts,
+                                  const FilteredPredicates & filter,
+                                  const bool                 ignore_if_valid_complex,
+                                        std::vector<bool>  & res)
+{
+    assert(verts.size()%3==0);
+    size_t n = verts.size()/3;
+    res.assign(n, false);
+
+    Pack4d a[3][3];
+    for(int i=0; i<3; ++i)
+    for(int k=0; k<3; ++k) a[i][k] = Pack4d(t[i][k]);
+
+    // triangles are processed in groups of 4 (the last group is padded by replicating its last triangle)
+    for(size_t beg=0; beg<n; beg+=4)
+    {
+        double coords[3][3][4];
+        for(size_t l=0; l<4; ++l)
+        {
+            size_t tid = std::min(beg+l, n-1);
+            for(int i=0; i<3; ++i)
+            for(int k=0; k<3; ++k) coords[i][k][l] = verts.at(3*tid+i)[k];
+        }
+        Pack4d b[3][3];
+        for(int i=0; i<3; ++i)
+        for(int k=0; k<3; ++k) b[i][k] = Pack4d(coords[i][k]);
+
+        // pairs of coincident vertices (only if the triangles are allowed to share sub-simplices)
+        int a_coinc[3] = { 0, 0, 0 };
+        int b_coinc[3] = { 0, 0, 0 };
+        if(ignore_if_valid_complex)
+        {
+            for(int i=0; i<3; ++i)
+            for(int j=0; j<3; ++j)
+            {
+                int e = eq(a[i][0],b[j][0]) & eq(a[i][1],b[j][1]) & eq(a[i][2],b[j][2]);
+                a_coinc[i] |= e;
+                b_coinc[j] |= e;
+            }
+        }
+
+        // vertices of the other triangles w.r.t. the plane of t
+        Pack4d d[3];
+        for(int i=0; i<3; ++i) d[i] = orient3d_det(a[0], a[1], a[2], b[i]);
+        int sep = strictly_one_side(d, b_coinc, filter.orient3d_bound);
+
+        // vertices of t w.r.t. the planes of the other triangles
+        if(sep!=ALL_LANES)
+        {
+            for(int i=0; i<3; ++i) d[i] = orient3d_det(b[0], b[1], b[2], a[i]);
+            sep |= strictly_one_side(d, a_coinc, filter.orient3d_bound);
+        }
+
+        for(size_t l=0; l<4 && beg+l<n; ++l) res.at(beg+l) = (sep & (1<<l));
+    }
+}
+
+}
@@ -0,0 +1,91 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BATCH_INTERSECTION_TESTS_H
+#define CINO_BATCH_INTERSECTION_TESTS_H
+
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/geometry/aabb.h>
+#include <cinolib/filtered_predicates.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Batch kernels for the narrow phase of intersection tests, which test
+ * one triangle against many boxes or triangles at once. Everything that
+ * depends only on the fixed triangle (e.g. separating axes and its
+ * projections on them) is computed only once, and the other elements are
+ * processed in groups of 4, using SSE2/AVX instructions if available at
+ * compilation time, and a portable scalar fallback otherwise. Groups are
+ * discarded as soon as all their elements are separated.
+ */
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// res[i] is true if triangle t intersects boxes[i]. Same as calling
+// boxes[i].intersects_triangle(t) for each box (i.e. it is based on the
+// separating axis theorem, and touching elements are deemed as intersecting)
+CINO_INLINE
+void triangle_boxes_intersect(const vec3d                t[3],
+                              const std::vector<AABB>  & boxes,
+                                    std::vector<bool>  & res);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Conservative early reject for triangle-triangle tests. The i-th triangle
+// is made of vertices verts[3*i], verts[3*i+1] and verts[3*i+2]. res[i] is
+// true if t and the i-th triangle are certainly disjoint, meaning that one
+// of them lies strictly on one side of the supporting plane of the other.
+// If ignore_if_valid_complex is true, res[i] is true also if the triangles
+// certainly intersect only at a shared vertex or edge (i.e. the vertices
+// of one triangle that do not coincide with vertices of the other lie
+// strictly on one side of its plane). Signs are certified with the static
+// filter, which must be initialized with a box containing all the vertices.
+// If res[i] is false, the exact test (triangle_triangle_intersect_3d) must
+// be used.
+CINO_INLINE
+void triangle_triangles_separated(const vec3d                t[3],
+                                  const std::vector<vec3d> & verts,
+                                  const FilteredPredicates & filter,
+                                  const bool                 ignore_if_valid_complex,
+                                        std::vector<bool>  & res);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "batch_intersection_tests.cpp"
+#endif
+
+#endif // CINO_BATCH_INTERSECTION_TESTS_H
@@ -36,11 +36,82 @@
 #include <cinolib/bfs.h>
 //
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
 #include <queue>
+#include <thread>
 
 namespace cinolib
 {
 
+namespace
+{
+    // Level synchronous BFS on a graph with n_nodes nodes. adj(node) returns the
+    // list of neighbors of node, and pass(node,nbr) tells whether the arc
+    // connecting them can be traversed. Each level splits the frontier in
+    // blocks, and each block collects the nodes it claims in its own list
+    template<typename Adj, typename Pass>
+    CINO_INLINE
+    void frontier_bfs(const uint               n_nodes,
+                      const uint               source,
+                      const Adj              & adj,
+                      const Pass             & pass,
+                            std::vector<int> & depth)
+    {
+        assert(source < n_nodes);
+
+        std::vector<std::atomic<int>> d(n_nodes);
+        PARALLEL_FOR(0, n_nodes, 10000, [&](uint i){ d[i].store(-1, std::memory_order_relaxed); });
+        d[source].store(0, std::memory_order_relaxed);
+
+        const uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+        const uint min_block = 256; // frontier nodes per block
+
+        std::vector<uint> frontier(1, source);
+        std::vector<std::vector<uint>> found;
+        int level = 0;
+        while(!frontier.empty())
+        {
+            uint n_blocks = std::min(4*n_threads, uint(frontier.size()+min_block-1)/min_block);
+            found.assign(n_blocks, std::vector<uint>());
+            PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+            {
+                size_t beg = frontier.size()*b/n_blocks;
+                size_t end = frontier.size()*(b+1)/n_blocks;
+                for(size_t i=beg; i<end; ++i)
+                {
+                    uint node = frontier[i];
+                    for(uint nbr : adj(node))
+                    {
+                        if(d[nbr].load(std::memory_order_relaxed)>=0 || !pass(node,nbr)) continue;
+                        int unvisited = -1;
+                        if(d[nbr].compare_exchange_strong(unvisited, level+1, std::memory_order_relaxed))
+                        {
+                            found[b].push_back(nbr);
+                        }
+                    }
+                }
+            });
+
+            // next frontier: concatenation of the nodes claimed by each block
+            std::vector<size_t> offset(n_blocks+1, 0);
+            for(uint b=0; b<n_blocks; ++b) offset[b+1] = offset[b] + found[b].size();
+            frontier.resize(offset.back());
+            PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+            {
+                std::copy(found[b].begin(), found[b].end(), frontier.begin() + offset[b]);
+            });
+            ++level;
+        }
+
+        depth.resize(n_nodes);
+        PARALLEL_FOR(0, n_nodes, 10000, [&](uint i){ depth[i] = d[i].load(std::memory_order_relaxed); });
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
@@ -306,4 +377,50 @@ void bfs_tree(const AbstractMesh<M,V,E,P> & m,
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_bfs(const AbstractMesh<M,V,E,P> & m,
+                  const uint                    source,
+                        std::vector<int>      & depth)
+{
+    frontier_bfs(m.num_verts(), source,
+                 [&](uint vid) -> const std::vector<uint> & { return m.adj_v2v(vid); },
+                 [ ](uint, uint) { return true; },
+                 depth);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_bfs(const AbstractMesh<M,V,E,P> & m,
+                  const uint                    source,
+                  const std::vector<bool>     & mask, // if mask[vid] = true, path cannot pass through vertex vid
+                        std::vector<int>      & depth)
+{
+    assert(mask.size()==m.num_verts());
+    frontier_bfs(m.num_verts(), source,
+                 [&](uint vid) -> const std::vector<uint> & { return m.adj_v2v(vid); },
+                 [&](uint, uint nbr) { return !mask[nbr]; },
+                 depth);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_bfs_on_dual(const AbstractMesh<M,V,E,P> & m,
+                          const uint                    source,
+                          const std::vector<bool>     & mask, // if mask[p] = true, bfs cannot visit polygon/polyhedron p
+                                std::vector<int>      & depth)
+{
+    assert(mask.size()==m.num_polys());
+    frontier_bfs(m.num_polys(), source,
+                 [&](uint pid) -> const std::vector<uint> & { return m.adj_p2p(pid); },
+                 [&](uint, uint nbr) { return !mask[nbr]; },
+                 depth);
+}
+
 }
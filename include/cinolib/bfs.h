@@ -39,6 +39,7 @@
 #include <cinolib/cino_inline.h>
 #include <cinolib/meshes/meshes.h>
 #include <unordered_set>
+#include <vector>
 
 namespace cinolib
 {
@@ -123,6 +124,42 @@ void bfs_tree(const AbstractMesh<M,V,E,P> & m,
               const uint                    root,
               const std::vector<bool>     & mask, // edge mask
                     std::vector<bool>     & tree);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Parallel floodfill, meant for very large meshes. The visit is level
+ * synchronous: the frontier of each level is split among threads, and
+ * every node is claimed by the first thread that reaches it (with an
+ * atomic compare and swap). Output is the BFS depth of each vertex (or
+ * polygon/polyhedron, for the dual variant), which is -1 for the nodes
+ * that are not reached. Depths do not depend on thread scheduling, and
+ * the set of nodes with depth >= 0 is the same visited by the serial bfs
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_bfs(const AbstractMesh<M,V,E,P> & m,
+                  const uint                    source,
+                        std::vector<int>      & depth);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_bfs(const AbstractMesh<M,V,E,P> & m,
+                  const uint                    source,
+                  const std::vector<bool>     & mask, // if mask[vid] = true, path cannot pass through vertex vid
+                        std::vector<int>      & depth);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_bfs_on_dual(const AbstractMesh<M,V,E,P> & m,
+                          const uint                    source,
+                          const std::vector<bool>     & mask, // if mask[p] = true, bfs cannot visit polygon/polyhedron p
+                                std::vector<int>      & depth);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,116 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/concurrent_union_find.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <thread>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void ConcurrentUnionFind::init(const uint n)
+{
+    std::vector<std::atomic<uint>>(n).swap(parent);
+    PARALLEL_FOR(0, n, 10000, [&](uint i){ parent[i].store(i, std::memory_order_relaxed); });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint ConcurrentUnionFind::find(uint x)
+{
+    while(true)
+    {
+        uint p = parent[x].load(std::memory_order_relaxed);
+        if(p==x) return x;
+        uint gp = parent[p].load(std::memory_order_relaxed);
+        if(p!=gp) parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool ConcurrentUnionFind::unite(uint a, uint b)
+{
+    while(true)
+    {
+        a = find(a);
+        b = find(b);
+        if(a==b) return false;
+        if(a<b) std::swap(a,b);
+        uint root = a; // a may have been linked meanwhile: retry
+        if(parent[a].compare_exchange_strong(root, b, std::memory_order_relaxed)) return true;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint ConcurrentUnionFind::canonical_labels(std::vector<uint> & labels)
+{
+    uint n = size();
+    labels.resize(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i){ labels[i] = find(i); });
+
+    // roots are numbered in increasing order, block by block
+    const uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+    const uint n_blocks  = std::max(1u, std::min(4*n_threads, n/10000));
+    std::vector<uint> n_roots(n_blocks+1, 0);
+    PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+    {
+        for(uint i=uint(size_t(n)*b/n_blocks); i<uint(size_t(n)*(b+1)/n_blocks); ++i)
+        {
+            if(labels[i]==i) ++n_roots[b+1];
+        }
+    });
+    for(uint b=0; b<n_blocks; ++b) n_roots[b+1] += n_roots[b];
+    std::vector<uint> root_id(n);
+    PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+    {
+        uint id = n_roots[b];
+        for(uint i=uint(size_t(n)*b/n_blocks); i<uint(size_t(n)*(b+1)/n_blocks); ++i)
+        {
+            if(labels[i]==i) root_id[i] = id++;
+        }
+    });
+    PARALLEL_FOR(0, n, 10000, [&](uint i){ labels[i] = root_id[labels[i]]; });
+    return n_roots.back();
+}
+
+}
@@ -0,0 +1,92 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_CONCURRENT_UNION_FIND_H
+#define CINO_CONCURRENT_UNION_FIND_H
+
+#include <cinolib/cino_inline.h>
+#include <sys/types.h>
+#include <atomic>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Lock-free union-find (Anderson and Woll, Wait-free Parallel Algorithms for
+ * the Union-Find Problem, STOC 1991). find() and unite() can be called
+ * concurrently from any number of threads.
+ *
+ * Sets are always linked by making the root with larger id point to the one
+ * with smaller id. Hence parent[i] <= i at all times, and the root of each set
+ * is its smallest element, regardless of the order in which unions happen.
+ * find() halves paths with compare and swap: a failed update only means that
+ * another thread shortened the same path.
+*/
+
+class ConcurrentUnionFind
+{
+    public:
+
+        explicit ConcurrentUnionFind(const uint n = 0) { init(n); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void init(const uint n); // n singletons
+        uint size() const { return uint(parent.size()); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint find (uint x);
+        bool unite(uint a, uint b); // false if a and b were already in the same set
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // labels each element with the rank of its root among all roots, i.e. sets
+        // are numbered by increasing smallest element. Returns the number of sets.
+        // Not meant to be called concurrently with unite()
+        uint canonical_labels(std::vector<uint> & labels);
+
+    protected:
+
+        std::vector<std::atomic<uint>> parent;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "concurrent_union_find.cpp"
+#endif
+
+#endif // CINO_CONCURRENT_UNION_FIND_H
@@ -35,6 +35,8 @@
 *********************************************************************************/
 #include <cinolib/connected_components.h>
 #include <cinolib/bfs.h>
+#include <cinolib/concurrent_union_find.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -74,4 +76,77 @@ uint connected_components(const AbstractMesh<M,V,E,P> & m,
     return uint(ccs.size());
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint parallel_connected_components(const AbstractMesh<M,V,E,P> & m,
+                                         std::vector<uint>     & vert_cc)
+{
+    ConcurrentUnionFind uf(m.num_verts());
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](uint eid)
+    {
+        uf.unite(m.edge_vert_id(eid,0), m.edge_vert_id(eid,1));
+    });
+    return uf.canonical_labels(vert_cc);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint parallel_connected_components_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                           const std::vector<bool>            & mask_edges,
+                                                                 std::vector<uint>            & poly_cc)
+{
+    assert(mask_edges.size()==m.num_edges());
+    ConcurrentUnionFind uf(m.num_polys());
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](uint eid)
+    {
+        if(mask_edges[eid]) return;
+        const std::vector<uint> & polys = m.adj_e2p(eid);
+        for(uint i=1; i<polys.size(); ++i) uf.unite(polys[0], polys[i]);
+    });
+    return uf.canonical_labels(poly_cc);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint parallel_connected_components_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                                           const std::vector<bool>                 & mask_faces,
+                                                                 std::vector<uint>                 & poly_cc)
+{
+    assert(mask_faces.size()==m.num_faces());
+    ConcurrentUnionFind uf(m.num_polys());
+    PARALLEL_FOR(0, m.num_faces(), 10000, [&](uint fid)
+    {
+        if(mask_faces[fid]) return;
+        const std::vector<uint> & polys = m.adj_f2p(fid);
+        if(polys.size()==2) uf.unite(polys[0], polys[1]);
+    });
+    return uf.canonical_labels(poly_cc);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint parallel_connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                           const std::vector<int>      & poly_labels,
+                                                 std::vector<uint>     & poly_cc)
+{
+    assert(poly_labels.size()==m.num_polys());
+    ConcurrentUnionFind uf(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 10000, [&](uint pid)
+    {
+        for(uint nbr : m.adj_p2p(pid))
+        {
+            if(nbr>pid && poly_labels[nbr]==poly_labels[pid]) uf.unite(pid, nbr);
+        }
+    });
+    return uf.canonical_labels(poly_cc);
+}
+
 }
@@ -40,6 +40,9 @@
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/meshes/abstract_mesh.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+#include <unordered_set>
 
 namespace cinolib
 {
@@ -55,6 +58,50 @@ CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m,
                           std::vector<std::unordered_set<uint>> & ccs);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Parallel connected components, meant for very large meshes. Elements are
+ * merged with a lock-free union-find (the root of each set is always its
+ * element with smallest id), hence the whole adjacency is processed in a
+ * single parallel sweep. Each element receives the id of its component.
+ * Components are numbered by increasing smallest element id, which is the
+ * same order in which the serial floodfill discovers them. The number of
+ * components is returned
+*/
+
+// vertices connected by edges
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint parallel_connected_components(const AbstractMesh<M,V,E,P> & m,
+                                         std::vector<uint>     & vert_cc);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// polygons connected by edges (as in bfs_on_dual_w_edge_barriers)
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint parallel_connected_components_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                           const std::vector<bool>            & mask_edges, // if mask[e] = true, polys cannot be connected through edge e
+                                                                 std::vector<uint>            & poly_cc);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// polyhedra connected by faces (as in bfs_on_dual_w_face_barriers)
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint parallel_connected_components_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                                           const std::vector<bool>                 & mask_faces, // if mask[f] = true, polys cannot be connected through face f
+                                                                 std::vector<uint>                 & poly_cc);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// connected regions of adjacent polygons/polyhedra with the same label
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint parallel_connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                           const std::vector<int>      & poly_labels,
+                                                 std::vector<uint>     & poly_cc);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -42,99 +42,289 @@ namespace cinolib
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-// LITTLE NOTE ON MY DIJKSTRA IMPLEMENTATIONS: why std::set and not
-// std::unordered_set or std::priority_queue?
+// LITTLE NOTE ON MY DIJKSTRA IMPLEMENTATIONS
 //
-// The reason why I am using std::set is that Dijkstra requires priority
-// update, which is supported by none of the STL containers. Options are:
-//
-//  1) remove an element and re-add it with updated priority. In this
-//     case std::set has the best remove performances
-//
-//  2) leave "dead" copies of an element in the container, and just add a
-//     new copy each time its priority needs an update. Regardless the waste
-//     of memory, which is an issue by itself, in this case at each iteration
-//     you need a mechanism that allows you to discard the current element
-//     if it is not the one with the most recent priority...
-//
-// I therefore decided to go for (1).
-// See also:
-// https://stackoverflow.com/questions/649640/how-to-do-an-efficient-priority-update-in-stl-priority-queue
+// Dijkstra requires priority update (decrease key), which is supported by
+// none of the STL containers. Earlier versions of these routines used a
+// std::set, removing and re-adding an element each time its priority was
+// updated. All variants are now based on an IndexedHeap (see indexed_heap.h),
+// which supports decrease key natively and extracts elements in the same
+// order as the std::set did (by distance, then by id). This means that
+// distances and paths are the same as before, but no memory is allocated
+// during the search. All the memory needed by a search (distances,
+// predecessors and the queue) lives in a DijkstraWorkspace, which can be
+// reused across searches on the same mesh.
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M, class V, class E, class P>
 CINO_INLINE
-void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
-                         const uint                    source,
-                               std::vector<double>   & dist)
+void DijkstraWorkspace::init(const uint n)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
+    if(dist.size()!=n)
+    {
+        dist.assign(n, inf_double);
+        prev.assign(n, -1);
+        reached.clear();
+        q.resize(n);
+        return;
+    }
+    for(uint id : reached)
+    {
+        dist[id] = inf_double;
+        prev[id] = -1;
+    }
+    reached.clear();
+    q.clear();
+}
 
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    while(!q.empty())
-    {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
+namespace
+{
 
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
+// best connection found so far by a bidirectional search: the arc (f,b)
+// joins the forward search (at f) to the backward search (at b)
+struct DijkstraMeeting
+{
+    double mu; // length of the shortest source-dest path found so far
+    int    f;
+    int    b;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-            if(dist.at(nbr) > new_dist)
+// edge relaxation. Neighbor visitors receive it and call it for each
+// traversable arc (nbr,weight) leaving the element being expanded. In a
+// bidirectional search it also checks whether the arc connects the two
+// searches, and updates the best connection found so far
+struct DijkstraRelax
+{
+          DijkstraWorkspace & ws;
+          uint                vid;
+          double              d;
+    const DijkstraWorkspace * opposite; // nullptr for unidirectional searches
+          DijkstraMeeting   * meet;
+          bool                forward;
+
+    void operator()(const uint nbr, const double w)
+    {
+        double new_dist = d + w;
+        if(opposite!=nullptr && opposite->dist[nbr]<inf_double)
+        {
+            double len = new_dist + opposite->dist[nbr];
+            if(len < meet->mu)
             {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
+                meet->mu = len;
+                meet->f  = forward ? int(vid) : int(nbr);
+                meet->b  = forward ? int(nbr) : int(vid);
             }
         }
+        if(ws.dist[nbr] > new_dist)
+        {
+            if(ws.dist[nbr]==inf_double) ws.reached.push_back(nbr);
+            ws.dist[nbr] = new_dist;
+            ws.prev[nbr] = int(vid);
+            ws.q.update(nbr, new_dist);
+        }
+    }
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// generic Dijkstra on a graph with n nodes. visit_nbrs(vid,relax) must call
+// relax(nbr,w) for each arc leaving vid. The search stops as soon as a node
+// for which is_goal(vid) is true is extracted from the queue (and its id is
+// returned), or when the queue is empty (and -1 is returned)
+template<class Nbrs, class Goal>
+CINO_INLINE
+int dijkstra_search(      DijkstraWorkspace & ws,
+                    const uint                n,
+                    const std::vector<uint> & sources,
+                          Nbrs                visit_nbrs,
+                          Goal                is_goal)
+{
+    ws.init(n);
+    for(uint s : sources)
+    {
+        if(ws.dist.at(s)==0.0) continue; // duplicated source
+        ws.reached.push_back(s);
+        ws.dist[s] = 0.0;
+        ws.q.push(s, 0.0);
+    }
+
+    DijkstraRelax relax = { ws, 0, 0.0, nullptr, nullptr, true };
+    while(!ws.q.empty())
+    {
+        uint vid = ws.q.pop();
+        if(is_goal(vid)) return int(vid);
+        relax.vid = vid;
+        relax.d   = ws.dist[vid];
+        visit_nbrs(vid, relax);
     }
+    return -1;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M, class V, class E, class P>
+// goal for exhaustive searches
+struct DijkstraNoGoal
+{
+    bool operator()(const uint) const { return false; }
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// bidirectional Dijkstra from source to dest, on a graph with n nodes.
+// fwd(vid,relax) must call relax(nbr,w) for each arc vid->nbr, whereas
+// bwd(vid,relax) must do the same for each arc nbr->vid. At each step
+// the search with the closest frontier is advanced, and the search stops
+// as soon as the sum of the two frontier distances exceeds the shortest
+// connection found so far. Returns the path length (or -1 if dest is not
+// reachable from source, in which case path is empty)
+template<class NbrsF, class NbrsB>
 CINO_INLINE
-void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
-                         const std::vector<uint>     & sources,
-                               std::vector<double>   & dist)
+double dijkstra_bidirectional_search(      DijkstraWorkspace & wsf,
+                                           DijkstraWorkspace & wsb,
+                                     const uint                n,
+                                     const uint                source,
+                                     const uint                dest,
+                                           NbrsF               fwd,
+                                           NbrsB               bwd,
+                                           std::vector<uint> & path)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    for(uint vid : sources) dist.at(vid) = 0.0;
+    path.clear();
+    wsf.init(n);
+    wsb.init(n);
+
+    if(source==dest)
+    {
+        path.push_back(source);
+        return 0.0;
+    }
 
-    std::set<std::pair<double,uint>> q;
-    for(uint vid : sources) q.insert(std::make_pair(0.0,vid));
+    wsf.reached.push_back(source);
+    wsf.dist[source] = 0.0;
+    wsf.q.push(source, 0.0);
+    wsb.reached.push_back(dest);
+    wsb.dist[dest] = 0.0;
+    wsb.q.push(dest, 0.0);
 
-    while(!q.empty())
+    DijkstraMeeting meet = { inf_double, -1, -1 };
+    DijkstraRelax   rf   = { wsf, 0, 0.0, &wsb, &meet, true  };
+    DijkstraRelax   rb   = { wsb, 0, 0.0, &wsf, &meet, false };
+
+    // if one of the queues gets empty, all the nodes it can reach have been
+    // settled, and the best connection cannot improve anymore
+    while(!wsf.q.empty() && !wsb.q.empty())
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
+        if(wsf.q.top_key() + wsb.q.top_key() >= meet.mu) break;
 
-        for(uint nbr : m.adj_v2v(vid))
+        if(wsf.q.top_key() <= wsb.q.top_key())
         {
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            uint vid = wsf.q.pop();
+            rf.vid = vid;
+            rf.d   = wsf.dist[vid];
+            fwd(vid, rf);
+        }
+        else
+        {
+            uint vid = wsb.q.pop();
+            rb.vid = vid;
+            rb.d   = wsb.dist[vid];
+            bwd(vid, rb);
         }
     }
+
+    if(meet.f<0) return -1.0;
+
+    for(int vid=meet.f; vid!=-1; vid=wsf.prev.at(vid)) path.push_back(vid);
+    std::reverse(path.begin(), path.end());
+    for(int vid=meet.b; vid!=-1; vid=wsb.prev.at(vid)) path.push_back(vid);
+    return meet.mu;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// length of a polyline made of mesh vertices
+template<class M, class V, class E, class P>
+CINO_INLINE
+double path_length(const AbstractMesh<M,V,E,P> & m, const std::vector<uint> & path)
+{
+    double len = 0.0;
+    for(uint i=1; i<path.size(); ++i) len += m.vert(path.at(i-1)).dist(m.vert(path.at(i)));
+    return len;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// walks the predecessors from dest back to the source
+CINO_INLINE
+double dijkstra_path(const DijkstraWorkspace & ws,
+                     const uint                dest,
+                           std::vector<uint> & path)
+{
+    path.clear();
+    int tmp = dest;
+    do { path.push_back(tmp); tmp = ws.prev.at(tmp); } while (tmp != -1);
+    std::reverse(path.begin(), path.end());
+    return ws.dist.at(dest);
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//:::::::::::::::: DIJKSTRAs ON PRIMAL GRAPH (VERTICES) ::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
+                         const uint                    source,
+                               DijkstraWorkspace     & ws)
+{
+    dijkstra_exhaustive(m, std::vector<uint>(1,source), ws);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
+                         const std::vector<uint>     & sources,
+                               DijkstraWorkspace     & ws)
+{
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
+    {
+        const vec3d & p = m.vert(vid);
+        for(uint nbr : m.adj_v2v(vid)) relax(nbr, p.dist(m.vert(nbr)));
+    };
+    dijkstra_search(ws, m.num_verts(), sources, nbrs, DijkstraNoGoal());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
+                         const uint                    source,
+                               std::vector<double>   & dist)
+{
+    DijkstraWorkspace ws;
+    dijkstra_exhaustive(m, source, ws);
+    std::swap(dist, ws.dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
+                         const std::vector<uint>     & sources,
+                               std::vector<double>   & dist)
+{
+    DijkstraWorkspace ws;
+    dijkstra_exhaustive(m, sources, ws);
+    std::swap(dist, ws.dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -145,38 +335,18 @@ void dijkstra_exhaustive_srf_only(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
                                   const std::vector<uint>                 & sources,
                                         std::vector<double>               & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    for(uint vid : sources) dist.at(vid) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    for(uint vid : sources) q.insert(std::make_pair(0.0,vid));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
         for(uint eid : m.adj_v2e(vid))
         {
-            if(m.edge_is_on_srf(eid))
-            {
-                uint   nbr      = m.vert_opposite_to(eid,vid);
-                double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-                if(dist.at(nbr) > new_dist)
-                {
-                    if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                    {
-                        auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                        assert(it!=q.end());
-                        q.erase(it);
-                    }
-                    dist.at(nbr) = new_dist;
-                    q.insert(std::make_pair(new_dist,nbr));
-                }
-            }
+            if(!m.edge_is_on_srf(eid)) continue;
+            uint nbr = m.vert_opposite_to(eid,vid);
+            relax(nbr, m.vert(vid).dist(m.vert(nbr)));
         }
-    }
+    };
+    DijkstraWorkspace ws;
+    dijkstra_search(ws, m.num_verts(), sources, nbrs, DijkstraNoGoal());
+    std::swap(dist, ws.dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -188,37 +358,17 @@ void dijkstra_exhaustive_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
                                        const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
                                              std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
         for(uint eid : m.adj_v2e(vid))
         {
             if(mask.at(eid)) continue;
-
-            uint   nbr      = m.vert_opposite_to(eid,vid);
-            double new_dist = dist.at(vid) + m.edge_length(eid);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            relax(m.vert_opposite_to(eid,vid), m.edge_length(eid));
         }
-    }
+    };
+    DijkstraWorkspace ws;
+    dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, DijkstraNoGoal());
+    std::swap(dist, ws.dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -231,37 +381,18 @@ void dijkstra_exhaustive_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
                                        const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
                                              std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    for(uint vid : sources) dist.at(vid) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    for(uint vid : sources) q.insert(std::make_pair(0.0,vid));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
         for(uint eid : m.adj_v2e(vid))
         {
             if(mask.at(eid)) continue;
-
-            uint   nbr      = m.vert_opposite_to(eid,vid);
-            double new_dist = dist.at(vid) + weights.at(nbr);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            uint nbr = m.vert_opposite_to(eid,vid);
+            relax(nbr, weights.at(nbr));
         }
-    }
+    };
+    DijkstraWorkspace ws;
+    dijkstra_search(ws, m.num_verts(), sources, nbrs, DijkstraNoGoal());
+    std::swap(dist, ws.dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -271,49 +402,21 @@ CINO_INLINE
 double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const uint                    source,
                 const uint                    dest,
-                      std::vector<uint>     & path)
+                      std::vector<uint>     & path,
+                      DijkstraWorkspace     & ws)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
+        const vec3d & p = m.vert(vid);
+        for(uint nbr : m.adj_v2v(vid)) relax(nbr, p.dist(m.vert(nbr)));
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
 
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        return dijkstra_path(ws, dest, path);
     }
+    path.clear();
     assert(false && "Dijkstra did not converge!");
     return 0.0;
 }
@@ -325,50 +428,34 @@ CINO_INLINE
 double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const uint                    source,
                 const uint                    dest,
-                const std::vector<double>   & weights,
                       std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
+    DijkstraWorkspace ws;
+    return dijkstra(m, source, dest, path, ws);
+}
 
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    while(!q.empty())
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra(const AbstractMesh<M,V,E,P> & m,
+                const uint                    source,
+                const uint                    dest,
+                const std::vector<double>   & weights,
+                      std::vector<uint>     & path)
+{
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            double new_dist = dist.at(vid) + weights.at(nbr);
+        for(uint nbr : m.adj_v2v(vid)) relax(nbr, weights.at(nbr));
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
 
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
+    DijkstraWorkspace ws;
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        return dijkstra_path(ws, dest, path);
     }
+    path.clear();
     assert(false && "Dijkstra did not converge!");
     return 0.0;
 }
@@ -384,48 +471,20 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const std::vector<bool>     & mask, // if mask[v] = true, path cannot pass through it
                       std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
         for(uint nbr : m.adj_v2v(vid))
         {
             if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + weights.at(nbr);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            relax(nbr, weights.at(nbr));
         }
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
+
+    DijkstraWorkspace ws;
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        return dijkstra_path(ws, dest, path);
     }
 
     // there exists no path with the given mask constraints
@@ -444,51 +503,21 @@ double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
                               const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
                                     std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
+        for(uint eid : m.adj_v2e(vid))
         {
-            int eid = m.edge_id(vid,nbr);
-            assert(eid>=0);
-
             if(mask.at(eid)) continue;
-
-            double new_dist = dist.at(vid) + weights.at(nbr);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            uint nbr = m.vert_opposite_to(eid,vid);
+            relax(nbr, weights.at(nbr));
         }
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
+
+    DijkstraWorkspace ws;
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        return dijkstra_path(ws, dest, path);
     }
 
     // there exists no path with the given mask constraints
@@ -509,49 +538,23 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const std::vector<bool>     & mask,
                       std::vector<uint>     & path)
 {
-    path.clear();
     assert(mask.size() == m.num_verts());
 
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
+        const vec3d & p = m.vert(vid);
         for(uint nbr : m.adj_v2v(vid))
         {
             if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            relax(nbr, p.dist(m.vert(nbr)));
         }
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
+
+    DijkstraWorkspace ws;
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        return dijkstra_path(ws, dest, path);
     }
 
     // there exists no path with the given mask constraints
@@ -570,54 +573,24 @@ double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
                               const uint                    source,
                               const uint                    dest,
                               const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
-                                    std::vector<uint>     & path)
+                                    std::vector<uint>     & path,
+                                    DijkstraWorkspace     & ws)
 {
-    path.clear();
     assert(mask.size() == m.num_edges());
 
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
+        for(uint eid : m.adj_v2e(vid))
         {
-            int eid = m.edge_id(vid,nbr);
-            assert(eid>=0);
-
             if(mask.at(eid)) continue;
-
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            relax(m.vert_opposite_to(eid,vid), m.edge_length(eid));
         }
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
+
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        return dijkstra_path(ws, dest, path);
     }
 
     // there exists no path with the given mask constraints
@@ -627,6 +600,20 @@ double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                    std::vector<uint>     & path)
+{
+    DijkstraWorkspace ws;
+    return dijkstra_mask_on_edges(m, source, dest, mask, path, ws);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // Shortest path (with barriers and multiple destinations). The path
 // cannot pass throuh vertices for which mask[v] = true. The algorithm
 // stops as soon as it reaches one of the destinations
@@ -639,92 +626,57 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const std::vector<bool>     & mask,
                       std::vector<uint>     & path)
 {
-    path.clear();
     assert(mask.size() == m.num_verts());
 
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(CONTAINS(dest,vid))
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(vid);
-        }
-
+        const vec3d & p = m.vert(vid);
         for(uint nbr : m.adj_v2v(vid))
         {
             if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            relax(nbr, p.dist(m.vert(nbr)));
         }
-    }
+    };
+    auto goal = [&](const uint vid) { return CONTAINS(dest,vid); };
+
+    DijkstraWorkspace ws;
+    int vid = dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal);
+    if(vid>=0) return dijkstra_path(ws, vid, path);
 
     // there exists no path with the given mask constraints
     path.clear();
     return 0.0;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::: DIJKSTRAs ON DUAL GRAPH (POLYGONS/POLYHEDRA) :::::::::::::
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class P>
 CINO_INLINE
 void dijkstra_exhaustive_on_dual(const AbstractMesh<M,V,E,P> & m,
-                                 const uint                    source,
-                                       std::vector<double>   & dist)
+                                 const std::vector<uint>     & sources,
+                                       DijkstraWorkspace     & ws)
 {
-    dist = std::vector<double>(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint pid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
+        vec3d c = m.poly_centroid(pid);
+        for(uint nbr : m.adj_p2p(pid)) relax(nbr, c.dist(m.poly_centroid(nbr)));
+    };
+    dijkstra_search(ws, m.num_polys(), sources, nbrs, DijkstraNoGoal());
+}
 
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                 const uint                    source,
+                                       std::vector<double>   & dist)
+{
+    DijkstraWorkspace ws;
+    dijkstra_exhaustive_on_dual(m, std::vector<uint>(1,source), ws);
+    std::swap(dist, ws.dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -735,38 +687,35 @@ void dijkstra_exhaustive_on_dual(const AbstractMesh<M,V,E,P> & m,
                                  const std::vector<uint>     & sources,
                                        std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_polys(), inf_double);
+    DijkstraWorkspace ws;
+    dijkstra_exhaustive_on_dual(m, sources, ws);
+    std::swap(dist, ws.dist);
+}
 
-    std::set<std::pair<double,uint>> q;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    for(uint s : sources)
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
+                        const uint                    source,
+                        const uint                    dest,
+                              std::vector<uint>     & path,
+                              DijkstraWorkspace     & ws)
+{
+    auto nbrs = [&](const uint pid, DijkstraRelax & relax)
     {
-        dist.at(s) = 0.0;
-        q.insert(std::make_pair(0.0,s));
-    }
+        vec3d c = m.poly_centroid(pid);
+        for(uint nbr : m.adj_p2p(pid)) relax(nbr, c.dist(m.poly_centroid(nbr)));
+    };
+    auto goal = [&](const uint pid) { return pid==dest; };
 
-    while(!q.empty())
+    if(dijkstra_search(ws, m.num_polys(), std::vector<uint>(1,source), nbrs, goal)>=0)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
+        return dijkstra_path(ws, dest, path);
     }
+    path.clear();
+    assert(false && "Dijkstra did not converge!");
+    return 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -778,48 +727,39 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const uint                    dest,
                               std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_polys(), -1);
-
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
+    DijkstraWorkspace ws;
+    return dijkstra_on_dual(m, source, dest, path, ws);
+}
 
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    while(!q.empty())
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
+                        const uint                    source,
+                        const uint                    dest,
+                        const std::vector<bool>     & mask,
+                              std::vector<uint>     & path)
+{
+    auto nbrs = [&](const uint pid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
+        vec3d c = m.poly_centroid(pid);
+        for(uint nbr : m.adj_p2p(pid))
         {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
+            if(mask.at(nbr)) continue;
+            relax(nbr, c.dist(m.poly_centroid(nbr)));
         }
+    };
+    auto goal = [&](const uint pid) { return pid==dest; };
 
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
+    DijkstraWorkspace ws;
+    if(dijkstra_search(ws, m.num_polys(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        return dijkstra_path(ws, dest, path);
     }
-    assert(false && "Dijkstra did not converge!");
+
+    // there exists no path with the given mask constraints
+    path.clear();
     return 0.0;
 }
 
@@ -829,53 +769,24 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const uint                    source,
-                        const uint                    dest,
+                        const std::set<uint>        & dest,
                         const std::vector<bool>     & mask,
                               std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_polys(), -1);
-
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    auto nbrs = [&](const uint pid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_p2p(vid))
+        vec3d c = m.poly_centroid(pid);
+        for(uint nbr : m.adj_p2p(pid))
         {
             if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            relax(nbr, c.dist(m.poly_centroid(nbr)));
         }
-    }
+    };
+    auto goal = [&](const uint pid) { return CONTAINS(dest,pid); };
+
+    DijkstraWorkspace ws;
+    int pid = dijkstra_search(ws, m.num_polys(), std::vector<uint>(1,source), nbrs, goal);
+    if(pid>=0) return dijkstra_path(ws, pid, path);
 
     // there exists no path with the given mask constraints
     path.clear();
@@ -889,51 +800,148 @@ CINO_INLINE
 double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const uint                    source,
                         const std::set<uint>        & dest,
-                        const std::vector<bool>     & mask,
                               std::vector<uint>     & path)
 {
+    auto nbrs = [&](const uint pid, DijkstraRelax & relax)
+    {
+        vec3d c = m.poly_centroid(pid);
+        for(uint nbr : m.adj_p2p(pid)) relax(nbr, c.dist(m.poly_centroid(nbr)));
+    };
+    auto goal = [&](const uint pid) { return CONTAINS(dest,pid); };
+
+    DijkstraWorkspace ws;
+    int pid = dijkstra_search(ws, m.num_polys(), std::vector<uint>(1,source), nbrs, goal);
+    if(pid>=0) return dijkstra_path(ws, pid, path);
     path.clear();
+    assert(false && "Dijkstra did not converge!");
+    return 0.0;
+}
 
-    std::vector<int> prev(m.num_polys(), -1);
-
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//:::::::::::::: GOAL DIRECTED POINT TO POINT SHORTEST PATHS :::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
+// A* is implemented as a Dijkstra on reduced arc costs w(u,v) + h(v) - h(u),
+// where h(v) = |v - dest|. Since h is consistent, reduced costs are non
+// negative (they are clamped at zero to absorb round off errors), and nodes
+// are settled in the same order A* would settle them. The returned distance
+// is measured along the path, hence it is not affected by the reduction
 
-    while(!q.empty())
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star(const AbstractMesh<M,V,E,P> & m,
+                       const uint                    source,
+                       const uint                    dest,
+                             std::vector<uint>     & path,
+                             DijkstraWorkspace     & ws)
+{
+    const vec3d & t = m.vert(dest);
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(CONTAINS(dest,vid))
+        const vec3d & p  = m.vert(vid);
+        double        hp = p.dist(t);
+        for(uint nbr : m.adj_v2v(vid))
         {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(vid);
+            const vec3d & q = m.vert(nbr);
+            relax(nbr, std::max(0.0, p.dist(q) + q.dist(t) - hp));
         }
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
+
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        dijkstra_path(ws, dest, path);
+        return path_length(m, path);
+    }
+
+    // dest cannot be reached from source
+    path.clear();
+    return 0.0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star(const AbstractMesh<M,V,E,P> & m,
+                       const uint                    source,
+                       const uint                    dest,
+                             std::vector<uint>     & path)
+{
+    DijkstraWorkspace ws;
+    return dijkstra_A_star(m, source, dest, path, ws);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star(const AbstractMesh<M,V,E,P> & m,
+                       const uint                    source,
+                       const uint                    dest,
+                       const std::vector<bool>     & mask, // if mask[v] = true, path cannot pass through it
+                             std::vector<uint>     & path)
+{
+    assert(mask.size() == m.num_verts());
 
-        for(uint nbr : m.adj_p2p(vid))
+    const vec3d & t = m.vert(dest);
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
+    {
+        const vec3d & p  = m.vert(vid);
+        double        hp = p.dist(t);
+        for(uint nbr : m.adj_v2v(vid))
         {
             if(mask.at(nbr)) continue;
+            const vec3d & q = m.vert(nbr);
+            relax(nbr, std::max(0.0, p.dist(q) + q.dist(t) - hp));
+        }
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
 
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
+    DijkstraWorkspace ws;
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        dijkstra_path(ws, dest, path);
+        return path_length(m, path);
+    }
 
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+    // there exists no path with the given mask constraints
+    path.clear();
+    return 0.0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                     const uint                    source,
+                                     const uint                    dest,
+                                     const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                           std::vector<uint>     & path,
+                                           DijkstraWorkspace     & ws)
+{
+    assert(mask.size() == m.num_edges());
+
+    const vec3d & t = m.vert(dest);
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
+    {
+        const vec3d & p  = m.vert(vid);
+        double        hp = p.dist(t);
+        for(uint eid : m.adj_v2e(vid))
+        {
+            if(mask.at(eid)) continue;
+            uint          nbr = m.vert_opposite_to(eid,vid);
+            const vec3d & q   = m.vert(nbr);
+            relax(nbr, std::max(0.0, p.dist(q) + q.dist(t) - hp));
         }
+    };
+    auto goal = [&](const uint vid) { return vid==dest; };
+
+    if(dijkstra_search(ws, m.num_verts(), std::vector<uint>(1,source), nbrs, goal)>=0)
+    {
+        dijkstra_path(ws, dest, path);
+        return path_length(m, path);
     }
 
     // there exists no path with the given mask constraints
@@ -945,54 +953,196 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
-                        const uint                    source,
-                        const std::set<uint>        & dest,
-                              std::vector<uint>     & path)
+double dijkstra_A_star_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                     const uint                    source,
+                                     const uint                    dest,
+                                     const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                           std::vector<uint>     & path)
 {
-    path.clear();
+    DijkstraWorkspace ws;
+    return dijkstra_A_star_mask_on_edges(m, source, dest, mask, path, ws);
+}
 
-    std::vector<int> prev(m.num_polys(), -1);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                                    std::vector<uint>     & path,
+                                    DijkstraWorkspace     & ws_fwd,
+                                    DijkstraWorkspace     & ws_bwd)
+{
+    // edge lengths are symmetric, the same visitor serves both directions
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
+    {
+        const vec3d & p = m.vert(vid);
+        for(uint nbr : m.adj_v2v(vid)) relax(nbr, p.dist(m.vert(nbr)));
+    };
+    double len = dijkstra_bidirectional_search(ws_fwd, ws_bwd, m.num_verts(), source, dest, nbrs, nbrs, path);
+    return std::max(len, 0.0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                                    std::vector<uint>     & path)
+{
+    DijkstraWorkspace ws_fwd, ws_bwd;
+    return dijkstra_bidirectional(m, source, dest, path, ws_fwd, ws_bwd);
+}
 
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    while(!q.empty())
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<double>   & weights, // per vert weights (used as metric instead of edge lengths)
+                                    std::vector<uint>     & path)
+{
+    // arc u->v costs weights[v], hence backward searches pay the weight of
+    // the vertex being expanded rather than the one of its neighbor
+    auto fwd = [&](const uint vid, DijkstraRelax & relax)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
+        for(uint nbr : m.adj_v2v(vid)) relax(nbr, weights.at(nbr));
+    };
+    auto bwd = [&](const uint vid, DijkstraRelax & relax)
+    {
+        for(uint nbr : m.adj_v2v(vid)) relax(nbr, weights.at(vid));
+    };
+    DijkstraWorkspace ws_fwd, ws_bwd;
+    double len = dijkstra_bidirectional_search(ws_fwd, ws_bwd, m.num_verts(), source, dest, fwd, bwd, path);
+    return std::max(len, 0.0);
+}
 
-        if(CONTAINS(dest,vid))
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<bool>     & mask, // if mask[v] = true, path cannot pass through it
+                                    std::vector<uint>     & path)
+{
+    assert(mask.size() == m.num_verts());
+
+    // as in the unidirectional search, the mask applies to all vertices but the source
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
+    {
+        const vec3d & p = m.vert(vid);
+        for(uint nbr : m.adj_v2v(vid))
         {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(vid);
+            if(mask.at(nbr) && nbr!=source) continue;
+            relax(nbr, p.dist(m.vert(nbr)));
         }
+    };
+    path.clear();
+    if(mask.at(dest) && dest!=source) return 0.0;
+
+    DijkstraWorkspace ws_fwd, ws_bwd;
+    double len = dijkstra_bidirectional_search(ws_fwd, ws_bwd, m.num_verts(), source, dest, nbrs, nbrs, path);
+    return std::max(len, 0.0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        for(uint nbr : m.adj_p2p(vid))
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<double>   & weights, // per vert weights (used as metric instead of edge lengths)
+                              const std::vector<bool>     & mask,    // if mask[v] = true, path cannot pass through it
+                                    std::vector<uint>     & path)
+{
+    auto fwd = [&](const uint vid, DijkstraRelax & relax)
+    {
+        for(uint nbr : m.adj_v2v(vid))
+        {
+            if(mask.at(nbr) && nbr!=source) continue;
+            relax(nbr, weights.at(nbr));
+        }
+    };
+    auto bwd = [&](const uint vid, DijkstraRelax & relax)
+    {
+        for(uint nbr : m.adj_v2v(vid))
         {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
+            if(mask.at(nbr) && nbr!=source) continue;
+            relax(nbr, weights.at(vid));
+        }
+    };
+    path.clear();
+    if(mask.at(dest) && dest!=source) return 0.0;
 
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+    DijkstraWorkspace ws_fwd, ws_bwd;
+    double len = dijkstra_bidirectional_search(ws_fwd, ws_bwd, m.num_verts(), source, dest, fwd, bwd, path);
+    return std::max(len, 0.0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                            const uint                    source,
+                                            const uint                    dest,
+                                            const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                                  std::vector<uint>     & path)
+{
+    assert(mask.size() == m.num_edges());
+
+    auto nbrs = [&](const uint vid, DijkstraRelax & relax)
+    {
+        for(uint eid : m.adj_v2e(vid))
+        {
+            if(mask.at(eid)) continue;
+            relax(m.vert_opposite_to(eid,vid), m.edge_length(eid));
         }
-    }
-    assert(false && "Dijkstra did not converge!");
-    return 0.0;
+    };
+    DijkstraWorkspace ws_fwd, ws_bwd;
+    double len = dijkstra_bidirectional_search(ws_fwd, ws_bwd, m.num_verts(), source, dest, nbrs, nbrs, path);
+    return std::max(len, 0.0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                            const uint                    source,
+                                            const uint                    dest,
+                                            const std::vector<double>   & weights, // per vert weights (used as metric instead of edge lengths)
+                                            const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
+                                                  std::vector<uint>     & path)
+{
+    auto fwd = [&](const uint vid, DijkstraRelax & relax)
+    {
+        for(uint eid : m.adj_v2e(vid))
+        {
+            if(mask.at(eid)) continue;
+            uint nbr = m.vert_opposite_to(eid,vid);
+            relax(nbr, weights.at(nbr));
+        }
+    };
+    auto bwd = [&](const uint vid, DijkstraRelax & relax)
+    {
+        for(uint eid : m.adj_v2e(vid))
+        {
+            if(mask.at(eid)) continue;
+            relax(m.vert_opposite_to(eid,vid), weights.at(vid));
+        }
+    };
+    DijkstraWorkspace ws_fwd, ws_bwd;
+    double len = dijkstra_bidirectional_search(ws_fwd, ws_bwd, m.num_verts(), source, dest, fwd, bwd, path);
+    return std::max(len, 0.0);
 }
 
 }
@@ -40,16 +40,57 @@
 #include <sys/types.h>
 #include <vector>
 #include <cinolib/cino_inline.h>
+#include <cinolib/indexed_heap.h>
 #include <cinolib/meshes/abstract_mesh.h>
 #include <cinolib/meshes/abstract_polyhedralmesh.h>
 
 namespace cinolib
 {
 
+/* Memory used by a Dijkstra search: per element distances and predecessors
+ * (i.e. the shortest path tree), plus the priority queue. Passing the same
+ * workspace to repeated queries on the same mesh avoids any allocation. Its
+ * content is reset lazily, touching only the elements reached by the previous
+ * search, hence early terminated (point to point) queries cost proportionally
+ * to the visited region, and not to the mesh size. After a search, dist and
+ * prev can be read to retrieve distances and paths to all reached elements.
+*/
+
+class DijkstraWorkspace
+{
+    public:
+
+        explicit DijkstraWorkspace(const uint n = 0) { init(n); }
+
+        // prepare for a search on a graph with n nodes
+        void init(const uint n);
+
+        std::vector<double> dist;    // inf_double for unreached elements
+        std::vector<int>    prev;    // -1 for sources and unreached elements
+        std::vector<uint>   reached; // elements with finite distance
+        IndexedHeap<4>      q;
+};
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 //:::::::::::::::: DIJKSTRAs ON PRIMAL GRAPH (VERTICES) ::::::::::::::::::
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
+                         const uint                    source,
+                               DijkstraWorkspace     & ws); // output in ws.dist (and ws.prev)
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
+                         const std::vector<uint>     & sources,
+                               DijkstraWorkspace     & ws); // output in ws.dist (and ws.prev)
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
@@ -107,8 +148,8 @@ CINO_INLINE
 double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const uint                    source,
                 const uint                    dest,
-                const std::vector<double>   & weights, // per vert weights (used as metric instead of edge lengths)
-                      std::vector<uint>     & path);
+                      std::vector<uint>     & path,
+                      DijkstraWorkspace     & ws);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -163,6 +204,17 @@ double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                    std::vector<uint>     & path,
+                                    DijkstraWorkspace     & ws);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
@@ -192,6 +244,14 @@ void dijkstra_exhaustive_on_dual(const AbstractMesh<M,V,E,P> & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void dijkstra_exhaustive_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                 const std::vector<uint>     & sources,
+                                       DijkstraWorkspace     & ws); // output in ws.dist (and ws.prev)
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
@@ -201,6 +261,16 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
+                        const uint                    source,
+                        const uint                    dest,
+                              std::vector<uint>     & path,
+                              DijkstraWorkspace     & ws);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
@@ -228,6 +298,148 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const std::set<uint>        & dest,
                               std::vector<uint>     & path);
 
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//:::::::::::::: GOAL DIRECTED POINT TO POINT SHORTEST PATHS :::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Faster alternatives to the point to point dijkstra(m,source,dest,...) above,
+ * which explore the mesh uniformly around the source until dest is found.
+ *
+ *  - dijkstra_A_star guides the search towards dest with the Euclidean lower
+ *    bound |v - dest|, which is admissible only for the edge length metric
+ *    (hence there are no variants with per vertex weights). On surfaces it
+ *    settles a narrow band of vertices around the path;
+ *
+ *  - dijkstra_bidirectional grows two searches, from source and from dest,
+ *    and stops when they meet. It supports any metric (including per vertex
+ *    weights) and roughly halves the settled vertices.
+ *
+ * Paths have the same length as the ones returned by dijkstra, but may differ
+ * from them in the presence of ties. If dest cannot be reached, path is empty
+ * and the returned length is zero.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star(const AbstractMesh<M,V,E,P> & m,
+                       const uint                    source,
+                       const uint                    dest,
+                             std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star(const AbstractMesh<M,V,E,P> & m,
+                       const uint                    source,
+                       const uint                    dest,
+                             std::vector<uint>     & path,
+                             DijkstraWorkspace     & ws);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star(const AbstractMesh<M,V,E,P> & m,
+                       const uint                    source,
+                       const uint                    dest,
+                       const std::vector<bool>     & mask, // if mask[v] = true, path cannot pass through it
+                             std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                     const uint                    source,
+                                     const uint                    dest,
+                                     const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                           std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_A_star_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                     const uint                    source,
+                                     const uint                    dest,
+                                     const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                           std::vector<uint>     & path,
+                                           DijkstraWorkspace     & ws);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                                    std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                                    std::vector<uint>     & path,
+                                    DijkstraWorkspace     & ws_fwd,
+                                    DijkstraWorkspace     & ws_bwd);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<double>   & weights, // per vert weights (used as metric instead of edge lengths)
+                                    std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<bool>     & mask, // if mask[v] = true, path cannot pass through it
+                                    std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional(const AbstractMesh<M,V,E,P> & m,
+                              const uint                    source,
+                              const uint                    dest,
+                              const std::vector<double>   & weights, // per vert weights (used as metric instead of edge lengths)
+                              const std::vector<bool>     & mask,    // if mask[v] = true, path cannot pass through it
+                                    std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                            const uint                    source,
+                                            const uint                    dest,
+                                            const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
+                                                  std::vector<uint>     & path);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double dijkstra_bidirectional_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                            const uint                    source,
+                                            const uint                    dest,
+                                            const std::vector<double>   & weights, // per vert weights (used as metric instead of edge lengths)
+                                            const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
+                                                  std::vector<uint>     & path);
+
 }
 
 #ifndef  CINO_STATIC_LIB
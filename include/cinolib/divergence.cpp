@@ -43,6 +43,7 @@
 *********************************************************************************/
 #include <cinolib/divergence.h>
 #include <cinolib/gradient.h>
+#include <cinolib/operator_assembler.h>
 #include <cinolib/vector_field.h>
 
 namespace cinolib
@@ -70,4 +71,28 @@ ScalarField divergence(const AbstractPolyhedralMesh<M,V,E,F,P> & m, ScalarField
     return div;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+Eigen::SparseMatrix<double> divergence_matrix(const AbstractPolygonMesh<M,V,E,P> & m)
+{
+    Eigen::SparseMatrix<double> D;
+    OperatorAssembler assembler;
+    assembler.divergence_matrix(m, D);
+    return D;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+Eigen::SparseMatrix<double> divergence_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m)
+{
+    Eigen::SparseMatrix<double> D;
+    OperatorAssembler assembler;
+    assembler.divergence_matrix(m, D);
+    return D;
+}
+
 }
@@ -78,6 +78,22 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 ScalarField divergence(const AbstractPolyhedralMesh<M,V,E,F,P> & m, ScalarField & f);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// divergence operator, i.e. the transpose of the (per element) gradient matrix,
+// assembled directly (#verts x 3 #polys) rather than by transposition.
+// See operator_assembler.h
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+Eigen::SparseMatrix<double> divergence_matrix(const AbstractPolygonMesh<M,V,E,P> & m);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+Eigen::SparseMatrix<double> divergence_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m);
+
 }
 
 #ifndef  CINO_STATIC_LIB
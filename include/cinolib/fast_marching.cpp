@@ -0,0 +1,289 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/fast_marching.h>
+#include <cinolib/indexed_heap.h>
+#include <cinolib/parallel_for.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+
+namespace cinolib
+{
+
+namespace
+{
+// Upwind update of the value at p, from the face of a simplex spanned by the
+// K points q (with values u). Writing the linear interpolant over the face as
+// d + g^T (x-p), with X = [q_i-p], Q = (X^T X)^-1 and g = X Q (u - d), the
+// eikonal constraint |g| = 1 reduces to a quadratic in d. The solution is
+// valid only if the characteristic -g enters p from inside the face (i.e.
+// Q (u - d) <= 0) and if d is not smaller than any of the values in u.
+// Returns inf_double if the update is not valid.
+template<int K>
+CINO_INLINE
+double simplex_update(const vec3d & p, const vec3d * q, const double * u)
+{
+    Eigen::Matrix<double,3,K> X;
+    Eigen::Matrix<double,K,1> uu;
+    for(int i=0; i<K; ++i)
+    {
+        vec3d e = q[i] - p;
+        X.col(i) << e.x(), e.y(), e.z();
+        uu[i] = u[i];
+    }
+
+    Eigen::Matrix<double,K,K> XtX = X.transpose() * X;
+    double det = XtX.determinant();
+    if(det <= 1e-12 * std::pow(XtX.trace(),K)) return inf_double; // degenerate face
+
+    Eigen::Matrix<double,K,K> Q   = XtX.inverse();
+    Eigen::Matrix<double,K,1> one = Eigen::Matrix<double,K,1>::Ones();
+    double a    = one.dot(Q*one);
+    double b    = one.dot(Q*uu);
+    double c    = uu.dot(Q*uu) - 1.0;
+    double disc = b*b - a*c;
+    if(disc < 0) return inf_double;
+
+    double d = (b + std::sqrt(disc)) / a;
+    if(d < uu.maxCoeff()) return inf_double;
+
+    Eigen::Matrix<double,K,1> lambda = Q * (uu - d*one);
+    for(int i=0; i<K; ++i) if(lambda[i] > 1e-12*d) return inf_double;
+    return d;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Best update of vid from the element pid, considering all the faces spanned
+// by vertices with finite distance (and, for FMM, frozen). If 'must' is
+// not -1, only faces that contain it are considered (in FMM faces that do
+// not contain the last frozen vertex were already tested in previous steps)
+template<class Mesh>
+CINO_INLINE
+double element_update(const Mesh                & m,
+                      const uint                  pid,
+                      const uint                  vid,
+                      const std::vector<double> & dist,
+                      const std::vector<bool>   * frozen,
+                      const int                   must)
+{
+    vec3d  q[3];
+    double u[3];
+    uint   k       = 0;
+    uint   must_bit = 0;
+    for(uint nbr : m.adj_p2v(pid))
+    {
+        if(nbr==vid || dist.at(nbr)==inf_double) continue;
+        if(frozen!=nullptr && !frozen->at(nbr))  continue;
+        assert(k<3 && "fast marching only works on simplicial meshes");
+        if(int(nbr)==must) must_bit = 1 << k;
+        q[k] = m.vert(nbr);
+        u[k] = dist.at(nbr);
+        ++k;
+    }
+    if(must>=0 && must_bit==0) return inf_double;
+
+    const vec3d & p = m.vert(vid);
+    double best = inf_double;
+    for(uint mask=1; mask < (1u<<k); ++mask)
+    {
+        if(must>=0 && !(mask & must_bit)) continue;
+        vec3d  qs[3];
+        double us[3];
+        int    n = 0;
+        for(uint i=0; i<k; ++i) if(mask & (1<<i)) { qs[n] = q[i]; us[n] = u[i]; ++n; }
+        double d = inf_double;
+        switch(n)
+        {
+            case 1 : d = simplex_update<1>(p, qs, us); break;
+            case 2 : d = simplex_update<2>(p, qs, us); break;
+            case 3 : d = simplex_update<3>(p, qs, us); break;
+        }
+        best = std::min(best, d);
+    }
+    return best;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+double vert_update(const Mesh & m, const uint vid, const std::vector<double> & dist)
+{
+    double best = inf_double;
+    for(uint pid : m.adj_v2p(vid))
+    {
+        best = std::min(best, element_update(m, pid, vid, dist, nullptr, -1));
+    }
+    return best;
+}
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+ScalarField fast_marching(const Mesh              & m,
+                          const std::vector<uint> & sources,
+                          const double              max_dist)
+{
+    assert(m.mesh_type()==TRIMESH || m.mesh_type()==TETMESH);
+
+    uint                nv = m.num_verts();
+    std::vector<double> dist(nv, inf_double);
+    std::vector<bool>   frozen(nv, false);
+    IndexedHeap<4>      q(nv);
+
+    for(uint vid : sources)
+    {
+        dist.at(vid) = 0.0;
+        q.update(vid, 0.0);
+    }
+
+    while(!q.empty() && q.top_key() <= max_dist)
+    {
+        uint vid = q.pop();
+        frozen.at(vid) = true;
+
+        for(uint pid : m.adj_v2p(vid))
+        for(uint nbr : m.adj_p2v(pid))
+        {
+            if(frozen.at(nbr)) continue;
+            double d = element_update(m, pid, nbr, dist, &frozen, int(vid));
+            if(d < dist.at(nbr))
+            {
+                dist.at(nbr) = d;
+                q.update(nbr, d);
+            }
+        }
+    }
+
+    // vertices that were not frozen are beyond max_dist
+    ScalarField f(nv);
+    for(uint vid=0; vid<nv; ++vid) f[vid] = frozen.at(vid) ? dist.at(vid) : inf_double;
+    return f;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+ScalarField fast_iterative_marching(const Mesh              & m,
+                                    const std::vector<uint> & sources,
+                                    const double              max_dist)
+{
+    assert(m.mesh_type()==TRIMESH || m.mesh_type()==TETMESH);
+
+    uint                nv  = m.num_verts();
+    double              tol = 1e-9 * m.edge_avg_length();
+    std::vector<double> dist(nv, inf_double);
+    std::vector<bool>   fixed(nv, false);  // sources
+    std::vector<char>   active(nv, false); // vector<bool> is not safe for concurrent writes
+    std::vector<uint>   list, next, converged, candidates;
+    std::vector<double> vals;
+
+    for(uint vid : sources)
+    {
+        dist.at(vid)  = 0.0;
+        fixed.at(vid) = true;
+    }
+    for(uint vid : sources)
+    for(uint nbr : m.adj_v2v(vid))
+    {
+        if(fixed.at(nbr) || active.at(nbr)) continue;
+        active.at(nbr) = true;
+        list.push_back(nbr);
+    }
+
+    while(!list.empty())
+    {
+        // update all active vertices at once, reading the distances of the
+        // previous sweep, then write them back
+        vals.resize(list.size());
+        PARALLEL_FOR(0, uint(list.size()), 1000, [&](const uint i)
+        {
+            vals[i] = std::min(dist[list[i]], vert_update(m, list[i], dist));
+        });
+
+        next.clear();
+        converged.clear();
+        for(uint i=0; i<list.size(); ++i)
+        {
+            uint vid = list[i];
+            bool conv = (dist[vid] - vals[i] <= tol);
+            dist[vid] = vals[i];
+            if(conv)
+            {
+                active[vid] = false;
+                if(dist[vid] <= max_dist) converged.push_back(vid);
+            }
+            else next.push_back(vid);
+        }
+
+        // converged vertices activate the neighbors they can improve
+        candidates.clear();
+        for(uint vid : converged)
+        for(uint nbr : m.adj_v2v(vid))
+        {
+            if(fixed[nbr] || active[nbr]) continue;
+            active[nbr] = true; // temporarily, to avoid duplicates
+            candidates.push_back(nbr);
+        }
+        vals.resize(candidates.size());
+        PARALLEL_FOR(0, uint(candidates.size()), 1000, [&](const uint i)
+        {
+            vals[i] = vert_update(m, candidates[i], dist);
+        });
+        for(uint i=0; i<candidates.size(); ++i)
+        {
+            uint vid = candidates[i];
+            if(vals[i] < dist[vid] - tol && vals[i] <= max_dist)
+            {
+                dist[vid] = vals[i];
+                next.push_back(vid);
+            }
+            else active[vid] = false;
+        }
+
+        std::swap(list, next);
+    }
+
+    ScalarField f(nv);
+    for(uint vid=0; vid<nv; ++vid) f[vid] = (dist.at(vid) <= max_dist) ? dist.at(vid) : inf_double;
+    return f;
+}
+
+}
@@ -0,0 +1,113 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_FAST_MARCHING_H
+#define CINO_FAST_MARCHING_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/scalar_field.h>
+#include <cinolib/min_max_inf.h>
+#include <cinolib/symbols.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/meshes/abstract_mesh.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Geodesic distances computed with the Fast Marching Method, as explained in
+ *
+ * Computing geodesic paths on manifolds
+ * R. KIMMEL and J.A. SETHIAN
+ * Proceedings of the National Academy of Sciences, 1998
+ *
+ * The method solves the eikonal equation |grad(u)| = 1 on a simplicial mesh
+ * (triangle or tetrahedral), with u = 0 at the sources. Vertices are frozen
+ * in order of increasing distance (using an indexed heap), and each frozen
+ * vertex updates its neighbors by means of upwind simplex updates: the value
+ * at a vertex is the one for which the linear interpolant over a triangle
+ * (or tetrahedron) incident to it has unit gradient, pointing from the
+ * inside of the element. Updates that are not upwind (e.g. across obtuse
+ * angles) fall back to the lower dimensional faces of the element, down to
+ * single edges. Differently from Dijkstra, distances are not biased along
+ * the mesh edges; differently from heat geodesics, no linear system needs
+ * to be solved and there is no smoothing parameter.
+ *
+ * The search stops as soon as the next vertex to be frozen is farther than
+ * max_dist from the sources. Vertices that were not reached within the bound
+ * (or that are not connected to any source) have distance inf_double.
+ * Distances are expressed in mesh units, and are zero at the sources. To get
+ * a field comparable to compute_geodesics (see geodesics.h) call
+ * normalize_in_01() on the result.
+*/
+
+template<class Mesh>
+CINO_INLINE
+ScalarField fast_marching(const Mesh              & m,
+                          const std::vector<uint> & sources,
+                          const double              max_dist = inf_double);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Parallel alternative to fast_marching, based on the Fast Iterative Method
+ *
+ * A Fast Iterative Method for Eikonal Equations
+ * W.K. JEONG and R.T. WHITAKER
+ * SIAM Journal on Scientific Computing, 2008
+ *
+ * Instead of freezing one vertex at a time, FIM keeps a list of active
+ * vertices, which are all updated concurrently (from all their incident
+ * elements) until their value stops changing. Converged vertices leave the
+ * list, and activate the neighbors whose value they are able to decrease.
+ * Each sweep reads the distances computed in the previous one, hence the
+ * output does not depend on the number of threads. FIM does more work than
+ * FMM but has no global ordering, and is faster when many cores are available,
+ * or when fronts can propagate in parallel (e.g. with many sources). Output
+ * is the same as fast_marching, up to the convergence tolerance (a fraction
+ * of the average edge length).
+*/
+
+template<class Mesh>
+CINO_INLINE
+ScalarField fast_iterative_marching(const Mesh              & m,
+                                    const std::vector<uint> & sources,
+                                    const double              max_dist = inf_double);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "fast_marching.cpp"
+#endif
+
+#endif // CINO_FAST_MARCHING_H
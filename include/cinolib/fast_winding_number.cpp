@@ -0,0 +1,270 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/fast_winding_number.h>
+#include <cinolib/solid_angle.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/pi.h>
+#include <algorithm>
+#include <numeric>
+
+namespace cinolib
+{
+
+CINO_INLINE
+FastWindingNumber::FastWindingNumber(const std::vector<vec3d> & verts,
+                                     const std::vector<uint>  & tris,
+                                     const double               beta)
+: beta(beta)
+{
+    build(verts, tris);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FastWindingNumber::set_accuracy(const double beta)
+{
+    this->beta = beta;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FastWindingNumber::build(const std::vector<vec3d> & verts,
+                              const std::vector<uint>  & tris)
+{
+    uint n_tris = uint(tris.size()/3);
+    if(n_tris==0) return;
+
+    std::vector<vec3d> centroids(n_tris);
+    for(uint i=0; i<n_tris; ++i)
+    {
+        centroids.at(i) = (verts.at(tris.at(3*i+0)) +
+                           verts.at(tris.at(3*i+1)) +
+                           verts.at(tris.at(3*i+2)))/3.0;
+    }
+
+    // make the hierarchy (a binary tree with median splits along the longest axis)
+    std::vector<uint> order(n_tris);
+    std::iota(order.begin(), order.end(), 0);
+    nodes.reserve(2*n_tris/items_per_leaf+1);
+    nodes.push_back(Node());
+    nodes.back().beg = 0;
+    nodes.back().end = n_tris;
+    build(0, centroids, order);
+
+    // serialize triangles such that triangles in the same node are contiguous
+    this->tris.resize(3*n_tris);
+    for(uint i=0; i<n_tris; ++i)
+    {
+        this->tris.at(3*i+0) = verts.at(tris.at(3*order.at(i)+0));
+        this->tris.at(3*i+1) = verts.at(tris.at(3*order.at(i)+1));
+        this->tris.at(3*i+2) = verts.at(tris.at(3*order.at(i)+2));
+    }
+
+    // compute the expansion terms for each node
+    PARALLEL_FOR(0, uint(nodes.size()), 1000, [&](uint nid)
+    {
+        compute_expansion(nodes.at(nid));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FastWindingNumber::build(const uint                 node_id,
+                              const std::vector<vec3d> & centroids,
+                                    std::vector<uint>  & order)
+{
+    uint beg = nodes.at(node_id).beg;
+    uint end = nodes.at(node_id).end;
+    if(end-beg<=items_per_leaf) return;
+
+    AABB box;
+    for(uint i=beg; i<end; ++i) box.push(centroids.at(order.at(i)));
+    vec3d delta = box.delta();
+    uint  axis  = 0;
+    if(delta[1]>delta[axis]) axis = 1;
+    if(delta[2]>delta[axis]) axis = 2;
+    if(delta[axis]==0) return; // all centroids coincide: cannot split
+
+    uint mid = beg + (end-beg)/2;
+    std::nth_element(order.begin()+beg, order.begin()+mid, order.begin()+end, [&](const uint a, const uint b)
+    {
+        return centroids.at(a)[axis] < centroids.at(b)[axis];
+    });
+
+    uint child0 = uint(nodes.size());
+    uint child1 = child0 + 1;
+    nodes.push_back(Node());
+    nodes.push_back(Node());
+    nodes.at(child0).beg = beg;
+    nodes.at(child0).end = mid;
+    nodes.at(child1).beg = mid;
+    nodes.at(child1).end = end;
+    nodes.at(node_id).children[0] = int(child0);
+    nodes.at(node_id).children[1] = int(child1);
+
+    build(child0, centroids, order);
+    build(child1, centroids, order);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FastWindingNumber::compute_expansion(Node & node) const
+{
+    double area = 0;
+    vec3d  center(0,0,0);
+    node.bbox.reset();
+    for(uint i=node.beg; i<node.end; ++i)
+    {
+        const vec3d * t = &tris.at(3*i);
+        double a = 0.5 * (t[1]-t[0]).cross(t[2]-t[0]).norm();
+        center += a * (t[0]+t[1]+t[2])/3.0;
+        area   += a;
+        node.bbox.push(t[0]);
+        node.bbox.push(t[1]);
+        node.bbox.push(t[2]);
+    }
+    node.center = (area>0) ? center/area : node.bbox.center();
+
+    node.radius       = 0;
+    node.first_order  = vec3d(0,0,0);
+    node.second_order = mat3d::ZERO();
+    for(uint i=node.beg; i<node.end; ++i)
+    {
+        const vec3d * t = &tris.at(3*i);
+        vec3d n = 0.5 * (t[1]-t[0]).cross(t[2]-t[0]); // area weighted normal
+        vec3d c = (t[0]+t[1]+t[2])/3.0 - node.center;
+        node.first_order += n;
+        for(uint r=0; r<3; ++r)
+        for(uint s=0; s<3; ++s)
+        {
+            node.second_order(r,s) += c[r]*n[s];
+        }
+        for(uint j=0; j<3; ++j)
+        {
+            node.radius = std::max(node.radius, t[j].dist(node.center));
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FastWindingNumber::winding_number(const vec3d & p) const
+{
+    if(nodes.empty()) return 0;
+
+    // the tree is balanced, hence its depth is logarithmic in the number of triangles
+    uint stack[128];
+    uint top = 0;
+    stack[top++] = 0;
+
+    double w = 0;
+    while(top>0)
+    {
+        const Node & node = nodes[stack[--top]];
+        vec3d  r = node.center - p;
+        double d = r.norm();
+
+        if(d > beta*node.radius)
+        {
+            // far field: first and second order Taylor expansion
+            double d3 = d*d*d;
+            double d5 = d3*d*d;
+            double rTr = 0;
+            for(uint i=0; i<3; ++i)
+            for(uint j=0; j<3; ++j)
+            {
+                rTr += r[i] * node.second_order(i,j) * r[j];
+            }
+            w += node.first_order.dot(r)/d3 + node.second_order.trace()/d3 - 3.0*rTr/d5;
+        }
+        else if(node.is_leaf())
+        {
+            // near field: exact summation of solid angles (note: solid_angle() already divides by 4PI)
+            for(uint i=node.beg; i<node.end; ++i)
+            {
+                w += 4*M_PI * solid_angle(tris[3*i], tris[3*i+1], tris[3*i+2], p);
+            }
+        }
+        else
+        {
+            assert(top+2<=128);
+            stack[top++] = uint(node.children[0]);
+            stack[top++] = uint(node.children[1]);
+        }
+    }
+    return w/(4*M_PI);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FastWindingNumber::winding_numbers(const std::vector<vec3d>  & points,
+                                              std::vector<double> & w) const
+{
+    w.resize(points.size());
+    PARALLEL_FOR(0, uint(points.size()), 1000, [&](uint i)
+    {
+        w.at(i) = winding_number(points.at(i));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool FastWindingNumber::is_inside(const vec3d & p) const
+{
+    return winding_number(p) > 0.5;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FastWindingNumber::is_inside(const std::vector<vec3d> & points,
+                                        std::vector<bool>  & inside) const
+{
+    // std::vector<bool> is bit packed, and cannot be written safely from multiple threads
+    std::vector<double> w;
+    winding_numbers(points, w);
+    inside.resize(points.size());
+    for(uint i=0; i<points.size(); ++i) inside.at(i) = (w.at(i) > 0.5);
+}
+
+}
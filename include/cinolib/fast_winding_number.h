@@ -0,0 +1,141 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_FAST_WINDING_NUMBER_H
+#define CINO_FAST_WINDING_NUMBER_H
+
+#include <cinolib/meshes/abstract_polygonmesh.h>
+
+namespace cinolib
+{
+
+/* Hierarchical evaluation of generalized winding numbers, as described in
+ *
+ *     Fast Winding Numbers for Soups and Clouds
+ *     Gavin Barill, Neil Dickson, Ryan Schmidt, David I.W. Levin, Alec Jacobson
+ *     ACM Transactions on Graphics (SIGGRAPH 2018)
+ *
+ * Triangles are organized in a bounding volume hierarchy. Each node stores
+ * the first and second order terms of the Taylor expansion of the winding
+ * number of its triangles around their area weighted barycenter. When the
+ * query point is farther than beta times the radius of a node, the expansion
+ * is used in place of the exact sum of the solid angles of its triangles.
+ *
+ * The parameter beta controls accuracy: higher values are more accurate
+ * but slower. The default value (2.0) is the one suggested in the paper.
+ *
+ * Differently from winding_number(), there is no need for the input mesh
+ * to be watertight: results are meaningful also for triangle soups, and
+ * meshes with holes or self intersections (a point is inside if w>0.5).
+ *
+ * NOTE: for non simplicial meshes (e.g. quads, exagons) the interior
+ * triangulation of each facet will be used for the computation.
+*/
+
+class FastWindingNumber
+{
+    public:
+
+        explicit FastWindingNumber(const std::vector<vec3d> & verts,
+                                   const std::vector<uint>  & tris,
+                                   const double               beta = 2.0);
+
+        template<class M, class V, class E, class P>
+        explicit FastWindingNumber(const AbstractPolygonMesh<M,V,E,P> & m,
+                                   const double                         beta = 2.0)
+        : beta(beta)
+        {
+            std::vector<uint> tris;
+            for(uint pid=0; pid<m.num_polys(); ++pid)
+            {
+                const std::vector<uint> & tess = m.poly_tessellation(pid);
+                tris.insert(tris.end(), tess.begin(), tess.end());
+            }
+            build(m.vector_verts(), tris);
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void set_accuracy(const double beta);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // generalized winding number of a single point
+        double winding_number(const vec3d & p) const;
+
+        // generalized winding numbers of a batch of points (computed in parallel)
+        void winding_numbers(const std::vector<vec3d>  & points,
+                                   std::vector<double> & w) const;
+
+        // inside/outside classification of a batch of points (computed in parallel)
+        bool is_inside(const vec3d & p) const;
+        void is_inside(const std::vector<vec3d> & points,
+                             std::vector<bool>  & inside) const;
+
+    protected:
+
+        struct Node
+        {
+            AABB   bbox;
+            vec3d  center;       // area weighted barycenter of the triangles in the node
+            double radius;       // max distance between center and any triangle vertex
+            vec3d  first_order;  // sum of area weighted normals
+            mat3d  second_order; // sum of area weighted (centroid - center) x normal
+            uint   beg, end;     // range of triangles (in vector tris) contained in the node
+            int    children[2] = { -1, -1 };
+            bool   is_leaf() const { return children[0]<0; }
+        };
+
+        void build(const std::vector<vec3d> & verts,
+                   const std::vector<uint>  & tris);
+
+        void build(const uint node_id, const std::vector<vec3d> & centroids, std::vector<uint> & order);
+        void compute_expansion(Node & node) const;
+
+        double beta;
+        uint   items_per_leaf = 8;
+
+        std::vector<Node>  nodes; // nodes[0] is the root
+        std::vector<vec3d> tris;  // serialized triangle vertices (t0v0, t0v1, t0v2, t1v0, ...)
+                                  // sorted such that triangles in each node are contiguous
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "fast_winding_number.cpp"
+#endif
+
+#endif // CINO_FAST_WINDING_NUMBER_H
@@ -137,11 +137,12 @@ bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
         }
         // compute a distance fied from the mapped point
         std::vector<double> w(m_target.num_verts(),inf_double);
+        const AbstractPolygonMesh<M2,V2,E2,P2> & cm_target = m_target; // read only access from the threads
         PARALLEL_FOR(0, m_target.num_verts(), 0,[&](const uint vid)
         {
             for(auto p : samples)
             {
-                w.at(vid) = std::min(w.at(vid), m_target.vert(vid).dist(p));
+                w.at(vid) = std::min(w.at(vid), cm_target.vert(vid).dist(p));
             }
         });
         std::vector<uint> path;
@@ -0,0 +1,516 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/filtered_predicates.h>
+#include <cmath>
+#include <algorithm>
+
+namespace cinolib
+{
+
+namespace
+{
+    // Shewchuk's stage A error bounds. Each one must be multiplied by
+    // the permanent of the corresponding determinant
+    const double o2d_errbound_A = 3.3306690738754716e-16; // ( 3 +  16 eps) eps
+    const double o3d_errbound_A = 7.7715611723761027e-16; // ( 7 +  56 eps) eps
+    const double inc_errbound_A = 1.1102230246251577e-15; // (10 +  96 eps) eps
+    const double ins_errbound_A = 1.7763568394002532e-15; // (16 + 224 eps) eps
+
+    // accounts for the rounding in the computation of the bounds themselves
+    const double safety_factor = 1.0 + 1e-12;
+
+    // floating point determinants, evaluated exactly as in the fast predicates
+
+    inline double orient2d_det(const double * pa, const double * pb, const double * pc)
+    {
+        double acx = pa[0] - pc[0];
+        double bcx = pb[0] - pc[0];
+        double acy = pa[1] - pc[1];
+        double bcy = pb[1] - pc[1];
+        return acx * bcy - acy * bcx;
+    }
+
+    inline double orient3d_det(const double * pa, const double * pb, const double * pc, const double * pd)
+    {
+        double adx = pa[0] - pd[0];
+        double bdx = pb[0] - pd[0];
+        double cdx = pc[0] - pd[0];
+        double ady = pa[1] - pd[1];
+        double bdy = pb[1] - pd[1];
+        double cdy = pc[1] - pd[1];
+        double adz = pa[2] - pd[2];
+        double bdz = pb[2] - pd[2];
+        double cdz = pc[2] - pd[2];
+        return adx * (bdy * cdz - bdz * cdy)
+             + bdx * (cdy * adz - cdz * ady)
+             + cdx * (ady * bdz - adz * bdy);
+    }
+
+    inline double incircle_det(const double * pa, const double * pb, const double * pc, const double * pd)
+    {
+        double adx = pa[0] - pd[0];
+        double ady = pa[1] - pd[1];
+        double bdx = pb[0] - pd[0];
+        double bdy = pb[1] - pd[1];
+        double cdx = pc[0] - pd[0];
+        double cdy = pc[1] - pd[1];
+        double abdet = adx * bdy - bdx * ady;
+        double bcdet = bdx * cdy - cdx * bdy;
+        double cadet = cdx * ady - adx * cdy;
+        double alift = adx * adx + ady * ady;
+        double blift = bdx * bdx + bdy * bdy;
+        double clift = cdx * cdx + cdy * cdy;
+        return alift * bcdet + blift * cadet + clift * abdet;
+    }
+
+    inline double insphere_det(const double * pa, const double * pb, const double * pc, const double * pd, const double * pe)
+    {
+        double aex = pa[0] - pe[0];
+        double bex = pb[0] - pe[0];
+        double cex = pc[0] - pe[0];
+        double dex = pd[0] - pe[0];
+        double aey = pa[1] - pe[1];
+        double bey = pb[1] - pe[1];
+        double cey = pc[1] - pe[1];
+        double dey = pd[1] - pe[1];
+        double aez = pa[2] - pe[2];
+        double bez = pb[2] - pe[2];
+        double cez = pc[2] - pe[2];
+        double dez = pd[2] - pe[2];
+        double ab  = aex * bey - bex * aey;
+        double bc  = bex * cey - cex * bey;
+        double cd  = cex * dey - dex * cey;
+        double da  = dex * aey - aex * dey;
+        double ac  = aex * cey - cex * aey;
+        double bd  = bex * dey - dex * bey;
+        double abc = aez * bc - bez * ac + cez * ab;
+        double bcd = bez * cd - cez * bd + dez * bc;
+        double cda = cez * da + dez * ac + aez * cd;
+        double dab = dez * ab + aez * bd + bez * da;
+        double alift = aex * aex + aey * aey + aez * aez;
+        double blift = bex * bex + bey * bey + bez * bez;
+        double clift = cex * cex + cey * cey + cez * cez;
+        double dlift = dex * dex + dey * dey + dez * dez;
+        return (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+    }
+
+    // extent along x and y of a 2D point set (plus some extra points)
+    inline void extent(const std::vector<vec2d>  & points,
+                       const std::vector<vec2d>  & extra,
+                             double              & dx,
+                             double              & dy)
+    {
+        double min_x =  inf_double, min_y =  inf_double;
+        double max_x = -inf_double, max_y = -inf_double;
+        for(const auto & list : {&points, &extra})
+        for(const vec2d & p : *list)
+        {
+            min_x = std::min(min_x, p[0]); max_x = std::max(max_x, p[0]);
+            min_y = std::min(min_y, p[1]); max_y = std::max(max_y, p[1]);
+        }
+        dx = (points.empty() && extra.empty()) ? 0 : max_x - min_x;
+        dy = (points.empty() && extra.empty()) ? 0 : max_y - min_y;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+FilteredPredicates::FilteredPredicates(const AABB & bbox)
+{
+    init(bbox.delta_x(), bbox.delta_y(), bbox.delta_z());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+FilteredPredicates::FilteredPredicates(const std::vector<vec3d> & points)
+{
+    if(points.empty()) init(0,0,0);
+    else
+    {
+        AABB bbox(points);
+        init(bbox.delta_x(), bbox.delta_y(), bbox.delta_z());
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+FilteredPredicates::FilteredPredicates(const std::vector<vec2d> & points)
+{
+    double dx, dy;
+    extent(points, {}, dx, dy);
+    init(dx, dy, 0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+FilteredPredicates::FilteredPredicates(const double delta_x, const double delta_y, const double delta_z)
+{
+    init(delta_x, delta_y, delta_z);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FilteredPredicates::init(const double delta_x, const double delta_y, const double delta_z)
+{
+    // Differences between coordinates of points in the box are bounded by its extent along each
+    // axis (also in floating point, as rounding is monotone). Hence the permanents of the determinants
+    // (i.e. the same expressions, with all terms taken in absolute value) can be bounded as follows
+    double dx = std::fabs(delta_x);
+    double dy = std::fabs(delta_y);
+    double dz = std::fabs(delta_z);
+    orient2d_bound = o2d_errbound_A *  2.0 * dx * dy                               * safety_factor;
+    orient3d_bound = o3d_errbound_A *  6.0 * dx * dy * dz                          * safety_factor;
+    incircle_bound = inc_errbound_A *  6.0 * dx * dy * (dx*dx + dy*dy)             * safety_factor;
+    insphere_bound = ins_errbound_A * 24.0 * dx * dy * dz * (dx*dx + dy*dy + dz*dz) * safety_factor;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::orient2d(const double * pa, const double * pb, const double * pc) const
+{
+    double det = orient2d_det(pa, pb, pc);
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    if(std::fabs(det) <= orient2d_bound) return cinolib::orient2d(pa, pb, pc);
+#endif
+    return det;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::orient3d(const double * pa, const double * pb, const double * pc, const double * pd) const
+{
+    double det = orient3d_det(pa, pb, pc, pd);
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    if(std::fabs(det) <= orient3d_bound) return cinolib::orient3d(pa, pb, pc, pd);
+#endif
+    return det;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::incircle(const double * pa, const double * pb, const double * pc, const double * pd) const
+{
+    double det = incircle_det(pa, pb, pc, pd);
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    if(std::fabs(det) <= incircle_bound) return cinolib::incircle(pa, pb, pc, pd);
+#endif
+    return det;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::insphere(const double * pa, const double * pb, const double * pc, const double * pd, const double * pe) const
+{
+    double det = insphere_det(pa, pb, pc, pd, pe);
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    if(std::fabs(det) <= insphere_bound) return cinolib::insphere(pa, pb, pc, pd, pe);
+#endif
+    return det;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::orient2d(const vec2d & pa, const vec2d & pb, const vec2d & pc) const
+{
+    return orient2d(pa.ptr(), pb.ptr(), pc.ptr());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::orient3d(const vec3d & pa, const vec3d & pb, const vec3d & pc, const vec3d & pd) const
+{
+    return orient3d(pa.ptr(), pb.ptr(), pc.ptr(), pd.ptr());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::incircle(const vec2d & pa, const vec2d & pb, const vec2d & pc, const vec2d & pd) const
+{
+    return incircle(pa.ptr(), pb.ptr(), pc.ptr(), pd.ptr());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double FilteredPredicates::insphere(const vec3d & pa, const vec3d & pb, const vec3d & pc, const vec3d & pd, const vec3d & pe) const
+{
+    return insphere(pa.ptr(), pb.ptr(), pc.ptr(), pd.ptr(), pe.ptr());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void orient2d(const vec2d               & pa,
+              const vec2d               & pb,
+              const std::vector<vec2d>  & pc,
+                    std::vector<double> & res)
+{
+    res.resize(pc.size());
+
+    // first pass: floating point determinants (branch free, vectorizable)
+    const double *a = pa.ptr();
+    const double *b = pb.ptr();
+    for(size_t i=0; i<pc.size(); ++i) res[i] = orient2d_det(a, b, pc[i].ptr());
+
+    // second pass: exact evaluation of the uncertain cases
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    double dx, dy;
+    extent(pc, {pa, pb}, dx, dy);
+    FilteredPredicates filter(dx, dy);
+    for(size_t i=0; i<pc.size(); ++i)
+    {
+        if(std::fabs(res[i]) <= filter.orient2d_bound) res[i] = orient2d(a, b, pc[i].ptr());
+    }
+#endif
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void orient3d(const vec3d               & pa,
+              const vec3d               & pb,
+              const vec3d               & pc,
+              const std::vector<vec3d>  & pd,
+                    std::vector<double> & res)
+{
+    res.resize(pd.size());
+
+    // first pass: floating point determinants (branch free, vectorizable)
+    const double *a = pa.ptr();
+    const double *b = pb.ptr();
+    const double *c = pc.ptr();
+    for(size_t i=0; i<pd.size(); ++i) res[i] = orient3d_det(a, b, c, pd[i].ptr());
+
+    // second pass: exact evaluation of the uncertain cases
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    AABB bbox(pd);
+    bbox.push(pa);
+    bbox.push(pb);
+    bbox.push(pc);
+    FilteredPredicates filter(bbox);
+    for(size_t i=0; i<pd.size(); ++i)
+    {
+        if(std::fabs(res[i]) <= filter.orient3d_bound) res[i] = orient3d(a, b, c, pd[i].ptr());
+    }
+#endif
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void incircle(const vec2d               & pa,
+              const vec2d               & pb,
+              const vec2d               & pc,
+              const std::vector<vec2d>  & pd,
+                    std::vector<double> & res)
+{
+    res.resize(pd.size());
+
+    // first pass: floating point determinants (branch free, vectorizable)
+    const double *a = pa.ptr();
+    const double *b = pb.ptr();
+    const double *c = pc.ptr();
+    for(size_t i=0; i<pd.size(); ++i) res[i] = incircle_det(a, b, c, pd[i].ptr());
+
+    // second pass: exact evaluation of the uncertain cases
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    double dx, dy;
+    extent(pd, {pa, pb, pc}, dx, dy);
+    FilteredPredicates filter(dx, dy);
+    for(size_t i=0; i<pd.size(); ++i)
+    {
+        if(std::fabs(res[i]) <= filter.incircle_bound) res[i] = incircle(a, b, c, pd[i].ptr());
+    }
+#endif
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void insphere(const vec3d               & pa,
+              const vec3d               & pb,
+              const vec3d               & pc,
+              const vec3d               & pd,
+              const std::vector<vec3d>  & pe,
+                    std::vector<double> & res)
+{
+    res.resize(pe.size());
+
+    // first pass: floating point determinants (branch free, vectorizable)
+    const double *a = pa.ptr();
+    const double *b = pb.ptr();
+    const double *c = pc.ptr();
+    const double *d = pd.ptr();
+    for(size_t i=0; i<pe.size(); ++i) res[i] = insphere_det(a, b, c, d, pe[i].ptr());
+
+    // second pass: exact evaluation of the uncertain cases
+#ifdef CINOLIB_USES_SHEWCHUK_PREDICATES
+    AABB bbox(pe);
+    bbox.push(pa);
+    bbox.push(pb);
+    bbox.push(pc);
+    bbox.push(pd);
+    FilteredPredicates filter(bbox);
+    for(size_t i=0; i<pe.size(); ++i)
+    {
+        if(std::fabs(res[i]) <= filter.insphere_bound) res[i] = insphere(a, b, c, d, pe[i].ptr());
+    }
+#endif
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+PointInSimplex point_in_tet(const FilteredPredicates & filter,
+                            const vec3d              & p,
+                            const vec3d              & t0,
+                            const vec3d              & t1,
+                            const vec3d              & t2,
+                            const vec3d              & t3)
+{
+    // according to refrence tet as in cinolib/standard_elements_tables.h
+    double f0p_vol = filter.orient3d(t0,t2,t1,p);
+    double f1p_vol = filter.orient3d(t0,t1,t3,p);
+    double f2p_vol = filter.orient3d(t0,t3,t2,p);
+    double f3p_vol = filter.orient3d(t1,t2,t3,p);
+
+    if((f0p_vol > 0 && f1p_vol > 0 && f2p_vol > 0 && f3p_vol > 0) ||
+       (f0p_vol < 0 && f1p_vol < 0 && f2p_vol < 0 && f3p_vol < 0))
+    {
+        return STRICTLY_INSIDE;
+    }
+
+    bool has_pos = (f0p_vol > 0 || f1p_vol > 0 || f2p_vol > 0 || f3p_vol > 0);
+    bool has_neg = (f0p_vol < 0 || f1p_vol < 0 || f2p_vol < 0 || f3p_vol < 0);
+    if(has_pos && has_neg) return STRICTLY_OUTSIDE;
+
+    // p is on the boundary (or t is degenerate)
+    return point_in_tet(p, t0, t1, t2, t3);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+SimplexIntersection segment_triangle_intersect_3d(const FilteredPredicates & filter,
+                                                  const vec3d              & s0,
+                                                  const vec3d              & s1,
+                                                  const vec3d              & t0,
+                                                  const vec3d              & t1,
+                                                  const vec3d              & t2)
+{
+    double vol_s0_t = filter.orient3d(s0, t0, t1, t2);
+    double vol_s1_t = filter.orient3d(s1, t0, t1, t2);
+
+    if(vol_s0_t > 0 && vol_s1_t > 0) return DO_NOT_INTERSECT; // s is above t
+    if(vol_s0_t < 0 && vol_s1_t < 0) return DO_NOT_INTERSECT; // s is below t
+
+    // s touches the plane of t (coplanar elements, shared vertices...)
+    if(vol_s0_t == 0 || vol_s1_t == 0) return segment_triangle_intersect_3d(s0, s1, t0, t1, t2);
+
+    // s crosses the plane of t, and has no vertex in common with it. s intersects
+    // t (borders included) if the signs of the three tetrahedra obtained combining
+    // s with the three edges of t are all equal
+    double vol_s_t01 = filter.orient3d(s0, s1, t0, t1);
+    double vol_s_t12 = filter.orient3d(s0, s1, t1, t2);
+    double vol_s_t20 = filter.orient3d(s0, s1, t2, t0);
+
+    if((vol_s_t01 > 0 && vol_s_t12 < 0) || (vol_s_t01 < 0 && vol_s_t12 > 0)) return DO_NOT_INTERSECT;
+    if((vol_s_t12 > 0 && vol_s_t20 < 0) || (vol_s_t12 < 0 && vol_s_t20 > 0)) return DO_NOT_INTERSECT;
+    if((vol_s_t20 > 0 && vol_s_t01 < 0) || (vol_s_t20 < 0 && vol_s_t01 > 0)) return DO_NOT_INTERSECT;
+
+    return INTERSECT;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+SimplexIntersection triangle_triangle_intersect_3d(const FilteredPredicates & filter,
+                                                   const vec3d              & t00,
+                                                   const vec3d              & t01,
+                                                   const vec3d              & t02,
+                                                   const vec3d              & t10,
+                                                   const vec3d              & t11,
+                                                   const vec3d              & t12)
+{
+    // early rejection: one triangle is strictly above (or below) the plane of the other.
+    // Shared vertices yield null volumes, hence they never pass this test
+    double t10_t0 = filter.orient3d(t10, t00, t01, t02);
+    double t11_t0 = filter.orient3d(t11, t00, t01, t02);
+    double t12_t0 = filter.orient3d(t12, t00, t01, t02);
+    if((t10_t0 > 0 && t11_t0 > 0 && t12_t0 > 0) || (t10_t0 < 0 && t11_t0 < 0 && t12_t0 < 0)) return DO_NOT_INTERSECT;
+
+    double t00_t1 = filter.orient3d(t00, t10, t11, t12);
+    double t01_t1 = filter.orient3d(t01, t10, t11, t12);
+    double t02_t1 = filter.orient3d(t02, t10, t11, t12);
+    if((t00_t1 > 0 && t01_t1 > 0 && t02_t1 > 0) || (t00_t1 < 0 && t01_t1 < 0 && t02_t1 < 0)) return DO_NOT_INTERSECT;
+
+    // triangles sharing sub-simplices are handled by the unfiltered predicate
+    if(t00==t10 || t00==t11 || t00==t12 ||
+       t01==t10 || t01==t11 || t01==t12 ||
+       t02==t10 || t02==t11 || t02==t12)
+    {
+        return triangle_triangle_intersect_3d(t00, t01, t02, t10, t11, t12);
+    }
+
+    // t0 and t1 do not share sub-simplices. They can be fully disjoint, intersecting at a single point, or overlapping
+    if(segment_triangle_intersect_3d(filter, t00, t01, t10, t11, t12) >= INTERSECT ||
+       segment_triangle_intersect_3d(filter, t01, t02, t10, t11, t12) >= INTERSECT ||
+       segment_triangle_intersect_3d(filter, t02, t00, t10, t11, t12) >= INTERSECT ||
+       segment_triangle_intersect_3d(filter, t10, t11, t00, t01, t02) >= INTERSECT ||
+       segment_triangle_intersect_3d(filter, t11, t12, t00, t01, t02) >= INTERSECT ||
+       segment_triangle_intersect_3d(filter, t12, t10, t00, t01, t02) >= INTERSECT)
+    {
+        return INTERSECT;
+    }
+
+    return DO_NOT_INTERSECT;
+}
+
+}
@@ -0,0 +1,195 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_FILTERED_PREDICATES_H
+#define CINO_FILTERED_PREDICATES_H
+
+#include <cinolib/predicates.h>
+#include <cinolib/geometry/aabb.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Statically filtered orient, incircle and insphere predicates.
+ *
+ * The basic predicates are evaluated in floating point, exactly as in
+ * the inexact (fast) version, and the sign of the result is certified
+ * against an error bound. Contrary to Shewchuk's predicates, which
+ * compute a bound at each call, here bounds are computed only once per
+ * batch of inputs, from the extent along x, y and z of all the points
+ * that will be tested (i.e. from a bounding box containing them all).
+ * Only when the filter fails the (adaptive) exact predicates are called.
+ * Bounds follow the stage A analysis of Shewchuk's predicates, with the
+ * permanents of the determinants bounded by the extent of the box.
+ *
+ * The filtered predicates are exact if CINOLIB_USES_SHEWCHUK_PREDICATES
+ * is defined, and fall back to the fast inexact predicates otherwise.
+ *
+ * WARNING: the filter is valid only for points contained in the box
+ * used to initialize it. Using it on other points leads to undefined
+ * results.
+ */
+
+class FilteredPredicates
+{
+    public:
+
+        explicit FilteredPredicates(const AABB & bbox);
+
+        explicit FilteredPredicates(const std::vector<vec3d> & points);
+
+        explicit FilteredPredicates(const std::vector<vec2d> & points);
+
+        explicit FilteredPredicates(const double delta_x, const double delta_y, const double delta_z = 0);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        double orient2d(const double * pa, const double * pb, const double * pc) const;
+        double orient3d(const double * pa, const double * pb, const double * pc, const double * pd) const;
+        double incircle(const double * pa, const double * pb, const double * pc, const double * pd) const;
+        double insphere(const double * pa, const double * pb, const double * pc, const double * pd, const double * pe) const;
+
+        double orient2d(const vec2d & pa, const vec2d & pb, const vec2d & pc) const;
+        double orient3d(const vec3d & pa, const vec3d & pb, const vec3d & pc, const vec3d & pd) const;
+        double incircle(const vec2d & pa, const vec2d & pb, const vec2d & pc, const vec2d & pd) const;
+        double insphere(const vec3d & pa, const vec3d & pb, const vec3d & pc, const vec3d & pd, const vec3d & pe) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // error bounds for each predicate. If the absolute value of the
+        // floating point determinant is above them, its sign is correct
+        double orient2d_bound;
+        double orient3d_bound;
+        double incircle_bound;
+        double insphere_bound;
+
+    protected:
+
+        void init(const double delta_x, const double delta_y, const double delta_z);
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Batch versions of the basic predicates, which test a fixed simplex against
+ * many query points (e.g. to classify a point cloud w.r.t. a line, a plane,
+ * a circle or a sphere). The filter is initialized only once from all the
+ * input points, and determinants are evaluated in a branch free loop that
+ * the compiler can vectorize. The exact predicates are called only for the
+ * (few) points that do not pass the filter. Results are exact if the symbol
+ * CINOLIB_USES_SHEWCHUK_PREDICATES is defined, and have the same sign of the
+ * single point predicates in any case.
+ */
+
+CINO_INLINE
+void orient2d(const vec2d               & pa,
+              const vec2d               & pb,
+              const std::vector<vec2d>  & pc,
+                    std::vector<double> & res);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void orient3d(const vec3d               & pa,
+              const vec3d               & pb,
+              const vec3d               & pc,
+              const std::vector<vec3d>  & pd,
+                    std::vector<double> & res);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void incircle(const vec2d               & pa,
+              const vec2d               & pb,
+              const vec2d               & pc,
+              const std::vector<vec2d>  & pd,
+                    std::vector<double> & res);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void insphere(const vec3d               & pa,
+              const vec3d               & pb,
+              const vec3d               & pc,
+              const vec3d               & pd,
+              const std::vector<vec3d>  & pe,
+                    std::vector<double> & res);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Filtered versions of the point/tet, segment/triangle and triangle/triangle
+ * tests in predicates.h. Return values are the same of their unfiltered
+ * counterparts. The orientation tests are evaluated with the filter, and
+ * only degenerate configurations (coplanar elements, shared vertices) are
+ * delegated to the unfiltered predicates. The filter must be valid for all
+ * the input points (see the warning above).
+ */
+
+CINO_INLINE
+PointInSimplex point_in_tet(const FilteredPredicates & filter,
+                            const vec3d              & p,
+                            const vec3d              & t0,
+                            const vec3d              & t1,
+                            const vec3d              & t2,
+                            const vec3d              & t3);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+SimplexIntersection segment_triangle_intersect_3d(const FilteredPredicates & filter,
+                                                  const vec3d              & s0,
+                                                  const vec3d              & s1,
+                                                  const vec3d              & t0,
+                                                  const vec3d              & t1,
+                                                  const vec3d              & t2);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+SimplexIntersection triangle_triangle_intersect_3d(const FilteredPredicates & filter,
+                                                   const vec3d              & t00,
+                                                   const vec3d              & t01,
+                                                   const vec3d              & t02,
+                                                   const vec3d              & t10,
+                                                   const vec3d              & t11,
+                                                   const vec3d              & t12);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "filtered_predicates.cpp"
+#endif
+
+#endif // CINO_FILTERED_PREDICATES_H
@@ -35,12 +35,146 @@
 *********************************************************************************/
 #include <cinolib/find_intersections.h>
 #include <cinolib/parallel_for.h>
+#include <cinolib/predicates.h>
+#include <cinolib/filtered_predicates.h>
+#include <cinolib/batch_intersection_tests.h>
 #include <cinolib/octree.h>
-#include <mutex>
+#include <algorithm>
+#include <stack>
 
 namespace cinolib
 {
 
+namespace
+{
+    // Octree parameters. Since redundant tests are avoided, small leaves can
+    // be used, which keeps the all-pairs tests within each leaf cheap
+    const uint FIND_INTERSECTIONS_MAX_DEPTH      = 12;
+    const uint FIND_INTERSECTIONS_ITEMS_PER_LEAF = 64;
+
+    // A leaf is responsible for testing a pair of items only if it contains
+    // point p, which is the minimum corner of the intersection of their AABBs.
+    // Leaves of a freshly built octree tile the space, hence the use of half
+    // open intervals ensures that p belongs to exactly one leaf. Intervals are
+    // closed on the max side of the root box, otherwise points lying on it would
+    // be owned by no leaf. This happens for flat inputs (e.g. planar meshes), for
+    // which the root box has zero extent along some axis. In such case leaves
+    // are also flat and may overlap, and duplicated pairs are removed at the end
+    CINO_INLINE
+    bool leaf_owns(const OctreeNode * leaf, const AABB & root_box, const vec3d & p)
+    {
+        for(uint i=0; i<3; ++i)
+        {
+            if(p[i]<leaf->bbox.min[i] || p[i]>leaf->bbox.max[i]) return false;
+            if(p[i]==leaf->bbox.max[i] && leaf->bbox.max[i]<root_box.max[i]) return false;
+        }
+        return true;
+    }
+
+    CINO_INLINE
+    vec3d min_corner_of_intersection(const AABB & b0, const AABB & b1)
+    {
+        return b0.min.max(b1.min);
+    }
+
+    CINO_INLINE
+    bool triangles_intersect(const FilteredPredicates & filter,
+                             const std::vector<vec3d> & verts0,
+                             const std::vector<uint>  & tris0,
+                             const uint                 tid0,
+                             const std::vector<vec3d> & verts1,
+                             const std::vector<uint>  & tris1,
+                             const uint                 tid1,
+                             const bool                 ignore_if_valid_complex)
+    {
+        auto res = triangle_triangle_intersect_3d(filter,
+                                                  verts0.at(tris0.at(3*tid0+0)),
+                                                  verts0.at(tris0.at(3*tid0+1)),
+                                                  verts0.at(tris0.at(3*tid0+2)),
+                                                  verts1.at(tris1.at(3*tid1+0)),
+                                                  verts1.at(tris1.at(3*tid1+1)),
+                                                  verts1.at(tris1.at(3*tid1+2)));
+        if(ignore_if_valid_complex) return (res > SIMPLICIAL_COMPLEX);
+        return (res>=SIMPLICIAL_COMPLEX);
+    }
+
+    CINO_INLINE
+    void append_triangle(const std::vector<vec3d> & verts,
+                         const std::vector<uint>  & tris,
+                         const uint                 tid,
+                               std::vector<vec3d> & list)
+    {
+        list.push_back(verts.at(tris.at(3*tid+0)));
+        list.push_back(verts.at(tris.at(3*tid+1)));
+        list.push_back(verts.at(tris.at(3*tid+2)));
+    }
+
+    // true if two triangles of the same mesh share an edge and are not
+    // coplanar. In such case their intersection is the shared edge itself
+    CINO_INLINE
+    bool valid_edge_adjacency(const std::vector<vec3d> & verts,
+                              const std::vector<uint>  & tris,
+                              const uint                 tid0,
+                              const uint                 tid1)
+    {
+        const uint *t0 = &tris.at(3*tid0);
+        const uint *t1 = &tris.at(3*tid1);
+        uint shared[3], n_shared = 0, opp0 = 0, opp1 = 0;
+        for(uint i=0; i<3; ++i)
+        {
+            bool found = false;
+            for(uint j=0; j<3; ++j) if(t0[i]==t1[j]) found = true;
+            if(found) shared[n_shared++] = t0[i]; else opp0 = t0[i];
+        }
+        if(n_shared!=2) return false;
+        for(uint j=0; j<3; ++j) if(t1[j]!=shared[0] && t1[j]!=shared[1]) opp1 = t1[j];
+        return orient3d(verts.at(shared[0]), verts.at(shared[1]), verts.at(opp0), verts.at(opp1))!=0;
+    }
+
+    // dual traversal of two octrees, collecting all pairs of leaves with overlapping bboxes.
+    // If the two trees coincide, only pairs made of the same leaf are collected (leaves
+    // tile the space, hence no pair of distinct leaves can own the same point)
+    CINO_INLINE
+    void overlapping_leaves(const Octree                                        & o0,
+                            const Octree                                        & o1,
+                                  std::vector<std::pair<const OctreeNode*,
+                                                        const OctreeNode*>>     & leaf_pairs)
+    {
+        if(o0.root==nullptr || o1.root==nullptr) return;
+
+        std::stack<std::pair<const OctreeNode*,const OctreeNode*>> lifo;
+        lifo.push(std::make_pair(o0.root, o1.root));
+        while(!lifo.empty())
+        {
+            const OctreeNode *n0 = lifo.top().first;
+            const OctreeNode *n1 = lifo.top().second;
+            lifo.pop();
+
+            if(!n0->bbox.intersects_box(n1->bbox)) continue;
+
+            if(n0==n1)
+            {
+                if(n0->is_inner())
+                {
+                    for(int i=0; i<8; ++i) lifo.push(std::make_pair(n0->children[i], n0->children[i]));
+                }
+                else leaf_pairs.push_back(std::make_pair(n0,n1));
+            }
+            else if(n0->is_inner() && (!n1->is_inner() || n0->bbox.diag()>=n1->bbox.diag()))
+            {
+                for(int i=0; i<8; ++i) lifo.push(std::make_pair(n0->children[i], n1));
+            }
+            else if(n1->is_inner())
+            {
+                for(int i=0; i<8; ++i) lifo.push(std::make_pair(n0, n1->children[i]));
+            }
+            else leaf_pairs.push_back(std::make_pair(n0,n1));
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void find_intersections(const Trimesh<M,V,E,P> & m,
@@ -57,33 +191,153 @@ void find_intersections(const std::vector<vec3d> & verts,
                         const std::vector<uint>  & tris,
                               std::set<ipair>    & intersections)
 {
-    Octree o(8,1000); // max 1000 elements per leaf, depth permitting
+    std::vector<ipair> list;
+    find_intersections(verts, tris, list);
+    intersections.insert(list.begin(), list.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void find_intersections(const std::vector<vec3d> & verts,
+                        const std::vector<uint>  & tris,
+                              std::vector<ipair> & intersections)
+{
+    intersections.clear();
+
+    Octree o(FIND_INTERSECTIONS_MAX_DEPTH, FIND_INTERSECTIONS_ITEMS_PER_LEAF);
     o.build_from_vectors(verts, tris);
 
-    std::mutex mutex;
+    FilteredPredicates filter(verts);
+
+    // note: build_from_vectors makes one item per triangle, with item index == triangle id
+    std::vector<std::vector<ipair>> buffers(o.leaves.size());
     PARALLEL_FOR(0, uint(o.leaves.size()), 1, [&](uint i)
-    {        
-        auto & leaf = o.leaves.at(i);
-        if(leaf->item_indices.empty()) return;
-        for(uint j=0;   j<leaf->item_indices.size()-1; ++j)
-        for(uint k=j+1; k<leaf->item_indices.size();   ++k)
+    {
+        const OctreeNode *leaf = o.leaves.at(i);
+        std::vector<uint>  candidates;
+        std::vector<vec3d> candidate_verts;
+        std::vector<bool>  separated;
+        for(uint j=0; j<leaf->item_indices.size(); ++j)
         {
             uint tid0 = leaf->item_indices.at(j);
-            uint tid1 = leaf->item_indices.at(k);
-            auto T0 = o.items.at(tid0);
-            auto T1 = o.items.at(tid1);
-            if(T0->aabb.intersects_box(T1->aabb)) // early reject based on AABB intersection
+            const AABB & b0 = o.items.at(tid0)->aabb;
+            candidates.clear();
+            candidate_verts.clear();
+            for(uint k=j+1; k<leaf->item_indices.size(); ++k)
+            {
+                uint tid1 = leaf->item_indices.at(k);
+                const AABB & b1 = o.items.at(tid1)->aabb;
+                if(!b0.intersects_box(b1)) continue; // early reject based on AABB intersection
+                if(!leaf_owns(leaf, o.root->bbox, min_corner_of_intersection(b0,b1))) continue; // tested elsewhere
+                if(valid_edge_adjacency(verts, tris, tid0, tid1)) continue;
+                candidates.push_back(tid1);
+                append_triangle(verts, tris, tid1, candidate_verts);
+            }
+            if(candidates.empty()) continue;
+
+            // batch early reject of triangles lying strictly on one side of each other's plane
+            // (or touching only at shared vertices/edges, which are not reported anyway)
+            vec3d t0[3] = { verts.at(tris.at(3*tid0+0)), verts.at(tris.at(3*tid0+1)), verts.at(tris.at(3*tid0+2)) };
+            triangle_triangles_separated(t0, candidate_verts, filter, true, separated);
+
+            for(uint k=0; k<candidates.size(); ++k)
+            {
+                if(separated.at(k)) continue;
+                uint tid1 = candidates.at(k);
+                if(triangles_intersect(filter, verts, tris, tid0, verts, tris, tid1, true)) // precise check (exact if CINOLIB_USES_SHEWCHUK_PREDICATES is defined)
+                {
+                    buffers.at(i).push_back(unique_pair(tid0,tid1));
+                }
+            }
+        }
+    });
+
+    for(const auto & b : buffers) intersections.insert(intersections.end(), b.begin(), b.end());
+    std::sort(intersections.begin(), intersections.end());
+    intersections.erase(std::unique(intersections.begin(), intersections.end()), intersections.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void find_intersections(const Trimesh<M,V,E,P> & m0,
+                        const Trimesh<M,V,E,P> & m1,
+                        std::vector<ipair>     & intersections)
+{
+    auto tris0 = serialized_vids_from_polys(m0.vector_polys());
+    auto tris1 = serialized_vids_from_polys(m1.vector_polys());
+    find_intersections(m0.vector_verts(), tris0, m1.vector_verts(), tris1, intersections);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void find_intersections(const std::vector<vec3d> & verts0,
+                        const std::vector<uint>  & tris0,
+                        const std::vector<vec3d> & verts1,
+                        const std::vector<uint>  & tris1,
+                              std::vector<ipair> & intersections)
+{
+    intersections.clear();
+
+    Octree o0(FIND_INTERSECTIONS_MAX_DEPTH, FIND_INTERSECTIONS_ITEMS_PER_LEAF);
+    Octree o1(FIND_INTERSECTIONS_MAX_DEPTH, FIND_INTERSECTIONS_ITEMS_PER_LEAF);
+    o0.build_from_vectors(verts0, tris0);
+    o1.build_from_vectors(verts1, tris1);
+
+    std::vector<std::pair<const OctreeNode*,const OctreeNode*>> leaf_pairs;
+    overlapping_leaves(o0, o1, leaf_pairs);
+
+    AABB bbox(verts0);
+    bbox.push(verts1);
+    FilteredPredicates filter(bbox);
+
+    std::vector<std::vector<ipair>> buffers(leaf_pairs.size());
+    PARALLEL_FOR(0, uint(leaf_pairs.size()), 1, [&](uint i)
+    {
+        const OctreeNode *l0 = leaf_pairs.at(i).first;
+        const OctreeNode *l1 = leaf_pairs.at(i).second;
+        std::vector<uint>  candidates;
+        std::vector<vec3d> candidate_verts;
+        std::vector<bool>  separated;
+        for(uint tid0 : l0->item_indices)
+        {
+            const AABB & b0 = o0.items.at(tid0)->aabb;
+            if(!b0.intersects_box(l1->bbox)) continue;
+            candidates.clear();
+            candidate_verts.clear();
+            for(uint tid1 : l1->item_indices)
             {
-                const Triangle *t0 = dynamic_cast<Triangle*>(T0);
-                const Triangle *t1 = dynamic_cast<Triangle*>(T1);
-                if(t0->intersects_triangle(t1->v,true)) // precise check (exact if CINOLIB_USES_SHEWCHUK_PREDICATES is defined)
+                const AABB & b1 = o1.items.at(tid1)->aabb;
+                if(!b0.intersects_box(b1)) continue;
+                vec3d p = min_corner_of_intersection(b0,b1);
+                if(!leaf_owns(l0,o0.root->bbox,p) || !leaf_owns(l1,o1.root->bbox,p)) continue; // tested elsewhere
+                candidates.push_back(tid1);
+                append_triangle(verts1, tris1, tid1, candidate_verts);
+            }
+            if(candidates.empty()) continue;
+
+            // batch early reject of triangles lying strictly on one side of each other's plane
+            vec3d t0[3] = { verts0.at(tris0.at(3*tid0+0)), verts0.at(tris0.at(3*tid0+1)), verts0.at(tris0.at(3*tid0+2)) };
+            triangle_triangles_separated(t0, candidate_verts, filter, false, separated);
+
+            for(uint k=0; k<candidates.size(); ++k)
+            {
+                if(separated.at(k)) continue;
+                uint tid1 = candidates.at(k);
+                if(triangles_intersect(filter, verts0, tris0, tid0, verts1, tris1, tid1, false))
                 {
-                    std::lock_guard<std::mutex> guard(mutex);
-                    intersections.insert(unique_pair(tid0,tid1));
+                    buffers.at(i).push_back(std::make_pair(tid0,tid1));
                 }
             }
         }
     });
+
+    for(const auto & b : buffers) intersections.insert(intersections.end(), b.begin(), b.end());
+    std::sort(intersections.begin(), intersections.end());
+    intersections.erase(std::unique(intersections.begin(), intersections.end()), intersections.end());
 }
 
 }
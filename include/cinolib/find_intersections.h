@@ -40,17 +40,31 @@
 #include <cinolib/meshes/trimesh.h>
 #include <cinolib/ipair.h>
 #include <set>
+#include <vector>
 
 namespace cinolib
 {
 
-/* This method puts all the input polygons into an octree, then
- * performs pairwise intersection tests within each leaf, retunrning
- * a set of pairs of intersecting triangles.
+/* These methods put all the input triangles into an octree, and perform
+ * pairwise intersection tests between triangles that fall in the same
+ * leaf, returning the pairs of intersecting triangles.
  *
- * The output must be a set and not a vector because triangles will
- * appear in all the leaves that have non empty overlap with it. Therefore,
- * the same intersection can be detected multiple times.
+ * Each triangle appears in all the leaves that have non empty overlap with
+ * its bounding box, hence the same pair could be found in multiple leaves.
+ * To avoid redundant tests, a pair is tested only in the (unique) leaf that
+ * contains the minimum corner of the intersection of the bounding boxes of
+ * the two triangles. Leaves are processed in parallel, each with its own
+ * output buffer, and results are merged and sorted at the end.
+ *
+ * For self intersections, triangles that form a valid simplicial complex
+ * (i.e. they only share a vertex or an edge) are not reported. Triangles that
+ * share an edge (topologically) can only intersect elsewhere if they are
+ * coplanar, hence they undergo the full test only in that case.
+ *
+ * For intersections between two different meshes, the two octrees are visited
+ * simultaneously (dual traversal), only descending in pairs of nodes with
+ * overlapping bounding boxes. Any contact is reported, including triangles
+ * touching at a vertex or along an edge (e.g. for clearance checks between parts).
  *
  * IMPORTANT: intersections tests are based on the orient predicates contained
  * in cinolib/predicates.h. These predicates are exact if the symbol
@@ -69,6 +83,34 @@ void find_intersections(const std::vector<vec3d> & verts,
                         const std::vector<uint>  & tris,
                               std::set<ipair>    & intersections);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// intersecting pairs are returned as a sorted vector of unique pairs (tid0<tid1)
+CINO_INLINE
+void find_intersections(const std::vector<vec3d> & verts,
+                        const std::vector<uint>  & tris,
+                              std::vector<ipair> & intersections);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// intersections between two meshes. Each pair (tid0,tid1) contains the id of a
+// triangle in the first mesh and the id of a triangle in the second mesh.
+// Pairs are sorted and unique
+template<class M, class V, class E, class P>
+CINO_INLINE
+void find_intersections(const Trimesh<M,V,E,P> & m0,
+                        const Trimesh<M,V,E,P> & m1,
+                        std::vector<ipair>     & intersections);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void find_intersections(const std::vector<vec3d> & verts0,
+                        const std::vector<uint>  & tris0,
+                        const std::vector<vec3d> & verts1,
+                        const std::vector<uint>  & tris1,
+                              std::vector<ipair> & intersections);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,256 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/geodesic_distance_matrix.h>
+#include <cinolib/dijkstra.h>
+#include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+namespace cinolib
+{
+
+namespace
+{
+CINO_INLINE
+uint n_hardware_threads()
+{
+    uint n = std::thread::hardware_concurrency();
+    return (n==0) ? 8 : n; // same default as PARALLEL_FOR
+}
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P, class Callback>
+CINO_INLINE
+void geodesic_distance_rows(const AbstractMesh<M,V,E,P> & m,
+                            const std::vector<uint>     & sources,
+                                  Callback           && callback,
+                            const uint                    batch_size)
+{
+    uint nv        = m.num_verts();
+    uint n_batch   = (batch_size>0) ? batch_size : 2*n_hardware_threads();
+    uint n_workers = std::min(n_batch, n_hardware_threads());
+
+    std::vector<float>             rows(size_t(n_batch)*nv);
+    std::vector<DijkstraWorkspace> ws(n_workers);
+
+    for(uint beg=0; beg<sources.size(); beg+=n_batch)
+    {
+        uint n = std::min(n_batch, uint(sources.size())-beg);
+
+        // each worker processes the sources beg+w, beg+w+n_workers, ...
+        PARALLEL_FOR(0, std::min(n,n_workers), 2, [&](const uint w)
+        {
+            for(uint i=w; i<n; i+=n_workers)
+            {
+                dijkstra_exhaustive(m, sources.at(beg+i), ws.at(w));
+                std::copy(ws.at(w).dist.begin(), ws.at(w).dist.end(), rows.begin()+size_t(i)*nv);
+            }
+        });
+
+        for(uint i=0; i<n; ++i) callback(beg+i, rows.data()+size_t(i)*nv);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh, class Callback>
+CINO_INLINE
+void heat_geodesic_distance_rows(      Mesh              & m,
+                                       GeodesicsCache    & cache,
+                                 const std::vector<uint> & sources,
+                                       Callback         && callback,
+                                 const int                 laplacian_mode,
+                                 const float               time_scalar,
+                                 const uint                batch_size)
+{
+    if(cache.heat_flow_cache == NULL)
+    {
+        compute_geodesics_cache(m, cache, laplacian_mode, time_scalar);
+    }
+
+    uint nv        = m.num_verts();
+    uint n_batch   = (batch_size>0) ? batch_size : 2*n_hardware_threads();
+    uint n_workers = std::min(n_batch, n_hardware_threads());
+
+    // per element areas (volumes) of the unit size mesh the matrices refer
+    // to, used to weight the divergence of the normalized heat gradient
+    const Eigen::SparseMatrix<double> & G = cache.gradient_matrix;
+    double          s = m.mesh_is_volumetric() ? std::pow(cache.scale,3) : std::pow(cache.scale,2);
+    Eigen::VectorXd A(G.rows());
+    for(uint pid=0; pid<m.num_polys(); ++pid) A.segment<3>(3*pid).setConstant(m.poly_mass(pid)/s);
+
+    std::vector<float> rows(size_t(n_batch)*nv);
+
+    for(uint beg=0; beg<sources.size(); beg+=n_batch)
+    {
+        uint n = std::min(n_batch, uint(sources.size())-beg);
+        uint w = std::min(n,n_workers);
+
+        // each worker solves for a contiguous block of sources
+        PARALLEL_FOR(0, w, 2, [&](const uint wid)
+        {
+            uint i0 = beg + (n*wid)/w;
+            uint i1 = beg + (n*(wid+1))/w;
+            if(i0==i1) return;
+
+            Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(nv, i1-i0);
+            for(uint i=i0; i<i1; ++i) rhs(sources.at(i), i-i0) = 1.0;
+
+            Eigen::MatrixXd heat = cache.heat_flow_cache->solve(rhs);
+            Eigen::MatrixXd grad = G * heat;
+            for(int col=0; col<grad.cols(); ++col)
+            for(int row=0; row<grad.rows(); row+=3)
+            {
+                double norm = grad.block<3,1>(row,col).norm();
+                if(norm>0) grad.block<3,1>(row,col) *= A[row]/norm;
+            }
+            Eigen::MatrixXd phi = cache.integration_cache->solve(G.transpose() * grad);
+
+            // phi grows towards the source and is defined up to a constant:
+            // shift it so that its maximum maps to zero distance, and rescale
+            // it from the unit size mesh used for factorization to mesh units
+            for(uint i=i0; i<i1; ++i)
+            {
+                double max = phi.col(i-i0).maxCoeff();
+                float *row = rows.data() + size_t(i-beg)*nv;
+                for(uint vid=0; vid<nv; ++vid) row[vid] = float((max - phi(vid,i-i0)) * cache.scale);
+            }
+        });
+
+        for(uint i=0; i<n; ++i) callback(beg+i, rows.data()+size_t(i)*nv);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void geodesic_distance_matrix(const AbstractMesh<M,V,E,P> & m,
+                              const std::vector<uint>     & sources,
+                                    std::vector<float>    & D)
+{
+    uint nv = m.num_verts();
+    D.resize(size_t(sources.size())*nv);
+    geodesic_distance_rows(m, sources, [&](const uint row, const float *dist)
+    {
+        std::copy(dist, dist+nv, D.begin()+size_t(row)*nv);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void heat_geodesic_distance_matrix(      Mesh               & m,
+                                         GeodesicsCache     & cache,
+                                   const std::vector<uint>  & sources,
+                                         std::vector<float> & D,
+                                   const int                  laplacian_mode,
+                                   const float                time_scalar)
+{
+    uint nv = m.num_verts();
+    D.resize(size_t(sources.size())*nv);
+    heat_geodesic_distance_rows(m, cache, sources, [&](const uint row, const float *dist)
+    {
+        std::copy(dist, dist+nv, D.begin()+size_t(row)*nv);
+    },
+    laplacian_mode, time_scalar);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+DistanceMatrixWriter::DistanceMatrixWriter(const char * filename, const uint n_rows, const uint n_cols)
+    : f(filename, std::ios::binary)
+    , n_rows(n_rows)
+    , n_cols(n_cols)
+{
+    uint32_t header[2] = { n_rows, n_cols };
+    f.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DistanceMatrixWriter::operator()(const uint row, const float * dist)
+{
+    assert(row==next_row && row<n_rows);
+    f.write(reinterpret_cast<const char*>(dist), sizeof(float)*n_cols);
+    ++next_row;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+NearestSources::NearestSources(const uint n_verts, const uint k)
+    : k(k)
+    , ids(size_t(n_verts)*k, -1)
+    , dists(size_t(n_verts)*k, inf_float)
+{
+    assert(k>0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void NearestSources::operator()(const uint row, const float * dist)
+{
+    uint nv = uint(ids.size()/k);
+    PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+    {
+        float  d  = dist[vid];
+        int   *id = ids.data()   + size_t(vid)*k;
+        float *ds = dists.data() + size_t(vid)*k;
+        if(!(d < ds[k-1])) return;
+        // insertion sort of the new candidate
+        uint i = k-1;
+        while(i>0 && d<ds[i-1])
+        {
+            ds[i] = ds[i-1];
+            id[i] = id[i-1];
+            --i;
+        }
+        ds[i] = d;
+        id[i] = int(row);
+    });
+}
+
+}
@@ -0,0 +1,181 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_GEODESIC_DISTANCE_MATRIX_H
+#define CINO_GEODESIC_DISTANCE_MATRIX_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/geodesics.h>
+#include <cinolib/meshes/abstract_mesh.h>
+#include <fstream>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Geodesic distances from many sources at once, for applications such as
+ * landmark MDS, shape descriptors or all-pairs distances among samples.
+ *
+ * Sources are processed in batches. All the sources in a batch are solved
+ * concurrently, and the resulting distance fields are then delivered to a
+ * callback, row by row and in the same order as the sources, as
+ *
+ *      callback(const uint row, const float * dist)
+ *
+ * where row is the position of the source in the input list and dist is an
+ * array of num_verts() distances (valid only until the callback returns).
+ * Peak memory is therefore bounded by batch_size * num_verts() floats,
+ * regardless of the number of sources. Rows can be stored in a dense matrix
+ * (geodesic_distance_matrix), streamed to disk (DistanceMatrixWriter), or
+ * reduced on the fly (NearestSources).
+ *
+ * Two flavors are available:
+ *
+ *  - geodesic_distance_rows: shortest paths along mesh edges. Each thread
+ *    runs its own Dijkstra on the (read only) mesh, with a private workspace;
+ *
+ *  - heat_geodesic_distance_rows: geodesics in heat (see geodesics.h). Each
+ *    thread solves the heat flow and Poisson problems for a block of sources
+ *    at once (i.e. a multi column right hand side), back-substituting through
+ *    the factorizations stored in the cache. If the cache is empty it is
+ *    computed at the first call.
+ *
+ * In both cases distances are expressed in mesh units and are zero at the
+ * source. Note that this differs from compute_geodesics_amortized, which
+ * returns heat geodesics normalized in [0,1], with 1 at the sources. To get
+ * distances in mesh units, heat_geodesic_distance_rows weights the divergence
+ * of the normalized heat gradient by element areas, as in the original paper.
+ * The scale is exact for triangle meshes, where the cotangent Laplacian is
+ * consistent with the gradient operator. For volume meshes the two operators
+ * follow different normalizations, and only relative distances are reliable.
+ * If batch_size is zero, twice the number of hardware threads is used.
+*/
+
+template<class M, class V, class E, class P, class Callback>
+CINO_INLINE
+void geodesic_distance_rows(const AbstractMesh<M,V,E,P> & m,
+                            const std::vector<uint>     & sources,
+                                  Callback           && callback,
+                            const uint                    batch_size = 0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh, class Callback>
+CINO_INLINE
+void heat_geodesic_distance_rows(      Mesh              & m,
+                                       GeodesicsCache    & cache,
+                                 const std::vector<uint> & sources,
+                                       Callback         && callback,
+                                 const int                 laplacian_mode = COTANGENT,
+                                 const float               time_scalar = 1.0,
+                                 const uint                batch_size = 0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// dense |sources| x num_verts() distance matrix, stored row major
+template<class M, class V, class E, class P>
+CINO_INLINE
+void geodesic_distance_matrix(const AbstractMesh<M,V,E,P> & m,
+                              const std::vector<uint>     & sources,
+                                    std::vector<float>    & D);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// dense |sources| x num_verts() distance matrix, stored row major
+template<class Mesh>
+CINO_INLINE
+void heat_geodesic_distance_matrix(      Mesh               & m,
+                                         GeodesicsCache     & cache,
+                                   const std::vector<uint>  & sources,
+                                         std::vector<float> & D,
+                                   const int                  laplacian_mode = COTANGENT,
+                                   const float                time_scalar = 1.0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Callback that streams distance rows to a binary file, which will contain
+ * two uint32 (number of rows and columns) followed by the float32 distances,
+ * row major. Rows must be received in order.
+*/
+
+class DistanceMatrixWriter
+{
+    public:
+
+        explicit DistanceMatrixWriter(const char * filename, const uint n_rows, const uint n_cols);
+
+        void operator()(const uint row, const float * dist);
+
+        bool good() const { return f.good(); }
+
+    protected:
+
+        std::ofstream f;
+        uint          n_rows;
+        uint          n_cols;
+        uint          next_row = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Callback that keeps, for each vertex, the k closest sources (as positions
+ * in the list of sources) and their distances, sorted by increasing distance.
+ * Vertices reached by less than k sources have trailing entries with id -1
+ * and infinite distance. Ties are broken in favor of the first source.
+*/
+
+class NearestSources
+{
+    public:
+
+        explicit NearestSources(const uint n_verts, const uint k);
+
+        void operator()(const uint row, const float * dist);
+
+        int   source  (const uint vid, const uint i) const { return ids.at(vid*k+i);   }
+        float distance(const uint vid, const uint i) const { return dists.at(vid*k+i); }
+
+        uint               k;
+        std::vector<int>   ids;   // n_verts x k, row major
+        std::vector<float> dists; // n_verts x k, row major
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "geodesic_distance_matrix.cpp"
+#endif
+
+#endif // CINO_GEODESIC_DISTANCE_MATRIX_H
@@ -100,6 +100,46 @@ ScalarField compute_geodesics(      Mesh              & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class Mesh>
+CINO_INLINE
+void compute_geodesics_cache(      Mesh           & m,
+                                   GeodesicsCache & cache,
+                             const int              laplacian_mode,
+                             const float            time_scalar)
+{
+    // optimize position and scale to get better numerical precision
+    double d = m.bbox().diag();
+    vec3d  c = m.bbox().center();
+    m.translate(-c);
+    m.scale(1.0/d);
+
+    // use the squared avg edge length as time step, as suggested in the original paper
+    double time = m.edge_avg_length();
+    time *= time;
+    time *= time_scalar;
+
+    Eigen::SparseMatrix<double> L  = laplacian(m, laplacian_mode);
+    Eigen::SparseMatrix<double> MM = mass_matrix(m);
+
+    delete cache.heat_flow_cache;
+    delete cache.integration_cache;
+
+    cache.heat_flow_cache = new Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>(MM - time * L);
+    assert(cache.heat_flow_cache->info() == Eigen::Success);
+
+    cache.integration_cache = new Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>(-L);
+    assert(cache.integration_cache->info() == Eigen::Success);
+
+    cache.gradient_matrix = gradient_matrix(m);
+    cache.scale           = d;
+
+    // restore original scale and position
+    m.scale(d);
+    m.translate(c);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Mesh>
 CINO_INLINE
 ScalarField compute_geodesics_amortized(      Mesh              & m,
@@ -109,61 +149,24 @@ ScalarField compute_geodesics_amortized(      Mesh              & m,
                                         const float               time_scalar)
 {
     // first call, heavy solve (matrix factorization + gradient matrix)
-    if (cache.heat_flow_cache == NULL)
+    if(cache.heat_flow_cache == NULL)
     {
-        // optimize position and scale to get better numerical precision
-        double d = m.bbox().diag();
-        vec3d  c = m.bbox().center();
-        m.translate(-c);
-        m.scale(1.0/d);
-
-        // use the squared avg edge length as time step, as suggested in the original paper
-        double time = m.edge_avg_length();
-        time *= time;
-        time *= time_scalar;
-
-        Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
-        Eigen::SparseMatrix<double> MM  = mass_matrix(m);
-        Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(m.num_verts());
-
-        for(uint vid : heat_charges) rhs[vid] = 1.0;
-
-        ScalarField heat(m.num_verts());
-        cache.heat_flow_cache = new Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>(MM - time * L);
-        assert(cache.heat_flow_cache->info() == Eigen::Success);
-        heat = cache.heat_flow_cache->solve(rhs).eval();
-
-        cache.gradient_matrix = gradient_matrix(m);
-        VectorField grad = cache.gradient_matrix * heat;
-        grad.normalize();
-
-        ScalarField geodesics(m.num_verts());
-        cache.integration_cache = new Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>(-L);
-        assert(cache.integration_cache->info() == Eigen::Success);
-        geodesics = cache.integration_cache->solve(cache.gradient_matrix.transpose() * grad).eval();
-        geodesics.normalize_in_01();
-
-        // restore original scale and position
-        m.scale(d);
-        m.translate(c);
-        return geodesics;
+        compute_geodesics_cache(m, cache, laplacian_mode, time_scalar);
     }
-    else // solve by back-substitution using pre-factored matrices
-    {
-        Eigen::VectorXd rhs = Eigen::VectorXd::Zero(m.num_verts());
-        for(uint vid : heat_charges) rhs[vid] = 1.0;
-        ScalarField heat = cache.heat_flow_cache->solve(rhs).eval();
 
-        VectorField grad = cache.gradient_matrix * heat;
-        grad.normalize();
+    // solve by back-substitution using pre-factored matrices
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(m.num_verts());
+    for(uint vid : heat_charges) rhs[vid] = 1.0;
+    ScalarField heat = cache.heat_flow_cache->solve(rhs).eval();
 
-        ScalarField geodesics(m.num_verts());
-        geodesics = cache.integration_cache->solve(cache.gradient_matrix.transpose() * grad).eval();
-        geodesics.normalize_in_01();
+    VectorField grad = cache.gradient_matrix * heat;
+    grad.normalize();
 
-        return geodesics;
-    }
+    ScalarField geodesics(m.num_verts());
+    geodesics = cache.integration_cache->solve(cache.gradient_matrix.transpose() * grad).eval();
+    geodesics.normalize_in_01();
 
+    return geodesics;
 }
 
 }
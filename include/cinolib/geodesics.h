@@ -84,10 +84,22 @@ struct GeodesicsCache
     Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>  *heat_flow_cache   = NULL;
     Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> *integration_cache = NULL;
     Eigen::SparseMatrix<double>                         gradient_matrix;
+    double                                              scale = 1.0; // bbox diagonal of the mesh (matrices refer to a unit size copy of it)
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// factorize the heat flow and integration matrices, and compute the gradient
+// matrix. This is done automatically at the first call of compute_geodesics_amortized
+template<class Mesh>
+CINO_INLINE
+void compute_geodesics_cache(      Mesh           & m,
+                                   GeodesicsCache & cache,
+                             const int              laplacian_mode = COTANGENT,
+                             const float            time_scalar = 1.0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Mesh>
 CINO_INLINE
 ScalarField compute_geodesics_amortized(      Mesh              & m,
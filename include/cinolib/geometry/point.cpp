@@ -100,4 +100,12 @@ bool Point::intersects_triangle(const vec3d t[], const bool ignore_if_valid_comp
     return (res!=STRICTLY_OUTSIDE);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Point::range_along(const vec3d & dir, double & min, double & max) const
+{
+    min = max = v.dot(dir);
+}
+
 }
@@ -211,4 +211,18 @@ bool Segment::intersects_triangle(const vec3d t[], const bool ignore_if_valid_co
 //    return v.dot(v) - e*e/f;
 //}
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Segment::range_along(const vec3d & dir, double & min, double & max) const
+{
+    min = max = v[0].dot(dir);
+    for(int i=1; i<2; ++i)
+    {
+        double d = v[i].dot(dir);
+        min = std::min(min, d);
+        max = std::max(max, d);
+    }
+}
+
 }
@@ -76,6 +76,7 @@ class Segment : public SpatialDataStructureItem
         bool     contains               (const vec3d & p, const bool strict) const override;
         bool     intersects_segment     (const vec3d   s[], const bool ignore_if_valid_complex) const override;
         bool     intersects_triangle    (const vec3d   t[], const bool ignore_if_valid_complex) const override;
+        void     range_along            (const vec3d & dir, double & min, double & max) const override;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
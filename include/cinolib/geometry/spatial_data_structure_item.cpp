@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/geometry/spatial_data_structure_item.h>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -52,4 +53,20 @@ double SpatialDataStructureItem::dist_sqrd(const vec3d &p) const
     return p.dist_sqrd(point_closest_to(p));
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SpatialDataStructureItem::range_along(const vec3d & dir, double & min, double & max) const
+{
+    min = max = 0;
+    for(uint i=0; i<3; ++i)
+    {
+        double lo = dir[i] * aabb.min[i];
+        double hi = dir[i] * aabb.max[i];
+        if(lo>hi) std::swap(lo,hi);
+        min += lo;
+        max += hi;
+    }
+}
+
 }
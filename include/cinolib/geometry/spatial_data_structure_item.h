@@ -89,6 +89,13 @@ namespace cinolib
             virtual bool intersects_segment (const vec3d s[], const bool ignore_if_valid_complex) const = 0;
             virtual bool intersects_triangle(const vec3d t[], const bool ignore_if_valid_complex) const = 0;
             virtual bool intersects_ray     (const vec3d & p, const vec3d & dir, double & t, vec3d & pos) const = 0;
+
+            //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+            // range [min,max] spanned by the dot products between dir and all points in the item.
+            // The default implementation returns the (conservative) range spanned by the item's
+            // AABB. Items that can provide a tighter range should override it
+            virtual void range_along(const vec3d & dir, double & min, double & max) const;
     };
 }
 
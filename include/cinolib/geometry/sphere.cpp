@@ -100,4 +100,15 @@ bool Sphere::intersects_triangle(const vec3d /*t*/[], const bool /*ignore_if_val
     return false;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Sphere::range_along(const vec3d & dir, double & min, double & max) const
+{
+    double d = c.dot(dir);
+    double e = r * dir.norm();
+    min = d - e;
+    max = d + e;
+}
+
 }
@@ -113,5 +113,18 @@ bool Tetrahedron::intersects_triangle(const vec3d [], const bool) const
     return false;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Tetrahedron::range_along(const vec3d & dir, double & min, double & max) const
+{
+    min = max = v[0].dot(dir);
+    for(int i=1; i<4; ++i)
+    {
+        double d = v[i].dot(dir);
+        min = std::min(min, d);
+        max = std::max(max, d);
+    }
 }
 
+}
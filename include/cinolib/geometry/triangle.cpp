@@ -103,5 +103,18 @@ bool Triangle::intersects_triangle(const vec3d t[], const bool ignore_if_valid_c
     return (res>=SIMPLICIAL_COMPLEX);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Triangle::range_along(const vec3d & dir, double & min, double & max) const
+{
+    min = max = v[0].dot(dir);
+    for(int i=1; i<3; ++i)
+    {
+        double d = v[i].dot(dir);
+        min = std::min(min, d);
+        max = std::max(max, d);
+    }
 }
 
+}
@@ -42,6 +42,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/gradient.h>
+#include <cinolib/operator_assembler.h>
 
 namespace cinolib
 {
@@ -56,35 +57,10 @@ Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolygonMesh<M,V,E,P> &
 {
     if(per_poly)
     {
-        Eigen::SparseMatrix<double> G(m.num_polys()*3, m.num_verts());
-        std::vector<Entry> entries;
-
-        for(uint pid=0; pid<m.num_polys(); ++pid)
-        {
-            double area = std::max(m.poly_area(pid), 1e-5) * 2.0; // (2 is the average term : two verts for each edge)
-            vec3d n     = m.poly_data(pid).normal;
-
-            for(uint off=0; off<m.verts_per_poly(pid); ++off)
-            {
-                uint  prev = m.poly_vert_id(pid,off);
-                uint  curr = m.poly_vert_id(pid,(off+1)%m.verts_per_poly(pid));
-                uint  next = m.poly_vert_id(pid,(off+2)%m.verts_per_poly(pid));
-                vec3d u    = m.vert(next) - m.vert(curr);
-                vec3d v    = m.vert(curr) - m.vert(prev);
-                vec3d u_90 = u.cross(n); u_90.normalize();
-                vec3d v_90 = v.cross(n); v_90.normalize();
-
-                vec3d per_vert_sum_over_edge_normals = u_90 * u.norm() + v_90 * v.norm();
-                per_vert_sum_over_edge_normals /= area;
-
-                uint row = 3 * pid;
-                entries.push_back(Entry(row, curr, per_vert_sum_over_edge_normals.x())); ++row;
-                entries.push_back(Entry(row, curr, per_vert_sum_over_edge_normals.y())); ++row;
-                entries.push_back(Entry(row, curr, per_vert_sum_over_edge_normals.z()));
-            }
-        }
-
-        G.setFromTriplets(entries.begin(), entries.end());
+        // direct (parallel) assembly in compressed format, see operator_assembler.h
+        Eigen::SparseMatrix<double> G;
+        OperatorAssembler assembler;
+        assembler.gradient_matrix(m, G);
         return G;
     }
     else // per vertex
@@ -137,70 +113,20 @@ Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F
 {
     if(per_poly)
     {
-        Eigen::SparseMatrix<double> G(m.num_polys()*3, m.num_verts());
-        std::vector<Entry> entries;
-
-        for(uint pid=0; pid<m.num_polys(); ++pid)
-        {
-            double vol = std::max(m.poly_volume(pid), 1e-5);
-
-            for(uint vid : m.adj_p2v(pid))
-            {
-                vec3d per_vert_sum_over_f_normals(0,0,0);
-                for(uint fid : m.adj_p2f(pid))
-                {
-                    if (m.face_contains_vert(fid,vid))
-                    {
-                        vec3d  n   = m.poly_face_normal(pid,fid);
-                        double a   = m.face_area(fid);
-                        double avg = static_cast<double>(m.verts_per_face(fid));
-                        per_vert_sum_over_f_normals += (n*a)/avg;
-                    }
-                }
-                per_vert_sum_over_f_normals /= vol;
-                uint row = 3 * pid;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.x())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.y())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.z()));
-            }
-        }
-
-        G.setFromTriplets(entries.begin(), entries.end());
+        // direct (parallel) assembly in compressed format, see operator_assembler.h
+        Eigen::SparseMatrix<double> G;
+        OperatorAssembler assembler;
+        assembler.gradient_matrix(m, G);
         return G;
     }
     else // per vert
     {
-        Eigen::SparseMatrix<double> G(m.num_polys()*3, m.num_verts());
-        std::vector<Entry> entries;
-
-        for(uint pid=0; pid<m.num_polys(); ++pid)
-        {
-            double vol = std::max(m.poly_volume(pid), 1e-5);
-
-            for(uint vid : m.adj_p2v(pid))
-            {
-                vec3d per_vert_sum_over_f_normals(0,0,0);
-                for(uint fid : m.adj_p2f(pid))
-                {
-                    if (m.face_contains_vert(fid,vid))
-                    {
-                        vec3d  n   = m.poly_face_normal(pid,fid);
-                        double a   = m.face_area(fid);
-                        double avg = static_cast<double>(m.verts_per_face(fid));
-                        per_vert_sum_over_f_normals += (n*a)/avg;
-                    }
-                }
-                per_vert_sum_over_f_normals /= vol;
-                uint row = 3 * pid;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.x())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.y())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.z()));
-            }
-        }
-        G.setFromTriplets(entries.begin(), entries.end());
+        Eigen::SparseMatrix<double> G;
+        OperatorAssembler assembler;
+        assembler.gradient_matrix(m, G);
 
         Eigen::SparseMatrix<double> A(m.num_verts()*3, m.num_polys()*3);
-        entries.clear();
+        std::vector<Entry> entries;
 
         for(uint vid=0;vid<m.num_verts();++vid)
         {
@@ -108,6 +108,7 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
     //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
     // for each surface point, find the closest point on srf
+    std::vector<uint> proj_item(m.num_verts(), uint(-1)); // closest item found at the previous call
     auto update_targets = [&](const uint smooth_iters, const bool sort_by_dist)
     {
         // pre smooth the surface
@@ -137,17 +138,37 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
             });
         }
 
+        // batch projection onto the target octrees. Vertices move only slightly between
+        // consecutive calls, hence previous results are used to warm start the search
+        std::vector<vec3d> proj_pos = verts;
+        for(int label : {REGULAR, CORNER, LINE})
+        {
+            const Octree & o = (label==REGULAR) ? o_srf : ((label==CORNER) ? o_corners : o_lines);
+            std::vector<uint>  vids, hint, index;
+            std::vector<vec3d> p, pos;
+            std::vector<vec4d> bc;
+            for(uint vid=0; vid<m.num_verts(); ++vid)
+            {
+                if(!m.vert_is_on_srf(vid) || m.vert_data(vid).label!=label) continue;
+                vids.push_back(vid);
+                p.push_back(verts.at(vid));
+                hint.push_back(proj_item.at(vid));
+            }
+            if(vids.empty()) continue;
+            o.closest_points(p, index, pos, bc, hint);
+            for(uint i=0; i<vids.size(); ++i)
+            {
+                proj_item.at(vids.at(i)) = index.at(i);
+                proj_pos.at(vids.at(i))  = pos.at(i);
+            }
+        }
+
         targets.clear();
         for(uint vid=0; vid<m.num_verts(); ++vid)
         {
             Proj proj;
             proj.vid    = vid;
-            switch(m.vert_data(vid).label)
-            {
-                case REGULAR : proj.target = (m.vert_is_on_srf(vid)) ? o_srf.closest_point(verts.at(vid)) : verts.at(vid); break;
-                case CORNER  : proj.target = o_corners.closest_point(verts.at(vid)); break;
-                case LINE    : proj.target = o_lines.closest_point(verts.at(vid)); break;
-            }
+            proj.target = proj_pos.at(vid);
             proj.dist   = (m.vert_is_on_srf(vid)) ? 1/verts.at(vid).dist(proj.target) : -verts.at(vid).dist(proj.target);
             targets.push_back(proj);
         }
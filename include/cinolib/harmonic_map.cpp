@@ -34,7 +34,6 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/harmonic_map.h>
-#include <cinolib/laplacian.h>
 #include <Eigen/Sparse>
 
 namespace cinolib
@@ -47,31 +46,58 @@ ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
                          const uint                    n,
                          const int                     laplacian_mode,
                          const int                     solver)
+{
+    OperatorCache cache;
+    return harmonic_map(m, cache, bc, n, laplacian_mode, solver);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
+                                   const std::map<uint,vec3d>  & bc,
+                                   const uint                    n,
+                                   const int                     laplacian_mode,
+                                   const int                     solver)
+{
+    OperatorCache cache;
+    return harmonic_map_3d(m, cache, bc, n, laplacian_mode, solver);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
+                               OperatorCache         & cache,
+                         const std::map<uint,double> & bc,
+                         const uint                    n,
+                         const int                     laplacian_mode,
+                         const int                     solver)
 {
     assert(n > 0);
     assert(bc.size() > 0);
     assert(laplacian_mode == COTANGENT || laplacian_mode == UNIFORM);
-    assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB);
+    assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB || solver == MULTIGRID || is_iterative_solver(solver));
 
-    ScalarField f(m.num_verts());
+    std::vector<uint> constrained;
+    for(const auto & obj : bc) constrained.push_back(obj.first);
 
-    Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
-    Eigen::SparseMatrix<double> Ln = -L;
-    Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(m.num_verts());
+    ScalarField     f(m.num_verts());
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(m.num_verts());
 
-    for(uint i=1; i<n; ++i) Ln  = Ln * (-L); // keep it PSD
-
-    solve_square_system_with_bc(Ln, rhs, f, bc, solver);
+    cache.polyharmonic_system(m, n, laplacian_mode, constrained, solver).solve(rhs, bc, f);
 
     return f;
 }
 
-
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class P>
 CINO_INLINE
 std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
+                                         OperatorCache         & cache,
                                    const std::map<uint,vec3d>  & bc,
                                    const uint                    n,
                                    const int                     laplacian_mode,
@@ -80,34 +106,26 @@ std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
     assert(n > 0);
     assert(bc.size() > 0);
     assert(laplacian_mode == COTANGENT || laplacian_mode == UNIFORM);
-    assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB);
-
-    ScalarField f(3*m.num_verts());
-
-    Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode, 3);
-    Eigen::SparseMatrix<double> Ln = -L;
-    Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(3*m.num_verts());
-
-    for(uint i=1; i<n; ++i) Ln  = Ln * (-L); // keep it PSD
+    assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB || solver == MULTIGRID || is_iterative_solver(solver));
 
-    uint y_off = m.num_verts();
-    uint z_off = m.num_verts() + y_off;
-    std::map<uint,double> bc_1d;
-    for(auto obj : bc)
+    // the three coordinates are decoupled: rather than solving a 3n x 3n
+    // system, solve the n x n scalar system with three right hand sides
+    std::vector<uint> constrained;
+    Eigen::MatrixXd   bc_xyz(bc.size(), 3);
+    for(const auto & obj : bc)
     {
-        uint  vid = obj.first;
-        vec3d pos = obj.second;
-        bc_1d[      vid] = pos.x();
-        bc_1d[y_off+vid] = pos.y();
-        bc_1d[z_off+vid] = pos.z();
+        bc_xyz.row(constrained.size()) << obj.second.x(), obj.second.y(), obj.second.z();
+        constrained.push_back(obj.first);
     }
 
-    solve_square_system_with_bc(Ln, rhs, f, bc_1d, solver);
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(m.num_verts(), 3);
+    Eigen::MatrixXd xyz;
+    cache.polyharmonic_system(m, n, laplacian_mode, constrained, solver).solve(rhs, bc_xyz, xyz);
 
     std::vector<vec3d> res(m.num_verts());
     for(uint vid=0; vid<m.num_verts(); ++vid)
     {
-        res.at(vid) = vec3d(f[vid], f[y_off+vid], f[z_off+vid]);
+        res.at(vid) = vec3d(xyz(vid,0), xyz(vid,1), xyz(vid,2));
     }
 
     return res;
@@ -43,6 +43,7 @@
 #include <cinolib/scalar_field.h>
 #include <cinolib/linear_solvers.h>
 #include <cinolib/symbols.h>
+#include <cinolib/operator_cache.h>
 
 namespace cinolib
 {
@@ -76,6 +77,33 @@ std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
                                    const uint                    n = 1,
                                    const int                     laplacian_mode = COTANGENT,
                                    const int                     solver = SIMPLICIAL_LLT);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but the operators and the factorized system are taken from
+// (or stored into) the cache. Repeated calls that constrain the same set of
+// vertices (possibly to different values) only cost a back substitution.
+// See operator_cache.h
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
+                               OperatorCache         & cache,
+                         const std::map<uint,double> & bc,
+                         const uint                    n = 1,
+                         const int                     laplacian_mode = COTANGENT,
+                         const int                     solver = SIMPLICIAL_LLT);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
+                                         OperatorCache         & cache,
+                                   const std::map<uint,vec3d>  & bc,
+                                   const uint                    n = 1,
+                                   const int                     laplacian_mode = COTANGENT,
+                                   const int                     solver = SIMPLICIAL_LLT);
 }
 
 #ifndef  CINO_STATIC_LIB
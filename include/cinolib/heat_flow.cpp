@@ -34,9 +34,6 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/heat_flow.h>
-#include <cinolib/laplacian.h>
-#include <cinolib/vertex_mass.h>
-#include <cinolib/linear_solvers.h>
 #include <Eigen/Sparse>
 
 namespace cinolib
@@ -50,27 +47,40 @@ ScalarField heat_flow(const AbstractMesh<M,V,E,P> & m,
                       const int                     laplacian_mode,
                       const bool                    hard_contraint_bcs)
 {
-    assert(heat_charges.size() > 0);
+    OperatorCache cache;
+    return heat_flow(m, cache, heat_charges, time, laplacian_mode, hard_contraint_bcs);
+}
 
-    ScalarField heat(m.num_verts());
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
-    Eigen::SparseMatrix<double> MM  = mass_matrix(m);
-    Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(m.num_verts());
+template<class M, class V, class E, class P>
+CINO_INLINE
+ScalarField heat_flow(const AbstractMesh<M,V,E,P> & m,
+                            OperatorCache         & cache,
+                      const std::vector<uint>     & heat_charges,
+                      const double                  time,
+                      const int                     laplacian_mode,
+                      const bool                    hard_contraint_bcs)
+{
+    assert(heat_charges.size() > 0);
+
+    ScalarField     heat(m.num_verts());
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(m.num_verts());
 
     if (hard_contraint_bcs) // heat flow as a boundary problem (charges do not lose heat)
     {
         std::map<uint,double> bcs;
         for(uint vid: heat_charges) bcs[vid] = 1.0;
-        solve_square_system_with_bc(MM - time * L, rhs, heat, bcs);
+        std::vector<uint> constrained;
+        for(const auto & obj : bcs) constrained.push_back(obj.first);
+        cache.heat_flow_system(m, time, laplacian_mode, constrained).solve(rhs, bcs, heat);
     }
     else // heat flow as a diffusion problem (charges lose heat)
     {
         for(uint vid : heat_charges) rhs[vid] = 1.0;
-        solve_square_system(MM - time * L, rhs, heat);
+        cache.heat_flow_system(m, time, laplacian_mode).solve(rhs, heat);
     }
 
-
     return heat;
 }
 
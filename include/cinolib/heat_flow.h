@@ -42,6 +42,7 @@
 #include <cinolib/scalar_field.h>
 #include <cinolib/meshes/abstract_mesh.h>
 #include <cinolib/symbols.h>
+#include <cinolib/operator_cache.h>
 
 namespace cinolib
 {
@@ -57,6 +58,21 @@ ScalarField heat_flow(const AbstractMesh<M,V,E,P> & m,
                       const double                  time = 1.0,
                       const int                     laplacian_mode = COTANGENT,
                       const bool                    hard_contraint_bcs = false);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but the operators and the factorized system are taken from
+// (or stored into) the cache, so that repeated calls with the same time step
+// (and, if hard_contraint_bcs is true, the same charges) only cost a back
+// substitution. See operator_cache.h
+template<class M, class V, class E, class P>
+CINO_INLINE
+ScalarField heat_flow(const AbstractMesh<M,V,E,P> & m,
+                            OperatorCache         & cache,
+                      const std::vector<uint>     & heat_charges,
+                      const double                  time = 1.0,
+                      const int                     laplacian_mode = COTANGENT,
+                      const bool                    hard_contraint_bcs = false);
 }
 
 #ifndef  CINO_STATIC_LIB
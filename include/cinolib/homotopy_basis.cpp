@@ -37,6 +37,7 @@
 #include <cinolib/shortest_path_tree.h>
 #include <cinolib/mst.h>
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -90,24 +91,27 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
 {
     assert(root<m.num_verts());
 
-    shortest_path_tree(m, root, tree);
+    std::vector<double> edge_lengths(m.num_edges());
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](uint eid){ edge_lengths.at(eid) = m.edge_length(eid); });
+
+    std::vector<double> dist; // distance from root, along the tree
+    std::vector<int>    prev; // parent of each vertex in the tree
+    parallel_shortest_path_tree(m, root, edge_lengths, std::vector<bool>(m.num_edges(),false), tree, dist, prev);
 
     // Compute the cotree as the Maximum Spanning Tree of the dual of M,
     // without considering dual edges that cross edges of primal tree.
     //
-    // I'm using a classical Minimum Spanning Tree algorithm (Prim's) with negative weights
+    // I'm using a classical Minimum Spanning Tree algorithm (Boruvka's) with negative weights.
+    // The weight of each edge is the length of the loop it closes with the tree
     std::vector<float> edge_weights(m.num_edges(),0);
-    std::vector<bool>  edge_mask(m.num_edges()); // restrict Dijkstra to the edges in tree only
-    for(uint eid=0; eid<m.num_edges(); ++eid) edge_mask.at(eid) = !tree.at(eid);
-    for(uint eid=0; eid<m.num_edges(); ++eid)
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](uint eid)
     {
-        if(tree.at(eid)) continue;
-        std::vector<uint> tmp;
-        edge_weights.at(eid) -= float(m.edge_length(eid));
-        edge_weights.at(eid) -= float(dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, tmp));
-        edge_weights.at(eid) -= float(dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, tmp));
-    }
-    MST_on_dual_mask_on_edges(m, edge_weights, tree, cotree); // use tree as edge mask
+        if(tree.at(eid)) return;
+        edge_weights.at(eid) -= float(edge_lengths.at(eid));
+        edge_weights.at(eid) -= float(dist.at(m.edge_vert_id(eid,0)));
+        edge_weights.at(eid) -= float(dist.at(m.edge_vert_id(eid,1)));
+    });
+    parallel_MST_on_dual_mask_on_edges(m, edge_weights, tree, cotree); // use tree as edge mask
 
     // Find the edges neither in tree, nor in cotree
     std::vector<uint> generators;
@@ -117,6 +121,20 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
     }
     assert(m.genus()*2 == (int)generators.size());
 
+    // path from a vertex to the root, along the tree (read only access to m)
+    const AbstractPolygonMesh<M,V,E,P> & cm = m;
+    auto path_to_root = [&](const uint vid, std::vector<uint> & path)
+    {
+        path.clear();
+        double len = 0.0;
+        for(int curr=vid; curr!=-1; curr=prev.at(curr))
+        {
+            if(!path.empty()) len += cm.vert(path.back()).dist(cm.vert(curr));
+            path.push_back(curr);
+        }
+        return len;
+    };
+
     // Start from each such edge, and close a loop with its two endpoints
     basis.clear();
     double length = 0.0;
@@ -124,8 +142,8 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
     {
         std::vector<uint> e0_to_root, e1_to_root;
         length += m.edge_length(eid);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, e0_to_root);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, e1_to_root);
+        length += path_to_root(m.edge_vert_id(eid,0), e0_to_root);
+        length += path_to_root(m.edge_vert_id(eid,1), e1_to_root);
         e1_to_root.pop_back();
         std::reverse(e1_to_root.begin(), e1_to_root.end());
         std::copy(e1_to_root.begin(), e1_to_root.end(), std::back_inserter(e0_to_root));
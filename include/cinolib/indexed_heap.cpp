@@ -0,0 +1,164 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/indexed_heap.h>
+#include <algorithm>
+#include <cassert>
+
+namespace cinolib
+{
+
+template<uint D>
+CINO_INLINE
+void IndexedHeap<D>::resize(const uint n)
+{
+    heap.clear();
+    pos.assign(n, -1);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+void IndexedHeap<D>::clear()
+{
+    for(const auto & item : heap) pos[item.second] = -1;
+    heap.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+void IndexedHeap<D>::push(const uint id, const double key)
+{
+    assert(!contains(id));
+    pos[id] = int(heap.size());
+    heap.push_back(std::make_pair(key,id));
+    sift_up(pos[id]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+void IndexedHeap<D>::decrease(const uint id, const double key)
+{
+    assert(contains(id));
+    assert(key <= heap[pos[id]].first);
+    heap[pos[id]].first = key;
+    sift_up(pos[id]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+void IndexedHeap<D>::update(const uint id, const double key)
+{
+    if(pos[id]<0) push(id, key);
+    else
+    {
+        uint   i   = pos[id];
+        double old = heap[i].first;
+        heap[i].first = key;
+        if(key<old) sift_up(i); else sift_down(i);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+uint IndexedHeap<D>::pop()
+{
+    assert(!empty());
+    uint id = heap.front().second;
+    pos[id] = -1;
+    if(heap.size()>1)
+    {
+        heap.front() = heap.back();
+        pos[heap.front().second] = 0;
+        heap.pop_back();
+        sift_down(0);
+    }
+    else heap.pop_back();
+    return id;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+void IndexedHeap<D>::sift_up(uint i)
+{
+    std::pair<double,uint> item = heap[i];
+    while(i>0)
+    {
+        uint parent = (i-1)/D;
+        if(!(item < heap[parent])) break;
+        heap[i] = heap[parent];
+        pos[heap[i].second] = int(i);
+        i = parent;
+    }
+    heap[i] = item;
+    pos[item.second] = int(i);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+void IndexedHeap<D>::sift_down(uint i)
+{
+    std::pair<double,uint> item = heap[i];
+    uint n = uint(heap.size());
+    while(true)
+    {
+        uint first = D*i+1;
+        if(first>=n) break;
+        uint last = std::min(first+D, n);
+        uint best = first;
+        for(uint c=first+1; c<last; ++c) if(heap[c] < heap[best]) best = c;
+        if(!(heap[best] < item)) break;
+        heap[i] = heap[best];
+        pos[heap[i].second] = int(i);
+        i = best;
+    }
+    heap[i] = item;
+    pos[item.second] = int(i);
+}
+
+}
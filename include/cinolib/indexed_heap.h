@@ -0,0 +1,104 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_INDEXED_HEAP_H
+#define CINO_INDEXED_HEAP_H
+
+#include <cinolib/cino_inline.h>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+/* Min priority queue over a fixed range of integer ids [0,n), implemented as
+ * an implicit D-ary heap with an id-to-position map. Differently from STL
+ * containers, it supports priority update (decrease key) in O(log_D n),
+ * which is the operation at the core of Dijkstra and Fast Marching.
+ * Elements with the same key are extracted by increasing id (i.e. in the
+ * same order as a std::set<std::pair<double,uint>>).
+ *
+ * Memory is allocated when the id range is set, and when the queue grows
+ * beyond its previous maximum size. clear() does not release memory, hence
+ * the same heap can be reused for many searches on the same graph without
+ * allocation overhead.
+*/
+
+namespace cinolib
+{
+
+template<uint D = 4>
+class IndexedHeap
+{
+    public:
+
+        explicit IndexedHeap(const uint n = 0) { resize(n); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void resize(const uint n); // set the range of ids to [0,n) and empty the queue
+        void clear();              // empty the queue, in O(size())
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool   empty()                 const { return heap.empty();               }
+        uint   size()                  const { return uint(heap.size());          }
+        uint   capacity()              const { return uint(pos.size());           }
+        bool   contains(const uint id) const { return pos.at(id) >= 0;            }
+        uint   top()                   const { return heap.front().second;        }
+        double top_key()               const { return heap.front().first;         }
+        double key(const uint id)      const { return heap.at(pos.at(id)).first;  }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void push    (const uint id, const double key); // id must not be in the queue
+        void decrease(const uint id, const double key); // id must be in the queue, with a key >= than the new one
+        void update  (const uint id, const double key); // push, or change the key (in either direction) if id is in the queue
+        uint pop();                                      // removes and returns the id with minimum key
+
+    protected:
+
+        void sift_up  (uint i);
+        void sift_down(uint i);
+
+        std::vector<std::pair<double,uint>> heap; // (key,id) pairs
+        std::vector<int>                    pos;  // position of each id in heap (-1 if not in the queue)
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "indexed_heap.cpp"
+#endif
+
+#endif // CINO_INDEXED_HEAP_H
@@ -43,7 +43,7 @@
 *********************************************************************************/
 #include <cinolib/io/read_STL.h>
 #include <cinolib/io/io_utilities.h>
-#include <map>
+#include <cinolib/spatial_hash.h>
 
 namespace cinolib
 {
@@ -82,8 +82,6 @@ void read_STL(const char         * filename,
         exit(-1);
     }
 
-    std::map<vec3d,uint> vmap;
-
     /* This is a horrible trick to cope with the fact that in Thingi10K
      * binary files start with the header of ASCII files even if they shouldn't.
      * As a result it becomes messy to figure out whether a file is binary or not.
@@ -115,23 +113,8 @@ void read_STL(const char         * filename,
                 if(!eat_double(fp, v.y()))      assert(false && "could not parse y coord");
                 if(!eat_double(fp, v.z()))      assert(false && "could not parse z coord");
 
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = uint(vmap.size());
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(uint(verts.size()));
-                    verts.push_back(v);
-                }
+                tris.push_back(uint(verts.size()));
+                verts.push_back(v);
             }
             if(!seek_keyword(fp, "endloop"))  assert(false && "could not find keyword ENDLOOP");
             if(!seek_keyword(fp, "endfacet")) assert(false && "could not find keyword ENDFACET");
@@ -170,24 +153,9 @@ void read_STL(const char         * filename,
                 float vf[3];
                 if(fread(&vf, sizeof(float), 3, fp)!=3) assert(false && "error reading vertex");
 
-                vec3d v(vf[0], vf[1], vf[2]);                
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = uint(vmap.size());
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(uint(verts.size()));
-                    verts.push_back(v);
-                }
+                vec3d v(vf[0], vf[1], vf[2]);
+                tris.push_back(uint(verts.size()));
+                verts.push_back(v);
             }
 
             // read (and discard) attribute
@@ -196,6 +164,16 @@ void read_STL(const char         * filename,
         }
         fclose(fp);
     }
+
+    if(merge_duplicated_verts)
+    {
+        // STL files store each triangle separately: weld vertices with identical coordinates
+        std::vector<vec3d> unique_verts;
+        std::vector<uint>  old2new;
+        weld_points(verts, 0, unique_verts, old2new);
+        for(uint & vid : tris) vid = old2new.at(vid);
+        verts.swap(unique_verts);
+    }
 }
 
 }
@@ -0,0 +1,325 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/iterative_solvers.h>
+#include <cinolib/parallel_spmv.h>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace cinolib
+{
+
+CINO_INLINE
+bool IterativeSolver::compute(const Eigen::SparseMatrix<double> & A)
+{
+    assert(A.rows() == A.cols());
+    this->A = &A;
+
+    bool success = true;
+    switch(preconditioner)
+    {
+        case NO_PRECONDITIONER: break;
+
+        case JACOBI:
+        {
+            // MINRES requires a positive definite preconditioner,
+            // hence the absolute value of the diagonal is used
+            diag = A.diagonal();
+            for(int i=0; i<diag.size(); ++i)
+            {
+                double d = (method==MINRES) ? std::fabs(diag[i]) : diag[i];
+                diag[i]  = (d!=0) ? 1.0/d : 1.0;
+            }
+            break;
+        }
+
+        case INCOMPLETE_CHOLESKY:
+        {
+            ichol.compute(A);
+            success = (ichol.info() == Eigen::Success);
+            break;
+        }
+
+        case SSOR:
+        {
+            assert(ssor_omega>0 && ssor_omega<2);
+            diag = A.diagonal();
+            for(int i=0; i<diag.size(); ++i) if(diag[i]<=0) success = false;
+            break;
+        }
+
+        case MULTIGRID_V_CYCLE:
+        {
+            success = multigrid.compute(A);
+            break;
+        }
+
+        default: assert(false && "Unknown Preconditioner");
+    }
+
+    // on failure the configured preconditioner is kept, and will be tried
+    // again at the next call to compute() (e.g. with a different matrix)
+    preconditioner_active = success && (preconditioner!=NO_PRECONDITIONER);
+    if(!success)
+    {
+        std::cerr << "WARNING: IterativeSolver could not build the preconditioner. Running unpreconditioned" << std::endl;
+    }
+    return success;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool IterativeSolver::solve(const Eigen::VectorXd & b,
+                                  Eigen::VectorXd & x,
+                            const bool              warm_start) const
+{
+    assert(A!=nullptr && "IterativeSolver: call compute() first");
+    assert(b.size() == A->rows());
+
+    if(!warm_start || x.size()!=b.size()) x = Eigen::VectorXd::Zero(b.size());
+
+    bool converged = false;
+    switch(method)
+    {
+        case CG     : converged = solve_CG(b,x);     break;
+        case MINRES : converged = solve_MINRES(b,x); break;
+        default: assert(false && "Unknown Method");
+    }
+    return converged;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IterativeSolver::apply_preconditioner(const Eigen::VectorXd & r, Eigen::VectorXd & z) const
+{
+    if(!preconditioner_active)
+    {
+        z = r;
+        return;
+    }
+    switch(preconditioner)
+    {
+        case NO_PRECONDITIONER   : z = r; break;
+        case JACOBI              : z = diag.cwiseProduct(r); break;
+        case INCOMPLETE_CHOLESKY : z = ichol.solve(r); break;
+        case SSOR:
+        {
+            // M = w/(2-w) (D/w + L) (D/w)^-1 (D/w + L^T), with L the strictly lower
+            // part of A. Lower entries of row i are read from column i (symmetry)
+            const Eigen::SparseMatrix<double> & M = *A;
+            const double w = ssor_omega;
+            const int    n = int(M.rows());
+            // forward sweep: (D/w + L) y = r
+            z = r;
+            for(int col=0; col<n; ++col)
+            {
+                z[col] *= w/diag[col];
+                for(Eigen::SparseMatrix<double>::InnerIterator it(M,col); it; ++it)
+                {
+                    if(it.index()>col) z[it.index()] -= it.value() * z[col];
+                }
+            }
+            // scaling: (D/w) y
+            for(int i=0; i<n; ++i) z[i] *= diag[i]/w;
+            // backward sweep: (D/w + L^T) z = y
+            for(int col=n-1; col>=0; --col)
+            {
+                double sum = z[col];
+                for(Eigen::SparseMatrix<double>::InnerIterator it(M,col); it; ++it)
+                {
+                    if(it.index()>col) sum -= it.value() * z[it.index()];
+                }
+                z[col] = sum * w/diag[col];
+            }
+            z *= (2.0-w)/w;
+            break;
+        }
+        case MULTIGRID_V_CYCLE:
+        {
+            z = Eigen::VectorXd::Zero(r.size());
+            multigrid.v_cycle(r,z);
+            break;
+        }
+        default: assert(false && "Unknown Preconditioner");
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool IterativeSolver::solve_CG(const Eigen::VectorXd & b, Eigen::VectorXd & x) const
+{
+    const double b_norm = b.norm();
+    if(b_norm==0)
+    {
+        x.setZero();
+        last_iters = 0;
+        last_error = 0;
+        return true;
+    }
+
+    const uint max_iters = (max_iterations>0) ? max_iterations : uint(2*b.size());
+
+    Eigen::VectorXd r, z, p, q;
+    parallel_symmetric_spmv(*A,x,q);
+    r = b - q;
+    last_iters = 0;
+    last_error = r.norm()/b_norm;
+    if(last_error<tolerance) return true;
+
+    apply_preconditioner(r,z);
+    p = z;
+    double rz = r.dot(z);
+
+    while(last_iters<max_iters)
+    {
+        parallel_symmetric_spmv(*A,p,q);
+        double alpha = rz / p.dot(q);
+        x += alpha * p;
+        r -= alpha * q;
+        ++last_iters;
+
+        last_error = r.norm()/b_norm;
+        if(last_error<tolerance) return true;
+
+        apply_preconditioner(r,z);
+        double rz_new = r.dot(z);
+        double beta   = rz_new / rz;
+        rz = rz_new;
+        p  = z + beta * p;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool IterativeSolver::solve_MINRES(const Eigen::VectorXd & b, Eigen::VectorXd & x) const
+{
+    // Preconditioned MINRES (Paige and Saunders 1975). The residual is not
+    // available at each iteration, hence the stopping criterion is based on
+    // its estimate in the norm induced by the preconditioner. The true
+    // relative residual is computed at the end of the solve
+    const double b_norm = b.norm();
+    if(b_norm==0)
+    {
+        x.setZero();
+        last_iters = 0;
+        last_error = 0;
+        return true;
+    }
+
+    const uint max_iters = (max_iterations>0) ? max_iterations : uint(2*b.size());
+    const int  n = int(b.size());
+
+    Eigen::VectorXd r1, r2, y, v, w, w1, w2;
+    parallel_symmetric_spmv(*A,x,y);
+    r1 = b - y;
+    r2 = r1;
+    apply_preconditioner(r1,y);
+
+    double beta1 = r1.dot(y);
+    assert(beta1>=0 && "MINRES: preconditioner is not positive definite");
+    beta1 = std::sqrt(beta1);
+
+    double b_pnorm = beta1; // |b| in the preconditioner norm (if x=0)
+    {
+        Eigen::VectorXd tmp;
+        apply_preconditioner(b,tmp);
+        b_pnorm = std::sqrt(std::fabs(b.dot(tmp)));
+    }
+
+    double oldb   = 0;
+    double beta   = beta1;
+    double dbar   = 0;
+    double epsln  = 0;
+    double phibar = beta1;
+    double cs     = -1;
+    double sn     = 0;
+    w  = Eigen::VectorXd::Zero(n);
+    w2 = Eigen::VectorXd::Zero(n);
+
+    last_iters = 0;
+    bool converged = (beta1==0 || phibar/b_pnorm<tolerance);
+
+    while(!converged && last_iters<max_iters)
+    {
+        ++last_iters;
+
+        // Lanczos step
+        v = y / beta;
+        parallel_symmetric_spmv(*A,v,y);
+        if(last_iters>=2) y -= (beta/oldb) * r1;
+        double alfa = v.dot(y);
+        y -= (alfa/beta) * r2;
+        r1.swap(r2);
+        r2.swap(y);
+        apply_preconditioner(r2,y);
+        oldb = beta;
+        beta = r2.dot(y);
+        assert(beta>=0 && "MINRES: preconditioner is not positive definite");
+        beta = std::sqrt(beta);
+
+        // QR factorization of the tridiagonal matrix (Givens rotations)
+        double oldeps = epsln;
+        double delta  = cs*dbar + sn*alfa;
+        double gbar   = sn*dbar - cs*alfa;
+        epsln = sn*beta;
+        dbar  = -cs*beta;
+        double gamma = std::max(std::hypot(gbar,beta), std::numeric_limits<double>::epsilon());
+        cs = gbar/gamma;
+        sn = beta/gamma;
+        double phi = cs*phibar;
+        phibar = sn*phibar;
+
+        // update the solution
+        w1.swap(w2);
+        w2.swap(w);
+        w = (v - oldeps*w1 - delta*w2) / gamma;
+        x += phi * w;
+
+        if(phibar/b_pnorm<tolerance || beta==0) converged = true;
+    }
+
+    parallel_symmetric_spmv(*A,x,y);
+    last_error = (b-y).norm()/b_norm;
+    return converged;
+}
+
+}
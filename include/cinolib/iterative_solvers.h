@@ -0,0 +1,165 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_ITERATIVE_SOLVERS_H
+#define CINO_ITERATIVE_SOLVERS_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/multigrid.h>
+#include <sys/types.h>
+#include <Eigen/Sparse>
+
+namespace cinolib
+{
+
+/* Preconditioned Krylov solvers for large sparse symmetric systems, for
+ * which direct factorizations would require too much memory (e.g. Laplacians
+ * of tet meshes with tens of millions of vertices). Memory consumption is
+ * linear in the size of the system. Two methods are available:
+ *
+ *  - CG     : conjugate gradient, for symmetric positive definite matrices
+ *  - MINRES : minimum residual, for symmetric (possibly indefinite) matrices
+ *
+ * with three preconditioners:
+ *
+ *  - JACOBI              : diagonal scaling (MINRES uses absolute values)
+ *  - INCOMPLETE_CHOLESKY : Eigen's IncompleteCholesky (with AMD ordering). It
+ *                          requires a positive definite matrix
+ *  - SSOR                : symmetric successive over relaxation (symmetric
+ *                          Gauss-Seidel for omega = 1). It requires a positive
+ *                          diagonal
+ *  - MULTIGRID_V_CYCLE   : a V-cycle of algebraic multigrid (see multigrid.h).
+ *                          Iterations do not grow with the size of the system,
+ *                          but it requires a positive (semi)definite matrix
+ *
+ * Matrix-vector products are multithreaded (see parallel_spmv.h). Jacobi and
+ * multigrid preconditioners are multithreaded as well, whereas incomplete
+ * Cholesky and SSOR are applied serially. Iterations stop when the relative residual
+ * |b-Ax|/|b| goes below the tolerance, or when the iteration budget is over.
+ * solve() can be warm started, using the content of x as initial guess: this
+ * is the typical use case of iterative procedures (e.g. time integration,
+ * interactive editing) where the solution changes little between solves.
+ *
+ * The same solvers are also exposed as solver types of solve_square_system
+ * and solve_square_system_with_bc (see linear_solvers.h), with default
+ * parameters and no warm start.
+ *
+ * NOTE: the solver keeps a pointer to the matrix passed to compute(), which
+ * must therefore outlive it (same as Eigen's iterative solvers). Although
+ * solve() is const, it records the statistics of the last solve (see
+ * iterations and error), hence the same solver must not be used by multiple
+ * threads at once.
+*/
+
+enum
+{
+    CG,
+    MINRES,
+};
+
+enum
+{
+    NO_PRECONDITIONER,
+    JACOBI,
+    INCOMPLETE_CHOLESKY,
+    SSOR,
+    MULTIGRID_V_CYCLE,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class IterativeSolver
+{
+    public:
+
+        explicit IterativeSolver(const int method = CG, const int preconditioner = JACOBI)
+            : method(method), preconditioner(preconditioner) {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        double tolerance      = 1e-10; // on the relative residual |b-Ax|/|b|
+        uint   max_iterations = 0;     // 0 means 2 * system size
+        double ssor_omega     = 1.0;   // relaxation factor, in (0,2)
+
+        // changing them requires a new call to compute()
+        void set_method        (const int m) { method = m;         }
+        void set_preconditioner(const int p) { preconditioner = p; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // sets the matrix and computes the preconditioner. Returns false if
+        // the preconditioner could not be built (e.g. the matrix is not positive
+        // definite), in which case the solver will run unpreconditioned until
+        // the next call to compute()
+        bool compute(const Eigen::SparseMatrix<double> & A);
+
+        // solves A x = b. If warm_start is true and x has the right size, the
+        // content of x is used as initial guess. Returns true if converged
+        bool solve(const Eigen::VectorXd & b,
+                         Eigen::VectorXd & x,
+                   const bool              warm_start = false) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool   is_preconditioned() const { return preconditioner_active; } // since the last compute()
+        uint   iterations()        const { return last_iters; }            // of the last solve
+        double error()             const { return last_error; }            // relative residual of the last solve
+
+    protected:
+
+        void apply_preconditioner(const Eigen::VectorXd & r, Eigen::VectorXd & z) const;
+
+        bool solve_CG    (const Eigen::VectorXd & b, Eigen::VectorXd & x) const;
+        bool solve_MINRES(const Eigen::VectorXd & b, Eigen::VectorXd & x) const;
+
+        int                                     method;
+        int                                     preconditioner;
+        bool                                    preconditioner_active = false; // false if it could not be built
+        const Eigen::SparseMatrix<double>     * A = nullptr;
+        Eigen::VectorXd                         diag; // JACOBI: inverse diagonal. SSOR: diagonal
+        Eigen::IncompleteCholesky<double,Eigen::Lower,Eigen::AMDOrdering<int>> ichol;
+        MultigridSolver                         multigrid;
+
+        mutable uint   last_iters = 0;
+        mutable double last_error = 0.0;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "iterative_solvers.cpp"
+#endif
+
+#endif // CINO_ITERATIVE_SOLVERS_H
@@ -0,0 +1,168 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/kdtree.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <numeric>
+
+namespace cinolib
+{
+
+namespace
+{
+// ranges smaller than this are scanned linearly
+static const uint KDTREE_LEAF_SIZE = 8;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::build(const std::vector<vec3d> & points)
+{
+    pts  = points;
+    ids.resize(points.size());
+    axis.assign(points.size(), 0);
+    std::iota(ids.begin(), ids.end(), 0);
+    build(0, size());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::build(const uint beg, const uint end)
+{
+    if(end-beg <= KDTREE_LEAF_SIZE) return;
+
+    vec3d min = pts.at(beg);
+    vec3d max = pts.at(beg);
+    for(uint i=beg+1; i<end; ++i)
+    {
+        min = min.min(pts.at(i));
+        max = max.max(pts.at(i));
+    }
+    vec3d   delta = max - min;
+    uint8_t a     = (delta[0]>=delta[1] && delta[0]>=delta[2]) ? 0 : (delta[1]>=delta[2]) ? 1 : 2;
+
+    // partition the (point,id) pairs around the median along the chosen axis
+    std::vector<uint> order(end-beg);
+    std::iota(order.begin(), order.end(), beg);
+    uint mid = beg + (end-beg)/2;
+    std::nth_element(order.begin(), order.begin()+(mid-beg), order.end(), [&](const uint i, const uint j)
+    {
+        return pts.at(i)[a] < pts.at(j)[a];
+    });
+    std::vector<vec3d> tmp_pts(end-beg);
+    std::vector<uint>  tmp_ids(end-beg);
+    for(uint i=0; i<order.size(); ++i)
+    {
+        tmp_pts.at(i) = pts.at(order.at(i));
+        tmp_ids.at(i) = ids.at(order.at(i));
+    }
+    std::copy(tmp_pts.begin(), tmp_pts.end(), pts.begin()+beg);
+    std::copy(tmp_ids.begin(), tmp_ids.end(), ids.begin()+beg);
+    axis.at(mid) = a;
+
+    build(beg, mid);
+    build(mid+1, end);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::clear()
+{
+    pts.clear();
+    ids.clear();
+    axis.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int KdTree::closest_point(const vec3d                     & p,
+                          const std::function<bool(uint)> & filter,
+                                double                    * dist) const
+{
+    int    best_id   = -1;
+    double best_dist = inf_double;
+    closest_point(p, filter, 0, size(), best_id, best_dist);
+    if(dist!=nullptr) *dist = best_dist;
+    return best_id;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::closest_point(const vec3d                     & p,
+                           const std::function<bool(uint)> & filter,
+                           const uint                        beg,
+                           const uint                        end,
+                                 int                       & best_id,
+                                 double                    & best_dist) const
+{
+    auto visit = [&](const uint i)
+    {
+        double d = p.dist_sqrd(pts[i]);
+        if(d>best_dist || (d==best_dist && int(ids[i])>best_id)) return;
+        if(filter && !filter(ids[i])) return;
+        best_id   = int(ids[i]);
+        best_dist = d;
+    };
+
+    if(end-beg <= KDTREE_LEAF_SIZE)
+    {
+        for(uint i=beg; i<end; ++i) visit(i);
+        return;
+    }
+
+    uint   mid  = beg + (end-beg)/2;
+    double diff = p[axis[mid]] - pts[mid][axis[mid]];
+
+    // descend the side containing p first, then the other side and the median
+    // only if the splitting plane is not farther than the current best (using
+    // <= so that ties can still be broken by id)
+    if(diff<0) closest_point(p, filter, beg, mid, best_id, best_dist);
+    else       closest_point(p, filter, mid+1, end, best_id, best_dist);
+
+    if(diff*diff <= best_dist)
+    {
+        visit(mid);
+        if(diff<0) closest_point(p, filter, mid+1, end, best_id, best_dist);
+        else       closest_point(p, filter, beg, mid, best_id, best_dist);
+    }
+}
+
+}
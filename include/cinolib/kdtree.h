@@ -0,0 +1,103 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_KDTREE_H
+#define CINO_KDTREE_H
+
+#include <cinolib/geometry/vec_mat.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Static 3D kd-tree of points, used to answer nearest neighbor queries in
+ * logarithmic time (e.g. for mouse picking). The tree is implicit: points are
+ * stored in a single array, recursively partitioned around the median along
+ * the axis of largest extent, and no node is ever allocated. Queries can be
+ * restricted to a subset of the points with a filter function, which is
+ * evaluated lazily, only on the points actually visited by the search.
+*/
+
+class KdTree
+{
+    public:
+
+        explicit KdTree() {}
+        explicit KdTree(const std::vector<vec3d> & points) { build(points); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void build(const std::vector<vec3d> & points);
+        void clear();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint size()  const { return uint(pts.size()); }
+        bool empty() const { return pts.empty(); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns the id of the point closest to p (-1 if the tree is empty, or
+        // if no point passes the filter). Ties are broken by smallest id. If
+        // dist is not null, it is set to the (squared) distance from p
+        int closest_point(const vec3d                     & p,
+                          const std::function<bool(uint)> & filter = nullptr,
+                                double                    * dist   = nullptr) const;
+
+    protected:
+
+        void build(const uint beg, const uint end);
+
+        void closest_point(const vec3d                     & p,
+                           const std::function<bool(uint)> & filter,
+                           const uint                        beg,
+                           const uint                        end,
+                                 int                       & best_id,
+                                 double                    & best_dist) const;
+
+        std::vector<vec3d>   pts;   // points, in tree order
+        std::vector<uint>    ids;   // original id of each point
+        std::vector<uint8_t> axis;  // split axis of each inner node (i.e. median)
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "kdtree.cpp"
+#endif
+
+#endif // CINO_KDTREE_H
@@ -35,6 +35,7 @@
 *********************************************************************************/
 #include <cinolib/laplacian.h>
 #include <cinolib/symbols.h>
+#include <cinolib/operator_assembler.h>
 #include <Eigen/Sparse>
 
 namespace cinolib
@@ -87,12 +88,11 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 Eigen::SparseMatrix<double> laplacian(const AbstractMesh<M,V,E,P> & m, const int mode, const int n)
 {
-    std::vector<Entry> entries = laplacian_matrix_entries(m, mode, n);
-
-    uint nv = n*m.num_verts();
-    Eigen::SparseMatrix<double> L(nv,nv);
-    L.setFromTriplets(entries.begin(), entries.end());
-
+    // direct (parallel) assembly in compressed format. Same output as
+    // assembling the matrix from laplacian_matrix_entries
+    Eigen::SparseMatrix<double> L;
+    OperatorAssembler assembler;
+    assembler.laplacian(m, mode, L, n);
     return L;
 }
 
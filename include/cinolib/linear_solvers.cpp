@@ -35,6 +35,8 @@
 *********************************************************************************/
 #include <cinolib/linear_solvers.h>
 #include <cinolib/stl_container_utilities.h>
+#include <iostream>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -43,6 +45,168 @@ typedef Eigen::Triplet<double> Entry;
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+bool is_iterative_solver(const int solver)
+{
+    return (solver>=CG_JACOBI && solver<=MINRES_SSOR) || solver==CG_MULTIGRID;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void setup_iterative_solver(const int solver, IterativeSolver & it)
+{
+    switch(solver)
+    {
+        case CG_JACOBI                  : it.set_method(CG);     it.set_preconditioner(JACOBI);              break;
+        case CG_INCOMPLETE_CHOLESKY     : it.set_method(CG);     it.set_preconditioner(INCOMPLETE_CHOLESKY); break;
+        case CG_SSOR                    : it.set_method(CG);     it.set_preconditioner(SSOR);                break;
+        case CG_MULTIGRID               : it.set_method(CG);     it.set_preconditioner(MULTIGRID_V_CYCLE);   break;
+        case MINRES_JACOBI              : it.set_method(MINRES); it.set_preconditioner(JACOBI);              break;
+        case MINRES_INCOMPLETE_CHOLESKY : it.set_method(MINRES); it.set_preconditioner(INCOMPLETE_CHOLESKY); break;
+        case MINRES_SSOR                : it.set_method(MINRES); it.set_preconditioner(SSOR);                break;
+        default: assert(false && "Not an iterative solver");
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SparseFactorization::compute(const Eigen::SparseMatrix<double> & A)
+{
+    assert(A.rows() == A.cols());
+
+    if(!A.isCompressed())
+    {
+        Eigen::SparseMatrix<double> Ac = A;
+        Ac.makeCompressed();
+        return compute(Ac);
+    }
+
+    if(!has_symbolic_phase())
+    {
+        A_copy   = A;
+        is_ready = true;
+        ++n_factorizations;
+        return true;
+    }
+
+    if(!same_pattern(A))
+    {
+        switch(solver)
+        {
+            case SIMPLICIAL_LLT  : llt.analyzePattern(A);  break;
+            case SIMPLICIAL_LDLT : ldlt.analyzePattern(A); break;
+            case SparseLU        : lu.analyzePattern(A);   break;
+        }
+        outer.assign(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1);
+        inner.assign(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros());
+        ++n_analyses;
+    }
+    return refactorize(A);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SparseFactorization::refactorize(const Eigen::SparseMatrix<double> & A)
+{
+    if(!has_symbolic_phase()) return compute(A);
+    assert(n_analyses>0 && "SparseFactorization: no pattern has been analyzed yet");
+
+    Eigen::ComputationInfo info = Eigen::Success;
+    switch(solver)
+    {
+        case SIMPLICIAL_LLT  : llt.factorize(A);  info = llt.info();  break;
+        case SIMPLICIAL_LDLT : ldlt.factorize(A); info = ldlt.info(); break;
+        case SparseLU        :
+        {
+            if(A.isCompressed()) lu.factorize(A);
+            else
+            {
+                Eigen::SparseMatrix<double> Ac = A;
+                Ac.makeCompressed();
+                lu.factorize(Ac);
+            }
+            info = lu.info();
+            break;
+        }
+    }
+    ++n_factorizations;
+    is_ready = (info == Eigen::Success);
+    assert(is_ready);
+    return is_ready;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseFactorization::clear()
+{
+    outer.clear();
+    inner.clear();
+    A_copy   = Eigen::SparseMatrix<double>();
+    is_ready = false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseFactorization::set_solver(const int solver)
+{
+    if(solver == this->solver) return;
+    this->solver = solver;
+    clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseFactorization::solve(const Eigen::VectorXd & b, Eigen::VectorXd & x) const
+{
+    assert(is_ready);
+    switch(solver)
+    {
+        case SIMPLICIAL_LLT  : x = llt.solve(b);  break;
+        case SIMPLICIAL_LDLT : x = ldlt.solve(b); break;
+        case SparseLU        : x = lu.solve(b);   break;
+        default              : solve_square_system(A_copy, b, x, solver);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+Eigen::VectorXd SparseFactorization::solve(const Eigen::VectorXd & b) const
+{
+    Eigen::VectorXd x;
+    solve(b,x);
+    return x;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SparseFactorization::has_symbolic_phase() const
+{
+    return solver==SIMPLICIAL_LLT || solver==SIMPLICIAL_LDLT || solver==SparseLU;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SparseFactorization::same_pattern(const Eigen::SparseMatrix<double> & A) const
+{
+    return  n_analyses>0                                                  &&
+            outer.size() == size_t(A.outerSize()+1)                       &&
+            inner.size() == size_t(A.nonZeros())                          &&
+            A.innerSize() == A.outerSize()                                &&
+            std::equal(outer.begin(), outer.end(), A.outerIndexPtr())     &&
+            std::equal(inner.begin(), inner.end(), A.innerIndexPtr());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void solve_square_system(const Eigen::SparseMatrix<double> & A,
                          const Eigen::VectorXd             & b,
@@ -91,6 +255,36 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
             break;
         }
 
+        case CG_JACOBI:
+        case CG_INCOMPLETE_CHOLESKY:
+        case CG_SSOR:
+        case MINRES_JACOBI:
+        case MINRES_INCOMPLETE_CHOLESKY:
+        case MINRES_SSOR:
+        case CG_MULTIGRID:
+        {
+            IterativeSolver it;
+            setup_iterative_solver(solver, it);
+            it.compute(A);
+            if(!it.solve(b,x))
+            {
+                std::cerr << "WARNING: " << txt[solver] << " did not converge (relative residual: " << it.error() << ")" << std::endl;
+            }
+            break;
+        }
+
+        case MULTIGRID:
+        {
+            MultigridSolver mg;
+            bool ok = mg.compute(A);
+            assert(ok); (void)ok;
+            if(!mg.solve(b,x))
+            {
+                std::cerr << "WARNING: " << txt[solver] << " did not converge (relative residual: " << mg.error() << ")" << std::endl;
+            }
+            break;
+        }
+
         default: assert(false && "Unknown Solver");
     }
 }
@@ -98,87 +292,261 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
-                                 const Eigen::VectorXd             & b,
-                                       Eigen::VectorXd             & x,
-                                 const std::map<uint,double>       & bc, // Dirichlet boundary conditions
-                                 int   solver)
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd             & b,
+                               Eigen::VectorXd             & x,
+                               SparseFactorization         & f)
+{
+    f.compute(A);
+    f.solve(b,x);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PrefactoredSystem::factorize(const Eigen::SparseMatrix<double> & A,
+                                  const std::vector<uint>           & constrained,
+                                  const int                           solver)
 {
-    std::vector<int> col_map(A.rows(), 0);
-    for(const auto & obj : bc)
+    assert(A.rows() == A.cols());
+
+    this->solver = solver;
+    partition(uint(A.rows()), constrained);
+    split(A, A_ff, A_fc);
+    factorize_reduced();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool PrefactoredSystem::update(const Eigen::SparseMatrix<double> & A,
+                               const std::vector<uint>           & constrained,
+                               const int                           solver)
+{
+    assert(A.rows() == A.cols());
+
+    if(!is_ready || solver != this->solver || constrained != this->constrained || A.rows() != size())
     {
-        col_map[obj.first] = -1;
+        factorize(A, constrained, solver);
+        return true;
     }
-    uint fresh_id = 0;
-    for(uint col=0; col<A.cols(); ++col)
+
+    // same partition: compare the blocks of A with the ones already factorized
+    Eigen::SparseMatrix<double> ff, fc;
+    split(A, ff, fc);
+    auto same = [](const Eigen::SparseMatrix<double> & X, const Eigen::SparseMatrix<double> & Y)
     {
-        if(col_map.at(col)==0)
-        {
-            col_map[col] = fresh_id++;
-        }
-    }
+        return X.nonZeros() == Y.nonZeros()                                                        &&
+               std::equal(X.outerIndexPtr(), X.outerIndexPtr() + X.outerSize()+1, Y.outerIndexPtr()) &&
+               std::equal(X.innerIndexPtr(), X.innerIndexPtr() + X.nonZeros(),    Y.innerIndexPtr()) &&
+               std::equal(X.valuePtr(),      X.valuePtr()      + X.nonZeros(),    Y.valuePtr());
+    };
+    if(same(ff, A_ff) && same(fc, A_fc)) return false;
+
+    A_ff.swap(ff);
+    A_fc.swap(fc);
+    factorize_reduced();
+    return true;
+}
 
-    uint size = uint(A.rows() - bc.size());
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    std::vector<Entry> Aprime_entries;
-    Eigen::VectorXd    bprime(size);
+CINO_INLINE
+void PrefactoredSystem::partition(const uint n_vars, const std::vector<uint> & constrained)
+{
+    this->constrained = constrained;
 
-    for(uint row=0; row<A.rows(); ++row)
+    col_map.assign(n_vars, 0);
+    for(uint i=0; i<constrained.size(); ++i) col_map.at(constrained.at(i)) = -1-int(i);
+    free.clear();
+    free.reserve(n_vars - constrained.size());
+    for(uint i=0; i<n_vars; ++i)
     {
-        if (col_map[row] >= 0)
-        {
-            bprime[ col_map[row] ] = b[row];
-        }
+        if(col_map.at(i) < 0) continue;
+        col_map.at(i) = int(free.size());
+        free.push_back(i);
     }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PrefactoredSystem::split(const Eigen::SparseMatrix<double> & A,
+                                    Eigen::SparseMatrix<double> & A_ff,
+                                    Eigen::SparseMatrix<double> & A_fc) const
+{
+    // both blocks are filled column by column, in compressed form. Free variables
+    // keep their relative order, hence the rows of each column come out sorted
+    A_ff.resize(free.size(), free.size());
+    A_fc.resize(free.size(), constrained.size());
+    A_ff.reserve(A.nonZeros());
 
-    //
-    // iterate over the non-zero entries
-    // of sparse matrix A
-    //
-    for (uint i=0; i<A.outerSize(); ++i)
+    auto fill = [&](Eigen::SparseMatrix<double> & block, const uint col, const uint src_col)
     {
-        for (Eigen::SparseMatrix<double>::InnerIterator it(A,i); it; ++it)
+        block.startVec(col);
+        for(Eigen::SparseMatrix<double>::InnerIterator it(A,src_col); it; ++it)
         {
-            uint    row = uint(it.row());
-            uint    col = uint(it.col());
-            double val = it.value();
+            int r = col_map[it.row()];
+            if(r >= 0) block.insertBack(r, col) = it.value();
+        }
+    };
+    for(uint i=0; i<free.size();        ++i) fill(A_ff, i, free[i]);
+    for(uint i=0; i<constrained.size(); ++i) fill(A_fc, i, constrained[i]);
+    A_ff.finalize();
+    A_fc.finalize();
+}
 
-            if (col_map[row] < 0) continue;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-            if (col_map[col] < 0)
-            {
-                bprime[ col_map[row] ] -= bc.at(col) * val;
-            }
-            else
-            {
-                Aprime_entries.push_back(Entry(col_map[row], col_map[col], val));
-            }
-        }
+CINO_INLINE
+void PrefactoredSystem::factorize_reduced()
+{
+    is_ready = false;
+
+    Eigen::ComputationInfo info = Eigen::Success;
+    switch(solver)
+    {
+        case SIMPLICIAL_LLT  :
+        case SIMPLICIAL_LDLT :
+        case SparseLU        : direct.set_solver(solver);
+                               if(!direct.compute(A_ff)) info = Eigen::NumericalIssue;
+                               break;
+        case BiCGSTAB        : bicgstab.setTolerance(1e-5);
+                               bicgstab.compute(A_ff);
+                               info = bicgstab.info();
+                               break;
+        case MULTIGRID       : if(!multigrid.compute(A_ff)) info = Eigen::NumericalIssue;
+                               break;
+        default: assert(is_iterative_solver(solver) && "Unknown Solver");
+                 setup_iterative_solver(solver, iterative);
+                 iterative.compute(A_ff);
     }
+    ++n_factorizations;
+    assert(info == Eigen::Success);
+    is_ready = (info == Eigen::Success);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PrefactoredSystem::solve(const Eigen::VectorXd & b,
+                                    Eigen::VectorXd & x)
+{
+    assert(constrained.empty());
+    solve(b, std::map<uint,double>(), x);
+}
 
-    Eigen::SparseMatrix<double> Aprime(size, size);
-    Aprime.setFromTriplets(Aprime_entries.begin(), Aprime_entries.end());
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PrefactoredSystem::solve(const Eigen::VectorXd       & b,
+                              const std::map<uint,double> & bc,
+                                    Eigen::VectorXd       & x)
+{
+    assert(bc.size() == constrained.size());
+    Eigen::MatrixXd bc_vals(constrained.size(), 1);
+    for(uint i=0; i<constrained.size(); ++i) bc_vals(i,0) = bc.at(constrained.at(i));
+
+    Eigen::MatrixXd X;
+    solve(b, bc_vals, X);
+    x = X.col(0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PrefactoredSystem::solve(const Eigen::MatrixXd & B,
+                              const Eigen::MatrixXd & bc,
+                                    Eigen::MatrixXd & X)
+{
+    assert(is_ready);
+    assert(B.rows() == Eigen::Index(size()));
+    assert(bc.rows() == Eigen::Index(constrained.size()) && (constrained.empty() || bc.cols() == B.cols()));
 
-    Eigen::VectorXd tmp_x(size);
+    Eigen::MatrixXd b_f(free.size(), B.cols());
+    for(uint i=0; i<free.size(); ++i) b_f.row(i) = B.row(free.at(i));
+    if(!constrained.empty()) b_f -= A_fc * bc;
 
-    solve_square_system(Aprime, bprime, tmp_x, solver);
+    Eigen::MatrixXd x_f;
+    solve_reduced(b_f, x_f);
 
-    x.resize(A.cols());
-    for(uint col=0; col<A.cols(); ++col)
+    X.resize(B.rows(), B.cols());
+    for(uint i=0; i<free.size();        ++i) X.row(free.at(i))        = x_f.row(i);
+    for(uint i=0; i<constrained.size(); ++i) X.row(constrained.at(i)) = bc.row(i);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PrefactoredSystem::solve_reduced(const Eigen::MatrixXd & b, Eigen::MatrixXd & x)
+{
+    switch(solver)
     {
-        if (col_map[col] >= 0)
+        case SIMPLICIAL_LLT  :
+        case SIMPLICIAL_LDLT :
+        case SparseLU        :
         {
-            x[col] = tmp_x[ col_map[col] ];
+            x.resize(b.rows(), b.cols());
+            for(int i=0; i<b.cols(); ++i) x.col(i) = direct.solve(b.col(i));
+            break;
         }
-        else
+        case BiCGSTAB : x = bicgstab.solve(b); break;
+        default:
         {
-            x[col] = bc.at(col);
+            assert((is_iterative_solver(solver) || solver==MULTIGRID) && "Unknown Solver");
+            bool warm_start = (last_x.rows()==b.rows() && last_x.cols()==b.cols());
+            x.resize(b.rows(), b.cols());
+            for(int i=0; i<b.cols(); ++i)
+            {
+                Eigen::VectorXd xi;
+                if(warm_start) xi = last_x.col(i);
+                bool converged = (solver==MULTIGRID) ? multigrid.solve(b.col(i), xi, warm_start)
+                                                     : iterative.solve(b.col(i), xi, warm_start);
+                if(!converged)
+                {
+                    double err = (solver==MULTIGRID) ? multigrid.error() : iterative.error();
+                    std::cerr << "WARNING: " << txt[solver] << " did not converge (relative residual: " << err << ")" << std::endl;
+                }
+                x.col(i) = xi;
+            }
+            last_x = x;
         }
     }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd             & b,
+                                       Eigen::VectorXd             & x,
+                                 const std::map<uint,double>       & bc, // Dirichlet boundary conditions
+                                 int   solver)
+{
+    PrefactoredSystem sys;
+    solve_square_system_with_bc(A, b, x, bc, sys, solver);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd             & b,
+                                       Eigen::VectorXd             & x,
+                                 const std::map<uint,double>       & bc, // Dirichlet boundary conditions
+                                       PrefactoredSystem           & sys,
+                                 int   solver)
+{
+    std::vector<uint> constrained;
+    constrained.reserve(bc.size());
+    for(const auto & obj : bc) constrained.push_back(obj.first);
+
+    sys.update(A, constrained, solver);
+    sys.solve(b, bc, x);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void solve_least_squares(const Eigen::SparseMatrix<double> & A,
                          const Eigen::VectorXd             & b,
@@ -194,6 +562,21 @@ void solve_least_squares(const Eigen::SparseMatrix<double> & A,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+void solve_least_squares(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd             & b,
+                               Eigen::VectorXd             & x,
+                               SparseFactorization         & f)
+{
+    Eigen::SparseMatrix<double> At  = A.transpose();
+    Eigen::SparseMatrix<double> AtA = At * A;
+    Eigen::VectorXd             Atb = At * b;
+
+    solve_square_system(AtA, Atb, x, f);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void solve_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const Eigen::VectorXd             & b,
@@ -226,6 +609,22 @@ void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
+                                  const Eigen::VectorXd             & w,
+                                  const Eigen::VectorXd             & b,
+                                        Eigen::VectorXd             & x,
+                                        SparseFactorization         & f)
+{
+    Eigen::SparseMatrix<double> At   = A.transpose();
+    Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
+    Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
+
+    solve_square_system(AtWA, AtWb, x, f);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                           const Eigen::VectorXd             & w,
@@ -38,8 +38,10 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/iterative_solvers.h>
 #include <Eigen/Sparse>
 
 namespace cinolib
@@ -56,6 +58,22 @@ namespace cinolib
  * --------------------------------------------------------------
  * BiCGSTAB     none
  * (iterative)
+ * --------------------------------------------------------------
+ * CG_*         positive definite
+ * (iterative)
+ * --------------------------------------------------------------
+ * MINRES_*     symmetric
+ * (iterative)
+ * --------------------------------------------------------------
+ * MULTIGRID    positive semi definite
+ * (iterative)
+ *
+ * CG, MINRES and MULTIGRID are multithreaded and use memory linear in the size
+ * of the system, hence they are the only viable option for very large systems
+ * (see iterative_solvers.h and multigrid.h). For mesh Laplacians, the number of
+ * iterations of MULTIGRID and CG_MULTIGRID does not grow with the mesh size.
+ * Here they run with default tolerance and iteration budget. Use the solver
+ * classes directly to tune them or to warm start them
  */
 
 enum
@@ -64,16 +82,212 @@ enum
     SIMPLICIAL_LDLT,
     SparseLU,
     BiCGSTAB,
+    CG_JACOBI,
+    CG_INCOMPLETE_CHOLESKY,
+    CG_SSOR,
+    MINRES_JACOBI,
+    MINRES_INCOMPLETE_CHOLESKY,
+    MINRES_SSOR,
+    MULTIGRID,
+    CG_MULTIGRID,
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-static const std::string txt[4] =
+static const std::string txt[12] =
 {
     "SIMPLICIAL_LLT"  ,
     "SIMPLICIAL_LDLT" ,
     "SparseLU",
     "BiCGSTAB",
+    "CG_JACOBI",
+    "CG_INCOMPLETE_CHOLESKY",
+    "CG_SSOR",
+    "MINRES_JACOBI",
+    "MINRES_INCOMPLETE_CHOLESKY",
+    "MINRES_SSOR",
+    "MULTIGRID",
+    "CG_MULTIGRID",
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// true for the solvers based on IterativeSolver (CG_* and MINRES_*)
+CINO_INLINE
+bool is_iterative_solver(const int solver);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sets method and preconditioner of the CG_* and MINRES_* solvers
+CINO_INLINE
+void setup_iterative_solver(const int solver, IterativeSolver & it);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Handle to the factorization of a sparse square matrix, meant for iterative
+ * algorithms that solve a sequence of systems with the same sparsity pattern
+ * and changing values (e.g. time steps of a flow, reweighting iterations).
+ * Direct solvers work in two phases: a symbolic analysis of the sparsity
+ * pattern (fill reducing ordering, elimination tree), and the numerical
+ * factorization. compute() keeps a copy of the last analyzed pattern, and
+ * repeats the symbolic analysis only if the pattern of the input matrix is
+ * different. refactorize() skips the pattern check altogether.
+ *
+ * Only SIMPLICIAL_LLT, SIMPLICIAL_LDLT and SparseLU have a symbolic phase.
+ * With all the other solvers the handle keeps a copy of the matrix and
+ * solves with solve_square_system.
+*/
+
+class SparseFactorization
+{
+    public:
+
+        explicit SparseFactorization(const int solver = SIMPLICIAL_LLT) : solver(solver) {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // symbolic analysis (only if the pattern changed) and numerical factorization
+        bool compute(const Eigen::SparseMatrix<double> & A);
+
+        // numerical factorization only. A must have the pattern of the last analyzed matrix
+        bool refactorize(const Eigen::SparseMatrix<double> & A);
+
+        // drops the cached analysis
+        void clear();
+
+        // changes solver (and drops the cached analysis, if it is a different one)
+        void set_solver(const int solver);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void            solve(const Eigen::VectorXd & b, Eigen::VectorXd & x) const;
+        Eigen::VectorXd solve(const Eigen::VectorXd & b) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool ready()              const { return is_ready;         }
+        int  solver_type()        const { return solver;           }
+        uint num_analyses()       const { return n_analyses;       } // symbolic analyses done so far
+        uint num_factorizations() const { return n_factorizations; } // numerical factorizations done so far
+
+    protected:
+
+        bool has_symbolic_phase() const;
+        bool same_pattern(const Eigen::SparseMatrix<double> & A) const;
+
+        int                         solver;
+        bool                        is_ready         = false;
+        uint                        n_analyses       = 0;
+        uint                        n_factorizations = 0;
+        std::vector<int>            outer, inner; // pattern of the last analyzed matrix (compressed)
+        Eigen::SparseMatrix<double> A_copy;       // solvers without symbolic phase
+
+        Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>                          llt;
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>                         ldlt;
+        Eigen::SparseLU<Eigen::SparseMatrix<double>,Eigen::COLAMDOrdering<int>>     lu;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* A square sparse system A x = b, subject to Dirichlet boundary conditions
+ * on a fixed set of variables, with all the work that does not depend on the
+ * right hand side or on the boundary values done once, in factorize().
+ * Constrained variables are moved to the right hand side, as done in
+ * solve_square_system_with_bc: the matrix is split into the block acting on
+ * the free variables (A_ff), which is factorized, and the block coupling them
+ * with the constrained ones (A_fc). Each solve then costs a sparse matrix
+ * vector product and the triangular solves (or, for BiCGSTAB, the iterations).
+ * With the iterative solvers CG_*, MINRES_* and MULTIGRID only the preconditioner
+ * (or the multigrid hierarchy) is computed upfront. Each solve is warm started
+ * with the solution of the previous one, which is typically close to the
+ * new one when the system is solved repeatedly (e.g. interactive editing).
+ * For this reason solve() is not const: the system keeps state across solves,
+ * and must not be solved concurrently from multiple threads.
+ *
+ * update() can be called before each solve with the current matrix and
+ * constraints: it compares them with the ones of the last factorization and
+ * factorizes again only if something changed. If only the numerical values
+ * of the matrix changed, direct solvers skip the symbolic analysis (see
+ * SparseFactorization).
+ *
+ * Example: interactive deformation with fixed handles and moving targets
+ *
+ *     PrefactoredSystem sys;
+ *     ...
+ *     sys.update(A, handles);   // partition, assembly of A_ff/A_fc and factorization
+ *     sys.solve(b, bc, x);
+ *     ...
+ *     sys.update(A, handles);   // nothing to do
+ *     sys.solve(b, bc_new, x);  // mat-vec and back substitution only
+*/
+
+class PrefactoredSystem
+{
+    public:
+
+        explicit PrefactoredSystem() {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void factorize(const Eigen::SparseMatrix<double> & A,
+                       const std::vector<uint>           & constrained = {}, // ids of the Dirichlet variables
+                       const int                           solver = SIMPLICIAL_LLT);
+
+        // factorizes only if A, the constrained variables or the solver differ from
+        // the ones of the last factorization. Returns true if it factorized
+        bool update(const Eigen::SparseMatrix<double> & A,
+                    const std::vector<uint>           & constrained = {},
+                    const int                           solver = SIMPLICIAL_LLT);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool                      ready()              const { return is_ready;         }
+        uint                      size()               const { return uint(col_map.size()); }
+        int                       solver_type()        const { return solver;           }
+        const std::vector<uint> & constrained_vars()   const { return constrained;      }
+        uint                      num_factorizations() const { return n_factorizations; } // done so far
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // no constrained variables
+        void solve(const Eigen::VectorXd & b,
+                         Eigen::VectorXd & x);
+
+        // bc must contain a value for each (and only for) the constrained variables
+        void solve(const Eigen::VectorXd       & b,
+                   const std::map<uint,double> & bc,
+                         Eigen::VectorXd       & x);
+
+        // multiple right hand sides, one per column. Boundary values are given
+        // as a matrix with a row for each constrained variable (in the order of
+        // constrained_vars()) and a column for each right hand side
+        void solve(const Eigen::MatrixXd & B,
+                   const Eigen::MatrixXd & bc,
+                         Eigen::MatrixXd & X);
+
+    protected:
+
+        void partition(const uint n_vars, const std::vector<uint> & constrained);
+        void split(const Eigen::SparseMatrix<double> & A,
+                         Eigen::SparseMatrix<double> & A_ff,
+                         Eigen::SparseMatrix<double> & A_fc) const;
+        void factorize_reduced();
+        void solve_reduced(const Eigen::MatrixXd & b, Eigen::MatrixXd & x);
+
+        bool                        is_ready         = false;
+        int                         solver           = SIMPLICIAL_LLT;
+        uint                        n_factorizations = 0;
+        std::vector<uint>           constrained;
+        std::vector<uint>           free;
+        std::vector<int>            col_map; // free vars: index in A_ff. Constrained vars: -1-(index in constrained)
+        Eigen::SparseMatrix<double> A_ff;
+        Eigen::SparseMatrix<double> A_fc;
+        Eigen::MatrixXd             last_x; // warm start for the iterative solvers
+
+        SparseFactorization                                                        direct; // LLT, LDLT, LU
+        Eigen::BiCGSTAB<Eigen::SparseMatrix<double>,Eigen::IncompleteLUT<double>>  bicgstab;
+        IterativeSolver                                                            iterative;
+        MultigridSolver                                                            multigrid;
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -86,6 +300,15 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// reuses the symbolic analysis of f, if the sparsity pattern of A did not change
+CINO_INLINE
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd             & b,
+                               Eigen::VectorXd             & x,
+                               SparseFactorization         & f);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const Eigen::VectorXd             & b,
@@ -95,12 +318,30 @@ void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// reuses the partition and the factorization held by sys, if A, the constrained
+// variables (i.e. the keys of bc) and the solver did not change since the last call
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd             & b,
+                                       Eigen::VectorXd             & x,
+                                 const std::map<uint,double>       & bc, // Dirichlet boundary conditions
+                                       PrefactoredSystem           & sys,
+                                 int   solver = SIMPLICIAL_LLT);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void solve_least_squares(const Eigen::SparseMatrix<double> & A,
                          const Eigen::VectorXd             & b,
                                Eigen::VectorXd             & x,
                          int   solver = SIMPLICIAL_LLT);
 
+CINO_INLINE
+void solve_least_squares(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd             & b,
+                               Eigen::VectorXd             & x,
+                               SparseFactorization         & f);
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
@@ -119,6 +360,13 @@ void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
                                         Eigen::VectorXd             & x,
                                   int   solver = SIMPLICIAL_LLT);
 
+CINO_INLINE
+void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
+                                  const Eigen::VectorXd             & w,
+                                  const Eigen::VectorXd             & b,
+                                        Eigen::VectorXd             & x,
+                                        SparseFactorization         & f);
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
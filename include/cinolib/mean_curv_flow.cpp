@@ -34,9 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/mean_curv_flow.h>
-#include <cinolib/laplacian.h>
+#include <cinolib/operator_assembler.h>
 #include <cinolib/linear_solvers.h>
-#include <cinolib/vertex_mass.h>
 #include <cinolib/symbols.h>
 
 namespace cinolib
@@ -57,8 +56,13 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
     time *= time;
     time *= time_scalar;
 
-    Eigen::SparseMatrix<double> L  = laplacian(m, COTANGENT);
-    Eigen::SparseMatrix<double> MM = mass_matrix(m);
+    // operators are re-assembled at each iteration, re-using their sparsity pattern,
+    // and so is the symbolic analysis of the system matrix
+    OperatorAssembler           assembler;
+    SparseFactorization         LLT(SIMPLICIAL_LLT);
+    Eigen::SparseMatrix<double> L, MM;
+    assembler.laplacian(m, COTANGENT, L);
+    assembler.mass_matrix(m, MM);
 
     for(uint i=1; i<=n_iters; ++i)
     {
@@ -67,7 +71,7 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
         m.center_bbox();        
 
         // backward euler time integration of heat flow equation
-        Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> LLT(MM - time_scalar * L);
+        LLT.compute(MM - time_scalar * L);
 
         uint nv = m.num_verts();
         Eigen::VectorXd x(nv);
@@ -98,8 +102,8 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
 
         if (i<n_iters) // update matrices for the next iteration
         {
-            MM = mass_matrix(m);
-            if (!conformalized) L = laplacian(m, COTANGENT);
+            assembler.mass_matrix(m, MM);
+            if (!conformalized) assembler.laplacian(m, COTANGENT, L);
         }
     }
 
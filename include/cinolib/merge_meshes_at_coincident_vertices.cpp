@@ -36,7 +36,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/merge_meshes_at_coincident_vertices.h>
-#include <cinolib/octree.h>
+#include <cinolib/spatial_hash.h>
 
 namespace cinolib
 {
@@ -47,8 +47,7 @@ void merge_meshes_at_coincident_vertices(const AbstractPolygonMesh<M,V,E,P> & m1
                                          const AbstractPolygonMesh<M,V,E,P> & m2,
                                                AbstractPolygonMesh<M,V,E,P> & res)
 {
-    Octree octree;
-    octree.build_from_mesh_points(m1);
+    SpatialHash grid(m1.vector_verts());
 
     res = m1;
 
@@ -57,12 +56,10 @@ void merge_meshes_at_coincident_vertices(const AbstractPolygonMesh<M,V,E,P> & m1
     {
         vec3d p = m2.vert(vid);
 
-        std::unordered_set<uint> ids;
-        if(octree.contains(p, false, ids))
+        uint id;
+        if(grid.first_within(p, 0, id))
         {
-            // WARNING: I am assuming that the mapping is one to one at most
-            assert(ids.size()==1);
-            vmap[vid] = *ids.begin();
+            vmap[vid] = id;
         }
         else
         {
@@ -95,9 +92,7 @@ void merge_meshes_at_coincident_vertices(const AbstractPolyhedralMesh<M,V,E,F,P>
                                                AbstractPolyhedralMesh<M,V,E,F,P> & res,
                                          const double                              proximity_thresh)
 {
-    Octree o;
-    for(uint vid=0; vid<m1.num_verts(); ++vid) o.push_sphere(vid, m1.vert(vid), proximity_thresh);
-    o.build();
+    SpatialHash grid(m1.vector_verts(), proximity_thresh);
 
     res = m1;
 
@@ -105,12 +100,13 @@ void merge_meshes_at_coincident_vertices(const AbstractPolyhedralMesh<M,V,E,F,P>
     for(uint vid=0; vid<m2.num_verts(); ++vid)
     {
         vec3d p = m2.vert(vid);
-        std::unordered_set<uint> ids;
-        if(o.contains(p, false, ids))
+        std::vector<uint> ids;
+        grid.query_radius(p, proximity_thresh, ids);
+        if(!ids.empty())
         {
             // WARNING: I am assuming that the mapping is one to one at most
             assert(ids.size()==1);
-            vmap[vid] = *ids.begin();
+            vmap[vid] = ids.front();
         }
         else
         {
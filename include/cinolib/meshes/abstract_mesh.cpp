@@ -37,6 +37,7 @@
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/min_max_inf.h>
+#include <cstring>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
@@ -86,6 +87,35 @@ bool AbstractMesh<M,V,E,P>::mesh_is_manifold() const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint64_t AbstractMesh<M,V,E,P>::content_hash() const
+{
+    // 64 bit FNV-1a, processing one word at a time
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const uint64_t w) { h ^= w; h *= 1099511628211ull; };
+    mix(mesh_type());
+    mix(verts.size());
+    for(const vec3d & v : verts)
+    for(int i=0; i<3; ++i)
+    {
+        uint64_t w;
+        std::memcpy(&w, &v[i], sizeof(double));
+        mix(w);
+    }
+    mix(edges.size());
+    for(uint vid : edges) mix(vid);
+    mix(polys.size());
+    for(const auto & p : polys)
+    {
+        mix(p.size());
+        for(uint id : p) mix(id);
+    }
+    return h;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractMesh<M,V,E,P>::clear()
@@ -1419,14 +1449,14 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_vert(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint vid=0; vid<this->num_verts(); ++vid)
+    uint64_t h = content_hash();
+    if(pick_tree_v.size()!=num_verts() || pick_hash_v!=h)
     {
-        if(vert_is_visible(vid)) closest.push_back(std::make_pair(this->vert(vid).dist(p),vid));
+        pick_tree_v.build(verts);
+        pick_hash_v = h;
     }
-    if(closest.empty()) return 0;
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    int vid = pick_tree_v.closest_point(p, [this](const uint vid){ return vert_is_visible(vid); });
+    return (vid>=0) ? uint(vid) : 0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1435,14 +1465,16 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_edge(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint eid=0; eid<this->num_edges(); ++eid)
+    uint64_t h = content_hash();
+    if(pick_tree_e.size()!=num_edges() || pick_hash_e!=h)
     {
-        if(edge_is_visible(eid)) closest.push_back(std::make_pair(this->edge_sample_at(eid, 0.5).dist(p),eid));
+        std::vector<vec3d> midpoints(num_edges());
+        for(uint eid=0; eid<num_edges(); ++eid) midpoints.at(eid) = this->edge_sample_at(eid, 0.5);
+        pick_tree_e.build(midpoints);
+        pick_hash_e = h;
     }
-    if(closest.empty()) return 0;
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    int eid = pick_tree_e.closest_point(p, [this](const uint eid){ return edge_is_visible(eid); });
+    return (eid>=0) ? uint(eid) : 0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1451,14 +1483,16 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_poly(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    uint64_t h = content_hash();
+    if(pick_tree_p.size()!=num_polys() || pick_hash_p!=h)
     {
-        if(!this->poly_data(pid).flags[HIDDEN]) closest.push_back(std::make_pair(this->poly_centroid(pid).dist(p),pid));
+        std::vector<vec3d> centroids(num_polys());
+        for(uint pid=0; pid<num_polys(); ++pid) centroids.at(pid) = this->poly_centroid(pid);
+        pick_tree_p.build(centroids);
+        pick_hash_p = h;
     }
-    if(closest.empty()) return 0;
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    int pid = pick_tree_p.closest_point(p, [this](const uint pid){ return !this->poly_data(pid).flags[HIDDEN]; });
+    return (pid>=0) ? uint(pid) : 0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -36,6 +36,7 @@
 #ifndef CINO_ABSTRACT_MESH_H
 #define CINO_ABSTRACT_MESH_H
 
+#include <cstdint>
 #include <set>
 #include <vector>
 #include <sys/types.h>
@@ -45,6 +46,7 @@
 #include <cinolib/color.h>
 #include <cinolib/symbols.h>
 #include <cinolib/ipair.h>
+#include <cinolib/kdtree.h>
 
 typedef enum
 {
@@ -87,6 +89,12 @@ class AbstractMesh
         std::vector<std::vector<uint>> p2e; // poly to edge adjacency
         std::vector<std::vector<uint>> p2p; // poly to poly adjacency
 
+        // kd-trees for mouse picking, built on demand (see pick_vert, pick_edge, pick_poly).
+        // Each tree is tagged with the content_hash of the mesh it was built from, and is
+        // rebuilt if the mesh changed in any way (e.g. vertices moved through vert())
+        mutable KdTree   pick_tree_v, pick_tree_e, pick_tree_p;
+        mutable uint64_t pick_hash_v = 0, pick_hash_e = 0, pick_hash_p = 0;
+
     public:
 
         typedef M M_type;
@@ -106,6 +114,11 @@ class AbstractMesh
                 bool     mesh_is_volumetric() const;
                 bool     mesh_is_manifold() const;
 
+        // hash of mesh type, vertex positions and connectivity. Data computed from the mesh
+        // can be tagged with it, and be safely reused as long as the hash does not change,
+        // regardless of how (or on which mesh object) the edits were made. Costs O(n)
+        virtual uint64_t content_hash() const;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         virtual void clear();
@@ -208,7 +221,10 @@ class AbstractMesh
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // useful for GUIs with mouse picking
+        // useful for GUIs with mouse picking. Return the visible element closest to p
+        // (using vertices, edge midpoints and poly centroids), or 0 if none is visible.
+        // Queries go through kd-trees which are built on first use and rebuilt when the
+        // mesh changes, therefore picking is not thread safe
         uint pick_vert(const vec3d & p) const;
         uint pick_edge(const vec3d & p) const;
         uint pick_poly(const vec3d & p) const;
@@ -45,6 +45,28 @@
 namespace cinolib
 {
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint64_t AbstractPolyhedralMesh<M,V,E,F,P>::content_hash() const
+{
+    // continue the FNV-1a hash of the base class with faces and windings
+    uint64_t h = AbstractMesh<M,V,E,P>::content_hash();
+    auto mix = [&h](const uint64_t w) { h ^= w; h *= 1099511628211ull; };
+    mix(faces.size());
+    for(const auto & f : faces)
+    {
+        mix(f.size());
+        for(uint vid : f) mix(vid);
+    }
+    for(const auto & w : polys_face_winding)
+    {
+        for(bool b : w) mix(b);
+    }
+    return h;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
@@ -3054,13 +3076,16 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::pick_face(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    uint64_t h = this->content_hash();
+    if(pick_tree_f.size()!=this->num_faces() || pick_hash_f!=h)
     {
-        if(!this->face_data(fid).flags[HIDDEN]) closest.push_back(std::make_pair(this->face_centroid(fid).dist(p),fid));
+        std::vector<vec3d> centroids(this->num_faces());
+        for(uint fid=0; fid<this->num_faces(); ++fid) centroids.at(fid) = this->face_centroid(fid);
+        pick_tree_f.build(centroids);
+        pick_hash_f = h;
     }
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    int fid = pick_tree_f.closest_point(p, [this](const uint fid){ return !this->face_data(fid).flags[HIDDEN]; });
+    return (fid>=0) ? uint(fid) : 0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -66,6 +66,10 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         std::vector<std::vector<uint>> face_triangles; // per face serialized triangulation (e.g., for rendering)
 
+        // kd-tree of face centroids for mouse picking, built on demand (see pick_face)
+        mutable KdTree   pick_tree_f;
+        mutable uint64_t pick_hash_f = 0;
+
     public:
 
         typedef F F_type;
@@ -77,6 +81,8 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         void clear() override;
 
+        uint64_t content_hash() const override; // also accounts for faces and their winding
+
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & faces,
                   const std::vector<std::vector<uint>> & polys,
@@ -171,7 +177,7 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // useful for GUIs with mouse picking
+        // useful for GUIs with mouse picking (see AbstractMesh::pick_vert)
         uint pick_face(const vec3d & p) const;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -34,10 +34,112 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/mst.h>
+#include <cinolib/concurrent_union_find.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
 
 namespace cinolib
 {
 
+namespace
+{
+    // maps a float to an unsigned int with the same ordering (no NaNs)
+    CINO_INLINE
+    uint32_t float_order(const float f)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(float));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // Boruvka on a graph with n_nodes nodes and an arc for each edge id.
+    // ends(eid,u,v) retrieves the nodes connected by edge eid, and returns
+    // false if the edge is not part of the graph
+    template<typename Ends>
+    CINO_INLINE
+    void boruvka(const uint                 n_nodes,
+                 const std::vector<float> & weights,
+                 const Ends               & ends,
+                       std::vector<bool>  & tree)
+    {
+        const uint n_edges = uint(weights.size());
+        const uint64_t none = ~uint64_t(0);
+
+        // (weight,id) packed in a single integer
+        auto key = [&](const uint eid) { return (uint64_t(float_order(weights[eid]))<<32) | eid; };
+
+        std::vector<uint> live;
+        live.reserve(n_edges);
+        for(uint eid=0; eid<n_edges; ++eid)
+        {
+            uint u, v;
+            if(ends(eid,u,v) && u!=v) live.push_back(eid);
+        }
+
+        ConcurrentUnionFind                uf(n_nodes);
+        std::vector<uint>                  root(n_nodes);
+        std::vector<std::atomic<uint64_t>> best(n_nodes); // lightest edge leaving each component
+        std::vector<char>                  in_tree(n_edges, 0);
+
+        const uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+        while(!live.empty())
+        {
+            PARALLEL_FOR(0, n_nodes, 10000, [&](uint i)
+            {
+                root[i] = uf.find(i);
+                best[i].store(none, std::memory_order_relaxed);
+            });
+
+            // internal edges are dropped for good
+            uint n_blocks = std::max(1u, std::min(4*n_threads, uint(live.size()/10000)));
+            std::vector<std::vector<uint>> kept(n_blocks);
+            PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+            {
+                for(size_t i=live.size()*b/n_blocks; i<live.size()*(b+1)/n_blocks; ++i)
+                {
+                    uint eid = live[i], u, v;
+                    ends(eid,u,v);
+                    uint ru = root[u];
+                    uint rv = root[v];
+                    if(ru==rv) continue;
+                    kept[b].push_back(eid);
+                    uint64_t k = key(eid);
+                    for(uint r : {ru,rv})
+                    {
+                        uint64_t curr = best[r].load(std::memory_order_relaxed);
+                        while(k<curr && !best[r].compare_exchange_weak(curr, k, std::memory_order_relaxed));
+                    }
+                }
+            });
+            live.clear();
+            for(const auto & list : kept) live.insert(live.end(), list.begin(), list.end());
+
+            // merge. An edge picked by both its components is added by the one with smaller root
+            PARALLEL_FOR(0, n_nodes, 10000, [&](uint i)
+            {
+                uint64_t k = best[i].load(std::memory_order_relaxed);
+                if(root[i]!=i || k==none) return;
+                uint eid = uint(k & 0xffffffff), u, v;
+                ends(eid,u,v);
+                uint other = (root[u]==i) ? root[v] : root[u];
+                if(other<i && best[other].load(std::memory_order_relaxed)==k) return;
+                in_tree[eid] = 1;
+                uf.unite(i,other);
+            });
+        }
+
+        tree.assign(n_edges, false);
+        for(uint eid=0; eid<n_edges; ++eid) if(in_tree[eid]) tree[eid] = true;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // Implementations of Prim's algorithm for Minimum Spanning Tree Computation
 
 template<class M, class V, class E, class P>
@@ -94,4 +196,46 @@ void MST_on_dual_mask_on_edges(const AbstractPolygonMesh<M,V,E,P> & m,
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_MST_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                const std::vector<float>    & weights,
+                                const std::vector<bool>     & mask, // if mask[e] = true, the tree cannot contain edge e
+                                      std::vector<bool>     & tree)
+{
+    assert(weights.size()==m.num_edges());
+    assert(mask.size()==m.num_edges());
+
+    boruvka(m.num_verts(), weights, [&](uint eid, uint & u, uint & v)
+    {
+        if(mask[eid]) return false;
+        u = m.edge_vert_id(eid,0);
+        v = m.edge_vert_id(eid,1);
+        return true;
+    }, tree);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_MST_on_dual_mask_on_edges(const AbstractPolygonMesh<M,V,E,P> & m,
+                                        const std::vector<float>           & weights,
+                                        const std::vector<bool>            & mask, // if mask[e] = true, the tree cannot connect the two polys that share it
+                                              std::vector<bool>            & tree)
+{
+    assert(weights.size()==m.num_edges());
+    assert(mask.size()==m.num_edges());
+
+    boruvka(m.num_polys(), weights, [&](uint eid, uint & u, uint & v)
+    {
+        if(mask[eid] || m.adj_e2p(eid).size()!=2) return false;
+        u = m.adj_e2p(eid).front();
+        v = m.adj_e2p(eid).back();
+        return true;
+    }, tree);
+}
+
 }
@@ -37,6 +37,7 @@
 #define CINO_MST_H
 
 #include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_mesh.h>
 
 namespace cinolib
 {
@@ -47,6 +48,39 @@ void MST_on_dual_mask_on_edges(const AbstractPolygonMesh<M,V,E,P> & m,
                                const std::vector<float>           & weights,
                                const std::vector<bool>            & mask, // if mask[e] = true, the tree cannot connect the two polys that share it
                                      std::vector<bool>            & tree);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Parallel minimum spanning trees (Boruvka), meant for very large meshes.
+ * At each round every component picks its lightest incident edge, and all
+ * the picked edges are merged at once (with a lock-free union-find). Edges
+ * internal to a component are filtered out of the next rounds, as in
+ * Filter-Kruskal. Ties are broken by edge id: edges are compared by
+ * (weight,id), which is a strict total order, hence the tree is unique and
+ * does not depend on thread scheduling. If the graph is disconnected the
+ * output is a minimum spanning forest. With distinct weights, the output is
+ * the same as the serial version. Otherwise it may differ from it only in
+ * the choice among edges of equal weight
+*/
+
+// spanning tree of the vertices
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_MST_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
+                                const std::vector<float>    & weights,
+                                const std::vector<bool>     & mask, // if mask[e] = true, the tree cannot contain edge e
+                                      std::vector<bool>     & tree);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// spanning tree of the polygons. Dual edges are identified by the (manifold)
+// edge shared by their polygons: tree[e] = true if the dual edge crossing e is in the tree
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_MST_on_dual_mask_on_edges(const AbstractPolygonMesh<M,V,E,P> & m,
+                                        const std::vector<float>           & weights,
+                                        const std::vector<bool>            & mask, // if mask[e] = true, the tree cannot connect the two polys that share it
+                                              std::vector<bool>            & tree);
 }
 
 #ifndef  CINO_STATIC_LIB
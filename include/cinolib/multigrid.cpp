@@ -0,0 +1,338 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/multigrid.h>
+#include <cinolib/parallel_spmv.h>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+namespace cinolib
+{
+
+namespace
+{
+// damping factors of the Jacobi iteration, divided by the matrix diagonal. The
+// damping is 4/(3 rho), with rho the spectral radius of D^-1 A, estimated with
+// a few power iterations (and bounded from above by the Gershgorin theorem)
+CINO_INLINE
+Eigen::VectorXd jacobi_weights(const Eigen::SparseMatrix<double> & A)
+{
+    Eigen::VectorXd diag = A.diagonal();
+    Eigen::VectorXd d_inv(diag.size());
+    for(int i=0; i<diag.size(); ++i) d_inv[i] = (diag[i]!=0) ? 1.0/diag[i] : 0.0;
+
+    double rho_max = 0;
+    for(int col=0; col<A.outerSize(); ++col)
+    {
+        double sum = 0;
+        for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it) sum += std::fabs(it.value());
+        rho_max = std::max(rho_max, sum*std::fabs(d_inv[col]));
+    }
+
+    // power iterations (deterministic start, to have reproducible solves)
+    Eigen::VectorXd x(diag.size()), y;
+    for(int i=0; i<x.size(); ++i) x[i] = std::sin(1.0 + i);
+    double rho = 0;
+    for(int it=0; it<15 && x.norm()>0; ++it)
+    {
+        x.normalize();
+        parallel_symmetric_spmv(A, x, y);
+        x   = d_inv.cwiseProduct(y);
+        rho = x.norm();
+    }
+    rho = (rho>0) ? std::min(1.1*rho, rho_max) : rho_max;
+    return d_inv * (4.0/(3.0*rho));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// standard aggregation (Vanek, Mandel and Brezina 1996). Returns the number of aggregates
+CINO_INLINE
+uint aggregate(const Eigen::SparseMatrix<double> & A, const double theta, std::vector<int> & agg)
+{
+    const int n = int(A.rows());
+    Eigen::VectorXd diag = A.diagonal();
+
+    // A is symmetric: the neighbors of i are the rows of the entries of column i
+    std::vector<std::vector<int>> strong(n);
+    for(int col=0; col<n; ++col)
+    {
+        for(Eigen::SparseMatrix<double>::InnerIterator it(A,col); it; ++it)
+        {
+            int row = int(it.index());
+            if(row!=col && std::fabs(it.value()) > theta*std::sqrt(std::fabs(diag[row]*diag[col])))
+            {
+                strong[col].push_back(row);
+            }
+        }
+    }
+
+    // pass 1: aggregate the nodes whose neighborhood is entirely free
+    agg.assign(n,-1);
+    uint n_agg = 0;
+    for(int i=0; i<n; ++i)
+    {
+        if(agg[i]>=0) continue;
+        bool free = true;
+        for(int j : strong[i]) if(agg[j]>=0) { free = false; break; }
+        if(!free) continue;
+        agg[i] = n_agg;
+        for(int j : strong[i]) agg[j] = n_agg;
+        ++n_agg;
+    }
+
+    // pass 2: attach the remaining nodes to a neighboring aggregate
+    std::vector<int> agg_pass1 = agg;
+    for(int i=0; i<n; ++i)
+    {
+        if(agg[i]>=0) continue;
+        for(int j : strong[i]) if(agg_pass1[j]>=0) { agg[i] = agg_pass1[j]; break; }
+    }
+
+    // pass 3: aggregate whatever is left
+    for(int i=0; i<n; ++i)
+    {
+        if(agg[i]>=0) continue;
+        agg[i] = n_agg;
+        for(int j : strong[i]) if(agg[j]<0) agg[j] = n_agg;
+        ++n_agg;
+    }
+    return n_agg;
+}
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MultigridSolver::compute(const Eigen::SparseMatrix<double> & A)
+{
+    assert(A.rows() == A.cols());
+    A0 = &A;
+    std::vector<int> aggregates;
+    return build_hierarchy(aggregates);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool MultigridSolver::compute(const Eigen::SparseMatrix<double> & A, const AbstractMesh<M,V,E,P> & m)
+{
+    assert(A.rows() == A.cols());
+    assert(A.rows() == m.num_verts());
+    A0 = &A;
+
+    // rounds of edge collapses, from the shortest to the longest edge. As in
+    // simplification algorithms, in each round a (clustered) vertex can be
+    // collapsed only once, so that clusters remain compact. Each round about
+    // halves the number of clusters
+    std::vector<uint>  parent(m.num_verts());
+    std::vector<uint>  size  (m.num_verts(), 1);
+    std::vector<vec3d> center(m.vector_verts());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](uint vid)
+    {
+        while(parent[vid]!=vid) vid = parent[vid] = parent[parent[vid]];
+        return vid;
+    };
+    for(uint round=0; (2u<<round)<=max_aggregate_size; ++round)
+    {
+        std::vector<std::pair<double,std::pair<uint,uint>>> edges;
+        for(uint eid=0; eid<m.num_edges(); ++eid)
+        {
+            uint a = find(m.edge_vert_id(eid,0));
+            uint b = find(m.edge_vert_id(eid,1));
+            if(a!=b) edges.push_back(std::make_pair(center[a].dist_sqrd(center[b]), std::make_pair(a,b)));
+        }
+        std::sort(edges.begin(), edges.end());
+        std::vector<bool> collapsed(m.num_verts(), false);
+        for(const auto & e : edges)
+        {
+            uint a = e.second.first;
+            uint b = e.second.second;
+            if(collapsed[a] || collapsed[b] || size[a]+size[b]>max_aggregate_size) continue;
+            collapsed[a] = collapsed[b] = true;
+            parent[b]  = a;
+            center[a]  = (center[a]*size[a] + center[b]*size[b]) / double(size[a]+size[b]);
+            size[a]   += size[b];
+        }
+    }
+
+    std::vector<int> aggregates(m.num_verts(), -1);
+    std::vector<int> root2agg(m.num_verts(), -1);
+    int n_agg = 0;
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        uint root = find(vid);
+        if(root2agg[root]<0) root2agg[root] = n_agg++;
+        aggregates[vid] = root2agg[root];
+    }
+    return build_hierarchy(aggregates);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MultigridSolver::build_hierarchy(std::vector<int> & aggregates)
+{
+    typedef Eigen::Triplet<double> Entry;
+
+    levels.clear();
+    levels.emplace_back();
+    for(uint l=0; ; ++l)
+    {
+        const Eigen::SparseMatrix<double> & A = matrix(l);
+        levels.at(l).w_inv = jacobi_weights(A);
+        if(A.rows()<=coarse_size || levels.size()>=max_levels) break;
+
+        uint n_agg = 0;
+        if(aggregates.empty()) n_agg = aggregate(A, strength_threshold, aggregates);
+        else n_agg = uint(*std::max_element(aggregates.begin(), aggregates.end())) + 1;
+        if(n_agg>=A.rows()) break; // cannot coarsen any further
+
+        // tentative prolongation (piecewise constant, with normalized columns)
+        std::vector<uint> agg_size(n_agg,0);
+        for(int a : aggregates) ++agg_size.at(a);
+        std::vector<Entry> entries;
+        entries.reserve(A.rows());
+        for(int i=0; i<A.rows(); ++i)
+        {
+            entries.push_back(Entry(i, aggregates.at(i), 1.0/std::sqrt(double(agg_size.at(aggregates.at(i))))));
+        }
+        Eigen::SparseMatrix<double> T(A.rows(), n_agg);
+        T.setFromTriplets(entries.begin(), entries.end());
+
+        // smoothed prolongation and Galerkin projection
+        Eigen::SparseMatrix<double> AT = A * T;
+        Eigen::SparseMatrix<double> P  = T - levels.at(l).w_inv.asDiagonal() * AT;
+        Eigen::SparseMatrix<double> Pt = P.transpose();
+        Eigen::SparseMatrix<double> AP = A * P;
+        Level next;
+        next.A = Pt * AP;
+        next.A.makeCompressed();
+        levels.at(l).P = P;
+        levels.at(l).R = Pt;
+        levels.push_back(next);
+        aggregates.clear();
+    }
+
+    coarse_solver.compute(matrix(num_levels()-1));
+    return coarse_solver.info() == Eigen::Success;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MultigridSolver::solve(const Eigen::VectorXd & b,
+                                  Eigen::VectorXd & x,
+                            const bool              warm_start) const
+{
+    assert(A0!=nullptr && "MultigridSolver: call compute() first");
+    assert(b.size() == A0->rows());
+
+    if(!warm_start || x.size()!=b.size()) x = Eigen::VectorXd::Zero(b.size());
+
+    last_iters = 0;
+    last_error = 0;
+    const double b_norm = b.norm();
+    if(b_norm==0)
+    {
+        x.setZero();
+        return true;
+    }
+
+    Eigen::VectorXd Ax;
+    parallel_symmetric_spmv(*A0, x, Ax);
+    last_error = (b-Ax).norm()/b_norm;
+    while(last_error>=tolerance && last_iters<max_iterations)
+    {
+        v_cycle(0, b, x);
+        parallel_symmetric_spmv(*A0, x, Ax);
+        last_error = (b-Ax).norm()/b_norm;
+        ++last_iters;
+    }
+    return last_error<tolerance;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MultigridSolver::v_cycle(const Eigen::VectorXd & b, Eigen::VectorXd & x) const
+{
+    assert(A0!=nullptr && "MultigridSolver: call compute() first");
+    if(x.size()!=b.size()) x = Eigen::VectorXd::Zero(b.size());
+    v_cycle(0, b, x);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MultigridSolver::v_cycle(const uint l, const Eigen::VectorXd & b, Eigen::VectorXd & x) const
+{
+    if(l==num_levels()-1)
+    {
+        x = coarse_solver.solve(b);
+        return;
+    }
+
+    smooth(l, b, x);
+
+    // coarse grid correction
+    Eigen::VectorXd Ax, b_coarse, e;
+    parallel_symmetric_spmv(matrix(l), x, Ax);
+    parallel_spmv(levels.at(l).R, b-Ax, b_coarse);
+    Eigen::VectorXd x_coarse = Eigen::VectorXd::Zero(b_coarse.size());
+    v_cycle(l+1, b_coarse, x_coarse);
+    parallel_spmv(levels.at(l).P, x_coarse, e);
+    x += e;
+
+    smooth(l, b, x);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MultigridSolver::smooth(const uint l, const Eigen::VectorXd & b, Eigen::VectorXd & x) const
+{
+    Eigen::VectorXd Ax;
+    for(uint i=0; i<smoothing_steps; ++i)
+    {
+        parallel_symmetric_spmv(matrix(l), x, Ax);
+        x += levels.at(l).w_inv.cwiseProduct(b-Ax);
+    }
+}
+
+}
@@ -0,0 +1,151 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MULTIGRID_H
+#define CINO_MULTIGRID_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_mesh.h>
+#include <Eigen/Sparse>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Multigrid solver for sparse symmetric positive (semi)definite systems, such
+ * as the ones arising from mesh Laplacians (e.g. harmonic maps, heat flow,
+ * smoothing and Poisson problems). Both setup and solve have cost linear in
+ * the size of the system, hence this is the solver of choice for very large
+ * meshes. The hierarchy of coarser systems is built with smoothed aggregation
+ * (Vanek, Mandel and Brezina 1996):
+ *
+ *  - variables are clustered into aggregates, each of which becomes a single
+ *    variable of the coarser level
+ *  - the piecewise constant interpolation defined by the aggregates is
+ *    smoothed with a damped Jacobi step, obtaining the prolongation P
+ *  - the coarse system is the Galerkin projection P^T A P
+ *
+ * until the system is smaller than coarse_size, where a direct solver is used.
+ * Aggregates are computed from the matrix entries (algebraic coarsening). If a
+ * mesh is given to compute() the finest aggregates are computed geometrically
+ * instead, collapsing mesh edges from the shortest to the longest (as done by
+ * simplification algorithms), and bounding the size of each cluster.
+ *
+ * Each solve iteration is a V-cycle, with damped Jacobi smoothing. Smoothing
+ * and grid transfers are multithreaded. The V-cycle is symmetric, therefore
+ * it can also be used as a preconditioner for CG (see the MULTIGRID_V_CYCLE
+ * preconditioner in iterative_solvers.h, and the CG_MULTIGRID solver in
+ * linear_solvers.h)
+ *
+ * NOTE: the solver keeps a pointer to the matrix passed to compute(), which
+ * must therefore outlive it. Although solve() is const, it records the
+ * statistics of the last solve, hence the same solver must not be used by
+ * multiple threads at once.
+*/
+
+class MultigridSolver
+{
+    public:
+
+        explicit MultigridSolver() {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        double tolerance          = 1e-10; // on the relative residual |b-Ax|/|b|
+        uint   max_iterations     = 100;   // maximum number of V-cycles
+        uint   max_levels         = 25;
+        uint   coarse_size        = 500;   // systems smaller than this are solved directly
+        uint   smoothing_steps    = 2;     // pre and post smoothing steps per level
+        double strength_threshold = 0.05;  // a_ij is a strong connection if |a_ij| > threshold * sqrt(|a_ii a_jj|)
+        uint   max_aggregate_size = 8;     // geometric coarsening only
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // algebraic coarsening. Returns false if the coarsest system could not be factorized
+        bool compute(const Eigen::SparseMatrix<double> & A);
+
+        // geometric coarsening of the finest level (A must have a row per mesh vertex)
+        template<class M, class V, class E, class P>
+        bool compute(const Eigen::SparseMatrix<double> & A, const AbstractMesh<M,V,E,P> & m);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // solves A x = b with V-cycles. If warm_start is true and x has the right
+        // size, the content of x is used as initial guess. Returns true if converged
+        bool solve(const Eigen::VectorXd & b,
+                         Eigen::VectorXd & x,
+                   const bool              warm_start = false) const;
+
+        // a single V-cycle, improving the current estimate x
+        void v_cycle(const Eigen::VectorXd & b, Eigen::VectorXd & x) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint   num_levels()             const { return uint(levels.size()); }
+        uint   level_size(const uint l) const { return uint(matrix(l).rows()); }
+        uint   iterations()             const { return last_iters; } // of the last solve
+        double error()                  const { return last_error; } // relative residual of the last solve
+
+    protected:
+
+        struct Level
+        {
+            Eigen::SparseMatrix<double>                 A;     // empty for the finest level (see A0)
+            Eigen::SparseMatrix<double,Eigen::RowMajor> P;     // prolongation from the next (coarser) level
+            Eigen::SparseMatrix<double,Eigen::RowMajor> R;     // restriction to the next level (P^T)
+            Eigen::VectorXd                             w_inv; // damping factor / diagonal (Jacobi smoother)
+        };
+
+        const Eigen::SparseMatrix<double> & matrix(const uint l) const { return (l==0) ? *A0 : levels.at(l).A; }
+
+        bool build_hierarchy(std::vector<int> & aggregates); // aggregates of the finest level, if available
+        void v_cycle(const uint l, const Eigen::VectorXd & b, Eigen::VectorXd & x) const;
+        void smooth (const uint l, const Eigen::VectorXd & b, Eigen::VectorXd & x) const;
+
+        const Eigen::SparseMatrix<double>                 * A0 = nullptr;
+        std::vector<Level>                                  levels;
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>  coarse_solver;
+
+        mutable uint   last_iters = 0;
+        mutable double last_error = 0.0;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "multigrid.cpp"
+#endif
+
+#endif // CINO_MULTIGRID_H
@@ -42,10 +42,29 @@
 #include <cinolib/geometry/triangle.h>
 #include <cinolib/geometry/tetrahedron.h>
 #include <stack>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <cmath>
 
 namespace cinolib
 {
 
+namespace
+{
+    // range [min,max] spanned by the dot products between dir and all points in the box
+    CINO_INLINE
+    void box_range_along(const AABB & b, const vec3d & dir, double & min, double & max)
+    {
+        double c = b.center().dot(dir);
+        double e = 0.5 * (std::fabs(dir[0])*b.delta_x() + std::fabs(dir[1])*b.delta_y() + std::fabs(dir[2])*b.delta_z());
+        min = c - e;
+        max = c + e;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 OctreeNode::~OctreeNode()
 {
@@ -98,10 +117,15 @@ void Octree::build()
 
     // initialize root with all items, also updating its AABB
     assert(root==nullptr);
+    refit_pending = false;
     root = new OctreeNode(AABB());
-    root->item_indices.resize(items.size());
-    std::iota(root->item_indices.begin(),root->item_indices.end(),0);
-    for(auto it : items) root->bbox.push(it->aabb);
+    root->item_indices.reserve(items.size());
+    for(uint i=0; i<items.size(); ++i)
+    {
+        if(items.at(i)==nullptr) continue; // empty slot left by remove_item()
+        root->item_indices.push_back(i);
+        root->bbox.push(items.at(i)->aabb);
+    }
 
     root->bbox.scale(1.5); // enlarge bbox to account for queries outside legal area.
                            // this should disappear eventually....
@@ -113,64 +137,78 @@ void Octree::build()
     }
     else
     {
-        subdivide(root);
-
-        if(max_depth==2)
+        // WORK BALANCED PARALLEL CONSTRUCTION
+        // Data may be arbitrarily unbalanced (e.g. a scanned object on a wide ground plane),
+        // hence there is no way to know in advance how many items each subtree will contain.
+        // Construction proceeds in two phases:
+        //
+        //  i)  top levels are made one node at a time, distributing the items of each (large)
+        //      node into its children in parallel (see subdivide)
+        //  ii) the remaining subtrees are made by a pool of threads (see PARALLEL_TASKS). Each
+        //      thread makes a subtree depth first, and spawns a new task for any large child
+        //      it encounters, so that idle threads can steal work from busy ones
+
+        auto needs_split = [&](const OctreeNode *node, const uint depth)
         {
-            tree_depth = 2;
-            for(int i=0; i<8; ++i) leaves.push_back(root->children[i]);
-        }
-        else
-        {
-            // WORK IN PARALLEL ON EACH OCTANT
-            // To fully avoid syncrhonization between the threads global information
-            // such as vector of leaves and tree depth are duplicated, and will be
-            // merged after convergence.
-
-            uint octant_depth[8] = { 2, 2, 2, 2, 2, 2, 2, 2 };
-            std::vector<const OctreeNode*> octant_leaves[8];
+            return depth<max_depth && node->item_indices.size()>items_per_leaf;
+        };
 
-            std::queue<std::pair<OctreeNode*,uint>> splitlist[8]; // (node, depth)
-            for(int i=0; i<8; ++i)
+        typedef std::pair<OctreeNode*,uint> Task; // (node, depth)
+        std::vector<Task> large_nodes = { std::make_pair(root,1u) };
+        std::vector<Task> tasks;
+        while(!large_nodes.empty())
+        {
+            std::vector<Task> next_level;
+            for(auto task : large_nodes)
             {
-                if(root->children[i]->item_indices.size()>items_per_leaf)
+                subdivide(task.first);
+                tree_depth = std::max(tree_depth, task.second+1);
+                for(int i=0; i<8; ++i)
                 {
-                    splitlist[i].push(std::make_pair(root->children[i],2));
+                    OctreeNode *child = task.first->children[i];
+                    if(!needs_split(child, task.second+1)) continue;
+                    if(child->item_indices.size()>parallel_split_threshold)
+                    {
+                        next_level.push_back(std::make_pair(child, task.second+1));
+                    }
+                    else tasks.push_back(std::make_pair(child, task.second+1));
                 }
-                else octant_leaves[i].push_back(root->children[i]);
             }
+            large_nodes.swap(next_level);
+        }
 
-            PARALLEL_FOR(0,8,0,[&](uint i)
+        std::mutex mutex;
+        PARALLEL_TASKS(tasks, [&](const Task & task, const std::function<void(const Task&)> & spawn)
+        {
+            uint local_depth = task.second;
+            std::stack<Task> lifo;
+            lifo.push(task);
+            while(!lifo.empty())
             {
-                while(!splitlist[i].empty())
-                {
-                    auto pair  = splitlist[i].front();
-                    auto node  = pair.first;
-                    uint depth = pair.second + 1;
-                    splitlist[i].pop();
+                OctreeNode *node  = lifo.top().first;
+                uint        depth = lifo.top().second + 1;
+                lifo.pop();
 
-                    subdivide(node);
+                subdivide(node);
+                local_depth = std::max(local_depth, depth);
 
-                    for(int j=0; j<8; ++j)
+                for(int i=0; i<8; ++i)
+                {
+                    OctreeNode *child = node->children[i];
+                    if(!needs_split(child, depth)) continue;
+                    if(child->item_indices.size()>spawn_threshold)
                     {
-                        if(depth<max_depth && node->children[j]->item_indices.size()>items_per_leaf)
-                        {
-                            splitlist[i].push(std::make_pair(node->children[j], depth));
-                        }
-                        else octant_leaves[i].push_back(node->children[j]);
+                        spawn(std::make_pair(child, depth));
                     }
-
-                    octant_depth[i] = std::max(octant_depth[i], depth);
+                    else lifo.push(std::make_pair(child, depth));
                 }
-            });
-
-            // global merge of octant data
-            tree_depth = *std::max_element(octant_depth, octant_depth+8);
-            for(int i=0; i<8; ++i)
-            {
-                std::copy(octant_leaves[i].begin(), octant_leaves[i].end(), std::back_inserter(leaves));
             }
-        }
+            std::lock_guard<std::mutex> guard(mutex);
+            tree_depth = std::max(tree_depth, local_depth);
+        });
+
+        // collect leaves in depth first order (which does not depend on thread scheduling)
+        update_leaves();
     }
 
     if(print_debug_info)
@@ -207,62 +245,377 @@ void Octree::subdivide(OctreeNode * node)
     node->children[6] = new OctreeNode(AABB(vec3d(avg[0], avg[1], avg[2]), vec3d(max[0], max[1], max[2])));
     node->children[7] = new OctreeNode(AABB(vec3d(min[0], avg[1], avg[2]), vec3d(avg[0], max[1], max[2])));
 
-    for(uint it : node->item_indices)
+    if(node->item_indices.size()>parallel_split_threshold)
     {
-        bool orphan = true;
-        for(int i=0; i<8; ++i)
+        // large node: first compute in parallel a bitmask encoding the children
+        // intersected by each item, then fill the eight children in parallel
+        std::vector<uint8_t> mask(node->item_indices.size(),0);
+        PARALLEL_FOR(0, uint(node->item_indices.size()), 1000, [&](uint j)
+        {
+            const AABB & b = items.at(node->item_indices.at(j))->aabb;
+            for(int i=0; i<8; ++i)
+            {
+                if(node->children[i]->bbox.intersects_box(b)) mask.at(j) |= uint8_t(1<<i);
+            }
+            assert(mask.at(j)!=0); // orphan
+        });
+        PARALLEL_FOR(0, 8, 0, [&](uint i)
         {
-            assert(node->children[i]!=nullptr);
-            if(node->children[i]->bbox.intersects_box(items.at(it)->aabb))
+            for(uint j=0; j<mask.size(); ++j)
             {
-                node->children[i]->item_indices.push_back(it);
-                orphan = false;
+                if(mask.at(j) & (1<<i)) node->children[i]->item_indices.push_back(node->item_indices.at(j));
             }
+        });
+    }
+    else
+    {
+        for(uint it : node->item_indices)
+        {
+            bool orphan = true;
+            for(int i=0; i<8; ++i)
+            {
+                assert(node->children[i]!=nullptr);
+                if(node->children[i]->bbox.intersects_box(items.at(it)->aabb))
+                {
+                    node->children[i]->item_indices.push_back(it);
+                    orphan = false;
+                }
+            }
+            assert(!orphan);
         }
-        assert(!orphan);
     }
 
-    node->item_indices.clear();
+    // release memory (clear() would not)
+    std::vector<uint>().swap(node->item_indices);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void Octree::push_point(const uint id, const vec3d & v)
+uint Octree::push_point(const uint id, const vec3d & v)
 {
-    items.push_back(new Point(id,v));
+    return add_item(new Point(id,v));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void Octree::push_sphere(const uint id, const vec3d & c, const double r)
+uint Octree::push_sphere(const uint id, const vec3d & c, const double r)
 {
-    items.push_back(new Sphere(id,c,r));
+    return add_item(new Sphere(id,c,r));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void Octree::push_segment(const uint id, const vec3d & v0, const vec3d & v1)
+uint Octree::push_segment(const uint id, const vec3d & v0, const vec3d & v1)
 {
-    items.push_back(new Segment(id,v0,v1));
+    return add_item(new Segment(id,v0,v1));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void Octree::push_triangle(const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2)
+uint Octree::push_triangle(const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2)
 {
-    items.push_back(new Triangle(id,v0,v1,v2));
+    return add_item(new Triangle(id,v0,v1,v2));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void Octree::push_tetrahedron(const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2, const vec3d & v3)
+uint Octree::push_tetrahedron(const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2, const vec3d & v3)
 {
-    items.push_back(new Tetrahedron(id,v0,v1,v2,v3));
+    return add_item(new Tetrahedron(id,v0,v1,v2,v3));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint Octree::add_item(SpatialDataStructureItem *item)
+{
+    uint index;
+    if(free_slots.empty())
+    {
+        index = uint(items.size());
+        items.push_back(item);
+    }
+    else
+    {
+        index = free_slots.back();
+        free_slots.pop_back();
+        assert(items.at(index)==nullptr);
+        items.at(index) = item;
+    }
+    if(root!=nullptr) insert_item(index);
+    return index;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::update_point(const uint index, const vec3d & v)
+{
+    assert(items.at(index)->item_type==POINT);
+    Point *p = static_cast<Point*>(items.at(index));
+    *p = Point(p->id,v);
+    refit_pending = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::update_sphere(const uint index, const vec3d & c, const double r)
+{
+    assert(items.at(index)->item_type==SPHERE);
+    Sphere *s = static_cast<Sphere*>(items.at(index));
+    *s = Sphere(s->id,c,r);
+    refit_pending = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::update_segment(const uint index, const vec3d & v0, const vec3d & v1)
+{
+    assert(items.at(index)->item_type==SEGMENT);
+    Segment *s = static_cast<Segment*>(items.at(index));
+    *s = Segment(s->id,v0,v1);
+    refit_pending = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::update_triangle(const uint index, const vec3d & v0, const vec3d & v1, const vec3d & v2)
+{
+    assert(items.at(index)->item_type==TRIANGLE);
+    Triangle *t = static_cast<Triangle*>(items.at(index));
+    *t = Triangle(t->id,v0,v1,v2);
+    refit_pending = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::update_tetrahedron(const uint index, const vec3d & v0, const vec3d & v1, const vec3d & v2, const vec3d & v3)
+{
+    assert(items.at(index)->item_type==TETRAHEDRON);
+    Tetrahedron *t = static_cast<Tetrahedron*>(items.at(index));
+    *t = Tetrahedron(t->id,v0,v1,v2,v3);
+    refit_pending = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// After refitting, node bboxes are no longer the octants generated by subdivide(),
+// but rather the tightest boxes containing the AABBs of all the items stored in
+// their subtree. Bboxes of siblings may therefore overlap, but all queries remain
+// valid because they only rely on the fact that a node bbox encloses its items
+CINO_INLINE
+void Octree::refit()
+{
+    if(root==nullptr) return;
+
+    typedef std::chrono::steady_clock Time;
+    Time::time_point t0 = Time::now();
+
+    refit_pending = false;
+    if(root->is_inner())
+    {
+        // subtrees are disjoint, hence octants can be refitted in parallel
+        PARALLEL_FOR(0,8,0,[&](uint i)
+        {
+            refit(root->children[i]);
+        });
+        root->bbox.reset();
+        for(int i=0; i<8; ++i) root->bbox.push(root->children[i]->bbox);
+    }
+    else refit(root);
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Refit\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::refit(OctreeNode *node)
+{
+    // note: empty nodes get an empty (i.e. inverted) bbox, which fails any
+    // contains/intersection test and is at infinite distance from any point
+    node->bbox.reset();
+    if(node->is_inner())
+    {
+        for(int i=0; i<8; ++i)
+        {
+            refit(node->children[i]);
+            node->bbox.push(node->children[i]->bbox);
+        }
+    }
+    else
+    {
+        for(uint index : node->item_indices) node->bbox.push(items.at(index)->aabb);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::insert_item(const uint index)
+{
+    assert(root!=nullptr);
+    assert(items.at(index)!=nullptr);
+
+    // if some leaf has been split the list of leaves must be regenerated
+    if(insert_item(root, index, 1)) update_leaves();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// The item is inserted in all the leaves whose bbox intersects its AABB (or in the
+// closest leaf, if there is none), and bboxes along the way are enlarged to fully
+// contain it. This keeps the tree valid both before and after a refit().
+// Returns true if any leaf has been split
+CINO_INLINE
+bool Octree::insert_item(OctreeNode *node, const uint index, const uint depth)
+{
+    const AABB & b = items.at(index)->aabb;
+    node->bbox.push(b);
+
+    bool split = false;
+    if(node->is_inner())
+    {
+        bool inserted = false;
+        for(int i=0; i<8; ++i)
+        {
+            if(node->children[i]->bbox.intersects_box(b))
+            {
+                split |= insert_item(node->children[i], index, depth+1);
+                inserted = true;
+            }
+        }
+        if(!inserted)
+        {
+            vec3d  c     = b.center();
+            int    best  = 0;
+            double d_min = inf_double;
+            for(int i=0; i<8; ++i)
+            {
+                double d = node->children[i]->bbox.dist_sqrd(c);
+                if(d<d_min)
+                {
+                    d_min = d;
+                    best  = i;
+                }
+            }
+            split |= insert_item(node->children[best], index, depth+1);
+        }
+    }
+    else
+    {
+        node->item_indices.push_back(index);
+        if(depth<max_depth && node->item_indices.size()>items_per_leaf)
+        {
+            split_leaf(node, depth);
+            split = true;
+        }
+    }
+    return split;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// local rebuild of a leaf that exceeds the prescribed number of items
+CINO_INLINE
+void Octree::split_leaf(OctreeNode *node, const uint depth)
+{
+    subdivide(node);
+    tree_depth = std::max(tree_depth, depth+1);
+    for(int i=0; i<8; ++i)
+    {
+        refit(node->children[i]);
+        if(depth+1<max_depth && node->children[i]->item_indices.size()>items_per_leaf)
+        {
+            split_leaf(node->children[i], depth+1);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::remove_item(const uint index)
+{
+    assert(items.at(index)!=nullptr);
+
+    if(root!=nullptr)
+    {
+        // any leaf containing the item has a bbox that intersects the item AABB. This
+        // does not hold if the item was updated and the tree not yet refitted: in such
+        // case all leaves are visited, so that no leaf keeps a reference to a free slot
+        const AABB & b = items.at(index)->aabb;
+        std::stack<OctreeNode*> lifo;
+        lifo.push(root);
+        while(!lifo.empty())
+        {
+            OctreeNode *node = lifo.top();
+            lifo.pop();
+
+            if(node->is_inner())
+            {
+                for(int i=0; i<8; ++i)
+                {
+                    if(refit_pending || node->children[i]->bbox.intersects_box(b)) lifo.push(node->children[i]);
+                }
+            }
+            else
+            {
+                auto & list = node->item_indices;
+                list.erase(std::remove(list.begin(), list.end(), index), list.end());
+            }
+        }
+    }
+
+    delete items.at(index);
+    items.at(index) = nullptr;
+    free_slots.push_back(index);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::rebuild()
+{
+    if(root!=nullptr) delete root;
+    root       = nullptr;
+    tree_depth = 0;
+    leaves.clear();
+    build();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::update_leaves()
+{
+    leaves.clear();
+    if(root==nullptr) return;
+    std::stack<const OctreeNode*> lifo;
+    lifo.push(root);
+    while(!lifo.empty())
+    {
+        const OctreeNode *node = lifo.top();
+        lifo.pop();
+        if(node->is_inner())
+        {
+            for(int i=0; i<8; ++i) lifo.push(node->children[i]);
+        }
+        else leaves.push_back(node);
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -297,7 +650,6 @@ vec3d Octree::closest_point(const vec3d & p) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-// https://stackoverflow.com/questions/41306122/nearest-neighbor-search-in-octree
 CINO_INLINE
 void Octree::closest_point(const vec3d  & p,          // query point
                                  uint   & id,         // id of the item T closest to p
@@ -309,67 +661,77 @@ void Octree::closest_point(const vec3d  & p,          // query point
     typedef std::chrono::steady_clock Time;
     Time::time_point t0 = Time::now();
 
-    PrioQueue q;
-    if(root->is_inner())
-    {
-        Obj obj;
-        obj.node = root;
-        obj.dist = root->bbox.dist_sqrd(p);
-        q.push(obj);
-    }
-    else // in case the root is alrady a leaf...
+    std::vector<NodeDist> stack;
+    uint index;
+    bool found = closest_item(p, uint(-1), inf_double, stack, index, pos, dist);
+    assert(found); (void)found;
+
+    if(print_debug_info)
     {
-        for(uint index : root->item_indices)
-        {
-            Obj obj;
-            obj.node  = root;
-            obj.index = index;
-            obj.pos   = items.at(index)->point_closest_to(p);
-            obj.dist  = obj.pos.dist_sqrd(p);
-            q.push(obj);
-        }
+        Time::time_point t1 = Time::now();
+        std::cout << "Closest point\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
     }
 
-    while(q.top().node->is_inner())
-    {
-        Obj obj = q.top();
-        q.pop();
+    id = items.at(index)->id;
+}
 
-        for(int i=0; i<8; ++i)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::closest_points(const std::vector<vec3d>  & p,
+                                  std::vector<uint>   & index,
+                                  std::vector<vec3d>  & pos,
+                                  std::vector<vec4d>  & bc,
+                            const std::vector<uint>   & hint,
+                            const std::vector<double> & max_dist) const
+{
+    assert(hint.empty()     || hint.size()    ==p.size());
+    assert(max_dist.empty() || max_dist.size()==p.size());
+
+    index.resize(p.size());
+    pos.resize(p.size());
+    bc.resize(p.size());
+
+    // queries are processed in chunks, so that each chunk can reuse the same stack
+    const uint chunk    = 256;
+    const uint n_chunks = (uint(p.size()) + chunk - 1) / chunk;
+    PARALLEL_FOR(0, n_chunks, 4, [&](uint c)
+    {
+        std::vector<NodeDist> stack;
+        for(uint i=c*chunk; i<std::min(uint(p.size()),(c+1)*chunk); ++i)
         {
-            OctreeNode *child = obj.node->children[i];
-            if(child->is_inner())
+            uint   h  = hint.empty()     ? uint(-1)   : hint.at(i);
+            double md = max_dist.empty() ? inf_double : max_dist.at(i)*max_dist.at(i);
+            double d;
+            bc.at(i) = vec4d(0.0);
+            if(!closest_item(p.at(i), h, md, stack, index.at(i), pos.at(i), d))
             {
-                Obj obj;
-                obj.node = child;
-                obj.dist = child->bbox.dist_sqrd(p);
-                q.push(obj);
+                index.at(i) = uint(-1);
+                pos.at(i)   = p.at(i);
+                continue;
             }
-            else
+            const SpatialDataStructureItem *item = items.at(index.at(i));
+            switch(item->item_type)
             {
-                for(uint index : child->item_indices)
-                {
-                    Obj obj;
-                    obj.node  = child;
-                    obj.index = index;
-                    obj.pos   = items.at(index)->point_closest_to(p);
-                    obj.dist  = obj.pos.dist_sqrd(p);
-                    q.push(obj);
-                }
+                case SEGMENT     :
+                case TRIANGLE    :
+                case TETRAHEDRON : item->barycentric_coordinates(pos.at(i), bc.at(i).ptr()); break;
+                case POINT       : bc.at(i)[0] = 1.0; break;
+                default          : break; // spheres do not have barycentric coordinates
             }
         }
-    }
+    });
+}
 
-    if(print_debug_info)
-    {
-        Time::time_point t1 = Time::now();
-        std::cout << "Closest point\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
-    }
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    assert(q.top().index>=0);
-    id   = items.at(q.top().index)->id;
-    pos  = q.top().pos;
-    dist = q.top().dist;
+CINO_INLINE
+void Octree::closest_points(const std::vector<vec3d> & p,
+                                  std::vector<vec3d> & pos) const
+{
+    std::vector<uint>  index;
+    std::vector<vec4d> bc;
+    closest_points(p, index, pos, bc);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -598,6 +960,167 @@ bool Octree::intersects_ray(const vec3d & p, const vec3d & dir, std::set<std::pa
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+bool Octree::intersects_line(const vec3d & p, const vec3d & dir, std::set<std::pair<double,uint>> & all_hits) const
+{
+    // a line is the union of two opposite rays
+    std::set<std::pair<double,uint>> hits_fwd, hits_bwd;
+    intersects_ray(p,  dir, hits_fwd);
+    intersects_ray(p, -dir, hits_bwd);
+    for(const auto & hit : hits_fwd) all_hits.insert(hit);
+    for(const auto & hit : hits_bwd) all_hits.insert(std::make_pair(-hit.first, hit.second));
+    return !all_hits.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool Octree::intersects_plane(const vec3d & p, const vec3d & n, std::unordered_set<uint> & ids) const
+{
+    double d = p.dot(n);
+    return intersects_slab(n, d, d, ids);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool Octree::intersects_slab(const vec3d & n, const double min, const double max, std::unordered_set<uint> & ids) const
+{
+    typedef std::chrono::steady_clock Time;
+    Time::time_point t0 = Time::now();
+
+    auto overlaps = [&](const double lo, const double hi) { return lo<=max && hi>=min; };
+    double lo, hi;
+
+    std::stack<OctreeNode*> lifo;
+    if(root)
+    {
+        box_range_along(root->bbox, n, lo, hi);
+        if(overlaps(lo,hi)) lifo.push(root);
+    }
+
+    while(!lifo.empty())
+    {
+        OctreeNode *node = lifo.top();
+        lifo.pop();
+
+        if(node->is_inner())
+        {
+            for(int i=0; i<8; ++i)
+            {
+                box_range_along(node->children[i]->bbox, n, lo, hi);
+                if(overlaps(lo,hi)) lifo.push(node->children[i]);
+            }
+        }
+        else
+        {
+            for(uint i : node->item_indices)
+            {
+                items.at(i)->range_along(n, lo, hi);
+                if(overlaps(lo,hi)) ids.insert(items.at(i)->id);
+            }
+        }
+    }
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects slab\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+
+    return !ids.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::intersects_planes(const vec3d                          & n,
+                               const double                           v0,
+                               const double                           dv,
+                               const uint                             n_planes,
+                                     std::vector<std::vector<uint>>   & ids) const
+{
+    assert(dv>0);
+
+    typedef std::chrono::steady_clock Time;
+    Time::time_point t0 = Time::now();
+
+    ids.assign(n_planes, std::vector<uint>());
+    if(n_planes==0) return;
+
+    // range of planes intersected by an interval [lo,hi]
+    auto planes_in = [&](double lo, double hi, int & beg, int & end)
+    {
+        if(!(lo<=hi)) return false; // empty node
+        lo = std::max(lo, v0-dv);
+        hi = std::min(hi, v0+n_planes*dv);
+        if(lo>hi) return false;
+        beg = int(std::ceil ((lo-v0)/dv));
+        end = int(std::floor((hi-v0)/dv));
+        // fix rounding, so that the outcome is consistent with intersects_plane
+        while(v0+(beg-1)*dv>=lo) --beg;
+        while(v0+ beg   *dv< lo) ++beg;
+        while(v0+(end+1)*dv<=hi) ++end;
+        while(v0+ end   *dv> hi) --end;
+        beg = std::max(0, beg);
+        end = std::min(int(n_planes)-1, end);
+        return beg<=end;
+    };
+    double lo, hi;
+    int    beg, end;
+
+    // items may be referenced by multiple leaves, but they are processed only once
+    std::vector<bool> visited(items.size(), false);
+
+    std::stack<OctreeNode*> lifo;
+    if(root)
+    {
+        box_range_along(root->bbox, n, lo, hi);
+        if(planes_in(lo,hi,beg,end)) lifo.push(root);
+    }
+
+    while(!lifo.empty())
+    {
+        OctreeNode *node = lifo.top();
+        lifo.pop();
+
+        if(node->is_inner())
+        {
+            for(int i=0; i<8; ++i)
+            {
+                box_range_along(node->children[i]->bbox, n, lo, hi);
+                if(planes_in(lo,hi,beg,end)) lifo.push(node->children[i]);
+            }
+        }
+        else
+        {
+            for(uint i : node->item_indices)
+            {
+                if(visited.at(i)) continue;
+                visited.at(i) = true;
+                items.at(i)->range_along(n, lo, hi);
+                if(!planes_in(lo,hi,beg,end)) continue;
+                for(int k=beg; k<=end; ++k) ids.at(k).push_back(items.at(i)->id);
+            }
+        }
+    }
+
+    // different items may share the same id (e.g. the triangles tessellating a polygon)
+    PARALLEL_FOR(0, n_planes, 64, [&](uint k)
+    {
+        std::sort(ids.at(k).begin(), ids.at(k).end());
+        ids.at(k).erase(std::unique(ids.at(k).begin(), ids.at(k).end()), ids.at(k).end());
+    });
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects planes\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // this query becomes exact if CINOLIB_USES_SHEWCHUK_PREDICATES is defined
 CINO_INLINE
 bool Octree::intersects_triangle(const vec3d t[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const
@@ -710,4 +1233,69 @@ bool Octree::intersects_box(const AABB & b, std::unordered_set<uint> & ids) cons
     return !ids.empty();
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool Octree::closest_item(const vec3d           & p,
+                          const uint              hint,
+                          const double            max_dist_sqrd,
+                          std::vector<NodeDist> & stack,
+                          uint                  & index,
+                          vec3d                 & pos,
+                          double                & dist_sqrd) const
+{
+    index     = uint(-1);
+    dist_sqrd = max_dist_sqrd;
+
+    // a good initial guess allows to prune most of the tree from the very beginning
+    if(hint<items.size() && items.at(hint)!=nullptr)
+    {
+        vec3d  q = items.at(hint)->point_closest_to(p);
+        double d = q.dist_sqrd(p);
+        if(d<=dist_sqrd)
+        {
+            index     = hint;
+            pos       = q;
+            dist_sqrd = d;
+        }
+    }
+    if(root==nullptr) return (index!=uint(-1));
+
+    stack.clear();
+    stack.push_back(std::make_pair(root->bbox.dist_sqrd(p), root));
+    while(!stack.empty())
+    {
+        NodeDist top = stack.back();
+        stack.pop_back();
+        if(top.first>dist_sqrd) continue; // the best item found so far is closer than the whole node
+
+        const OctreeNode *node = top.second;
+        if(node->is_inner())
+        {
+            // push children from the farthest to the closest, so that closest children are visited first
+            NodeDist children[8];
+            for(int i=0; i<8; ++i) children[i] = std::make_pair(node->children[i]->bbox.dist_sqrd(p), node->children[i]);
+            std::sort(children, children+8, [](const NodeDist & a, const NodeDist & b) { return a.first>b.first; });
+            for(int i=0; i<8; ++i) if(children[i].first<=dist_sqrd) stack.push_back(children[i]);
+        }
+        else
+        {
+            for(uint i : node->item_indices)
+            {
+                const SpatialDataStructureItem *item = items.at(i);
+                if(item->aabb.dist_sqrd(p)>dist_sqrd) continue;
+                vec3d  q = item->point_closest_to(p);
+                double d = q.dist_sqrd(p);
+                if(d<dist_sqrd || (d==dist_sqrd && i<index)) // ties go to the lowest index
+                {
+                    index     = i;
+                    pos       = q;
+                    dist_sqrd = d;
+                }
+            }
+        }
+    }
+    return (index!=uint(-1));
+}
+
 }
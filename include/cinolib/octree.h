@@ -38,6 +38,7 @@
 
 #include <cinolib/geometry/spatial_data_structure_item.h>
 #include <cinolib/meshes/meshes.h>
+#include <cinolib/parallel_for.h>
 #include <queue>
 
 namespace cinolib
@@ -63,6 +64,19 @@ class OctreeNode
  *  i)   Create an empty octree
  *  ii)  Use the push_segment/triangle/tetrahedron facilities to populate it
  *  iii) Call build to make the tree
+ *
+ * Once built, the tree can be kept in sync with moving geometry without
+ * rebuilding it from scratch:
+ *
+ *  - items pushed after build() are incrementally inserted in the tree,
+ *    and leaves that overflow are locally subdivided
+ *  - remove_item() deletes an item from the tree and frees its slot
+ *  - update_point/segment/triangle/tetrahedron/sphere() change the geometry
+ *    of an item. After all updates are done, refit() recomputes bottom-up the
+ *    bounding boxes of all nodes so that they tightly enclose their items
+ *  - refit_from_mesh_xxx() do both things for trees made with build_from_mesh_xxx()
+ *  - rebuild() makes the tree from scratch, and should be used only occasionally
+ *    (e.g. when items moved so much that queries became noticeably slower)
 */
 
 class Octree
@@ -76,11 +90,13 @@ class Octree
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void push_point      (const uint id, const vec3d &  v);
-        void push_sphere     (const uint id, const vec3d &  c, const double   r);
-        void push_segment    (const uint id, const vec3d & v0, const vec3d & v1);
-        void push_triangle   (const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2);
-        void push_tetrahedron(const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2, const vec3d & v3);
+        // all these methods return the index of the newly created item in vector items.
+        // If the tree is already built, the item is also inserted in it
+        uint push_point      (const uint id, const vec3d &  v);
+        uint push_sphere     (const uint id, const vec3d &  c, const double   r);
+        uint push_segment    (const uint id, const vec3d & v0, const vec3d & v1);
+        uint push_triangle   (const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2);
+        uint push_tetrahedron(const uint id, const vec3d & v0, const vec3d & v1, const vec3d & v2, const vec3d & v3);
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -90,6 +106,102 @@ class Octree
 
         void subdivide(OctreeNode *node);
 
+        // DYNAMIC UPDATES :::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // change the geometry of the item at position index in vector items.
+        // NOTE: the tree is not updated until refit() is called
+        void update_point      (const uint index, const vec3d &  v);
+        void update_sphere     (const uint index, const vec3d &  c, const double   r);
+        void update_segment    (const uint index, const vec3d & v0, const vec3d & v1);
+        void update_triangle   (const uint index, const vec3d & v0, const vec3d & v1, const vec3d & v2);
+        void update_tetrahedron(const uint index, const vec3d & v0, const vec3d & v1, const vec3d & v2, const vec3d & v3);
+
+        // recomputes bottom-up the bbox of each node as the union of the AABBs of its items
+        void refit();
+
+        // inserts/removes the item at position index in vector items into/from the tree.
+        // Removed items are deleted, and their slots will be reused by future push_xxx calls.
+        // Items can be removed also after an update and before refit(). In such case node
+        // bboxes may not enclose the updated items, and all leaves are visited
+        void insert_item(const uint index);
+        void remove_item(const uint index);
+
+        // discards the current tree and makes a new one with the current items
+        void rebuild();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // update the items of a tree made with build_from_mesh_polys(m), and refit the tree.
+        // Connectivity (and polygon tessellation) must be the same used to build the tree
+        template<class M, class V, class E, class P>
+        void refit_from_mesh_polys(const AbstractPolygonMesh<M,V,E,P> & m)
+        {
+            std::vector<uint> offset(m.num_polys()+1,0);
+            for(uint pid=0; pid<m.num_polys(); ++pid)
+            {
+                offset.at(pid+1) = offset.at(pid) + uint(m.poly_tessellation(pid).size()/3);
+            }
+            assert(offset.back()==items.size());
+            PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+            {
+                const std::vector<uint> & tess = m.poly_tessellation(pid);
+                for(uint i=0; i<tess.size()/3; ++i)
+                {
+                    update_triangle(offset.at(pid)+i, m.vert(tess.at(3*i+0)),
+                                                      m.vert(tess.at(3*i+1)),
+                                                      m.vert(tess.at(3*i+2)));
+                }
+            });
+            refit();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class F, class P>
+        void refit_from_mesh_polys(const AbstractPolyhedralMesh<M,V,E,F,P> & m)
+        {
+            assert(items.size()==m.num_polys());
+            PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+            {
+                switch(m.mesh_type())
+                {
+                    case TETMESH : update_tetrahedron(pid,
+                                                      m.poly_vert(pid,0),
+                                                      m.poly_vert(pid,1),
+                                                      m.poly_vert(pid,2),
+                                                      m.poly_vert(pid,3)); break;
+                    default: assert(false && "Unsupported element");
+                }
+            });
+            refit();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class P>
+        void refit_from_mesh_edges(const AbstractMesh<M,V,E,P> & m)
+        {
+            assert(items.size()==m.num_edges());
+            PARALLEL_FOR(0, m.num_edges(), 1000, [&](uint eid)
+            {
+                update_segment(eid, m.edge_vert(eid,0), m.edge_vert(eid,1));
+            });
+            refit();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class P>
+        void refit_from_mesh_points(const AbstractMesh<M,V,E,P> & m)
+        {
+            assert(items.size()==m.num_verts());
+            PARALLEL_FOR(0, m.num_verts(), 1000, [&](uint vid)
+            {
+                update_point(vid, m.vert(vid));
+            });
+            refit();
+        }
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         template<class M, class V, class E, class P>
@@ -188,9 +300,29 @@ class Octree
         // QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         // returns pos, id and distance of the item that is closest to query point p
+        // (if many items are equally close, the first inserted one is returned)
         void  closest_point(const vec3d & p, uint & id, vec3d & pos, double & dist) const;
         vec3d closest_point(const vec3d & p) const;
 
+        // batch version of closest_point, with queries processed in parallel. For each point p[i]:
+        //  - index[i] is the position in vector items of the closest item (items.at(index[i])->id is its ID)
+        //  - pos[i] is the closest point, and bc[i] contains its barycentric coordinates w.r.t. the item
+        //    (2 for segments, 3 for triangles, 4 for tetrahedra. Unused entries are zero)
+        // Optional inputs:
+        //  - hint[i] is the index of an item that is likely to be close to p[i] (e.g. index[i] from
+        //    a previous call, if points moved only slightly). It is used to bound the search from the
+        //    very beginning, and can be set to -1 if unknown
+        //  - max_dist[i] restricts the search to the ball centered at p[i] with such radius.
+        //    If no item is found, index[i] is set to -1 and pos[i] is left equal to p[i]
+        void closest_points(const std::vector<vec3d>  & p,
+                                  std::vector<uint>   & index,
+                                  std::vector<vec3d>  & pos,
+                                  std::vector<vec4d>  & bc,
+                            const std::vector<uint>   & hint     = std::vector<uint>(),
+                            const std::vector<double> & max_dist = std::vector<double>()) const;
+        void closest_points(const std::vector<vec3d>  & p,
+                                  std::vector<vec3d>  & pos) const;
+
         // returns respectively the first item and the full list of items containing query point p
         // note: this query becomes exact if CINOLIB_USES_SHEWCHUK_PREDICATES is defined
         bool contains(const vec3d & p, const bool strict, uint & id) const;
@@ -201,6 +333,23 @@ class Octree
         bool intersects_ray(const vec3d & p, const vec3d & dir, double & min_t, uint & id) const; // first hit
         bool intersects_ray(const vec3d & p, const vec3d & dir, std::set<std::pair<double,uint>> & all_hits) const;
 
+        // returns all intersections between items in the octree and a line L(t) := p + t * dir, with t in (-inf,+inf)
+        bool intersects_line(const vec3d & p, const vec3d & dir, std::set<std::pair<double,uint>> & all_hits) const;
+
+        // returns the items intersecting the plane passing through p with normal n, and the items intersecting the
+        // slab of points x such that min <= x.dot(n) <= max (i.e. items crossing or lying in between two parallel planes)
+        bool intersects_plane(const vec3d & p, const vec3d & n, std::unordered_set<uint> & ids) const;
+        bool intersects_slab (const vec3d & n, const double min, const double max, std::unordered_set<uint> & ids) const;
+
+        // batch version of intersects_plane, for the family of parallel planes x.dot(n) = v0 + k*dv, with k in [0,n_planes).
+        // For example, n=(0,0,1) gives the planes z=v0+k*dv, as in the slicing of an object for 3D printing. The tree is
+        // traversed only once, and ids[k] contains the (sorted) ids of the items intersecting the k-th plane
+        void intersects_planes(const vec3d                    & n,
+                               const double                     v0,
+                               const double                     dv,
+                               const uint                       n_planes,
+                                     std::vector<std::vector<uint>> & ids) const;
+
         // note: these queries become exact if CINOLIB_USES_SHEWCHUK_PREDICATES is defined
         bool intersects_segment (const vec3d s[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const;
         bool intersects_triangle(const vec3d t[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const;
@@ -227,6 +376,36 @@ class Octree
         uint tree_depth = 0; // actual depth of the tree
         bool print_debug_info = false;
 
+        // parallel construction (see build)
+        uint parallel_split_threshold = 50000; // nodes with more items are split distributing items in parallel
+        uint spawn_threshold          = 1000;  // subtrees with more items are made in a separate task
+
+        std::vector<uint> free_slots;            // positions in vector items left empty by remove_item()
+        bool              refit_pending = false; // true if some item was updated after the last refit()
+
+        // SUPPORT METHODS :::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint add_item    (SpatialDataStructureItem *item);
+        bool insert_item (OctreeNode *node, const uint index, const uint depth);
+        void split_leaf  (OctreeNode *node, const uint depth);
+        void refit       (OctreeNode *node);
+        void update_leaves();
+
+        // depth first search of the item closest to p within sqrt(max_dist_sqrd), visiting closest
+        // children first and pruning nodes farther than the best item found so far. The search
+        // radius is initialized with the distance from item hint (if valid). Among equidistant
+        // items the lowest index wins, so that the result depends neither on the hint nor on
+        // the visit order. Returns false if no item is found. The stack is passed from outside,
+        // to be reused across queries
+        typedef std::pair<double,const OctreeNode*> NodeDist;
+        bool closest_item(const vec3d           & p,
+                          const uint              hint,
+                          const double            max_dist_sqrd,
+                          std::vector<NodeDist> & stack,
+                          uint                  & index,
+                          vec3d                 & pos,
+                          double                & dist_sqrd) const;
+
         // SUPPORT STRUCTURES ::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         struct Obj
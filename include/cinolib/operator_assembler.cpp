@@ -0,0 +1,411 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/operator_assembler.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <iostream>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void OperatorAssembler::clear()
+{
+    L_pattern = Pattern();
+    G_pattern = Pattern();
+    D_pattern = Pattern();
+    v2e_off.clear();
+    v2e_slot.clear();
+    diag_slot.clear();
+    edge_wgt.clear();
+    p2v_off.clear();
+    G_slot.clear();
+    D_slot.clear();
+    contrib.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double * OperatorAssembler::init_matrix(const Pattern & p, const int n, Eigen::SparseMatrix<double> & A)
+{
+    assert(n > 0);
+    int nnz = int(p.inner.size());
+    if(!A.isCompressed() || A.rows() != n*p.rows || A.cols() != n*p.cols || A.nonZeros() != n*nnz)
+    {
+        A.resize(n*p.rows, n*p.cols);
+        A.resizeNonZeros(n*nnz);
+    }
+
+    int * outer = A.outerIndexPtr();
+    int * inner = A.innerIndexPtr();
+    for(int b=0; b<n; ++b)
+    {
+        for(uint j=0; j<p.cols; ++j) outer[b*p.cols + j] = b*nnz + p.outer[j];
+        for(int  i=0; i<nnz;    ++i) inner[b*nnz    + i] = p.inner[i] + b*p.rows;
+    }
+    outer[n*p.cols] = n*nnz;
+
+    return A.valuePtr();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorAssembler::init_laplacian_pattern(const AbstractMesh<M,V,E,P> & m)
+{
+    uint nv = m.num_verts();
+    L_pattern.rows = nv;
+    L_pattern.cols = nv;
+    L_pattern.outer.resize(nv+1);
+    L_pattern.inner.resize(nv + 2*m.num_edges());
+    v2e_off.resize(nv+1);
+    v2e_slot.resize(2*m.num_edges());
+    diag_slot.resize(nv);
+    edge_wgt.resize(m.num_edges());
+
+    L_pattern.outer[0] = 0;
+    v2e_off[0]         = 0;
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        uint n_nbrs = uint(m.adj_v2e(vid).size());
+        L_pattern.outer[vid+1] = L_pattern.outer[vid] + n_nbrs + 1;
+        v2e_off[vid+1]         = v2e_off[vid] + n_nbrs;
+    }
+
+    // column vid contains the one ring of vid and vid itself, sorted by row
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+    {
+        std::vector<std::pair<uint,int>> col; // (row, position in adj_v2e, or -1 for the diagonal)
+        col.emplace_back(vid, -1);
+        int k = 0;
+        for(uint eid : m.adj_v2e(vid)) col.emplace_back(m.vert_opposite_to(eid,vid), k++);
+        std::sort(col.begin(), col.end());
+
+        int pos = L_pattern.outer[vid];
+        for(const auto & e : col)
+        {
+            L_pattern.inner[pos] = int(e.first);
+            if(e.second < 0) diag_slot[vid] = pos;
+            else             v2e_slot[v2e_off[vid] + e.second] = pos;
+            ++pos;
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorAssembler::laplacian(const AbstractMesh<M,V,E,P> & m,
+                                  const int                     mode,
+                                        Eigen::SparseMatrix<double> & L,
+                                  const int                     n)
+{
+    if(L_pattern.cols != m.num_verts() || edge_wgt.size() != m.num_edges())
+    {
+        init_laplacian_pattern(m);
+    }
+
+    // edge weights are symmetric: evaluate them once per edge
+    PARALLEL_FOR(0, m.num_edges(), 1000, [&](const uint eid)
+    {
+        edge_wgt[eid] = m.edge_weight(eid, mode);
+    });
+
+    double          * val = init_matrix(L_pattern, n, L);
+    std::vector<char> null_row(m.num_verts(), false);
+    PARALLEL_FOR(0, m.num_verts(), 1000, [&](const uint vid)
+    {
+        // same summation order as laplacian_matrix_entries
+        double sum = 0.0;
+        uint   k   = v2e_off[vid];
+        for(uint eid : m.adj_v2e(vid))
+        {
+            assert(L_pattern.inner[v2e_slot[k]] == int(m.vert_opposite_to(eid,vid)));
+            val[v2e_slot[k++]] = edge_wgt[eid];
+            sum -= edge_wgt[eid];
+        }
+        if(sum == 0.0)
+        {
+            null_row[vid] = true;
+            sum = 1.0;
+        }
+        val[diag_slot[vid]] = sum;
+    });
+
+    for(char b : null_row)
+    {
+        if(b) std::cerr << "WARNING: null row in the matrix! (disconnected vertex? I put 1 in the diagonal)" << std::endl;
+    }
+
+    uint nnz = uint(L_pattern.inner.size());
+    for(int b=1; b<n; ++b) std::copy(val, val+nnz, val+b*nnz);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorAssembler::mass_matrix(const AbstractMesh<M,V,E,P> & m,
+                                          Eigen::SparseMatrix<double> & MM,
+                                    const int                     n)
+{
+    Pattern diag;
+    diag.rows = m.num_verts();
+    diag.cols = m.num_verts();
+    diag.outer.resize(diag.cols+1);
+    diag.inner.resize(diag.cols);
+    for(uint i=0; i<diag.cols; ++i) diag.outer[i] = diag.inner[i] = int(i);
+    diag.outer[diag.cols] = int(diag.cols);
+
+    double * val = init_matrix(diag, n, MM);
+    PARALLEL_FOR(0, m.num_verts(), 1000, [&](const uint vid)
+    {
+        val[vid] = m.vert_mass(vid);
+    });
+
+    for(int b=1; b<n; ++b) std::copy(val, val+diag.cols, val+b*diag.cols);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorAssembler::init_element_patterns(const AbstractMesh<M,V,E,P> & m)
+{
+    uint nv = m.num_verts();
+    uint np = m.num_polys();
+
+    p2v_off.resize(np+1);
+    p2v_off[0] = 0;
+    for(uint pid=0; pid<np; ++pid) p2v_off[pid+1] = p2v_off[pid] + uint(m.adj_p2v(pid).size());
+    uint n_slots = p2v_off[np];
+
+    G_slot.resize(n_slots);
+    D_slot.resize(n_slots);
+    contrib.resize(n_slots);
+
+    // gradient: column vid has 3 rows for each element incident to it
+    G_pattern.rows = 3*np;
+    G_pattern.cols = nv;
+    G_pattern.outer.resize(nv+1);
+    G_pattern.inner.resize(3*n_slots);
+    G_pattern.outer[0] = 0;
+    for(uint vid=0; vid<nv; ++vid) G_pattern.outer[vid+1] = G_pattern.outer[vid] + 3*int(m.adj_v2p(vid).size());
+
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+    {
+        std::vector<uint> pids = m.adj_v2p(vid);
+        std::sort(pids.begin(), pids.end());
+        int pos = G_pattern.outer[vid];
+        for(uint pid : pids)
+        {
+            const std::vector<uint> & p2v = m.adj_p2v(pid);
+            uint k = uint(std::find(p2v.begin(), p2v.end(), vid) - p2v.begin());
+            G_slot[p2v_off[pid]+k] = pos;
+            for(int c=0; c<3; ++c) G_pattern.inner[pos++] = int(3*pid+c);
+        }
+    });
+
+    // divergence: column 3*pid+c has a row for each vertex of element pid
+    D_pattern.rows = nv;
+    D_pattern.cols = 3*np;
+    D_pattern.outer.resize(3*np+1);
+    D_pattern.inner.resize(3*n_slots);
+    for(uint pid=0; pid<np; ++pid)
+    {
+        uint k = p2v_off[pid+1] - p2v_off[pid];
+        for(uint c=0; c<3; ++c) D_pattern.outer[3*pid+c] = int(3*p2v_off[pid] + c*k);
+    }
+    D_pattern.outer[3*np] = int(3*n_slots);
+
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+    {
+        const std::vector<uint> & p2v = m.adj_p2v(pid);
+        std::vector<std::pair<uint,uint>> rows; // (vid, k)
+        for(uint k=0; k<p2v.size(); ++k) rows.emplace_back(p2v[k], k);
+        std::sort(rows.begin(), rows.end());
+        for(uint r=0; r<rows.size(); ++r)
+        {
+            D_slot[p2v_off[pid]+rows[r].second] = D_pattern.outer[3*pid] + int(r);
+            for(uint c=0; c<3; ++c) D_pattern.inner[D_pattern.outer[3*pid+c] + r] = int(rows[r].first);
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same formulas as gradient_matrix (per poly), see gradient.cpp
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorAssembler::gradient_contributions(const AbstractPolygonMesh<M,V,E,P> & m)
+{
+    if(G_pattern.cols != m.num_verts() || p2v_off.size() != m.num_polys()+1)
+    {
+        init_element_patterns(m);
+    }
+
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
+    {
+        double area = std::max(m.poly_area(pid), 1e-5) * 2.0; // (2 is the average term : two verts for each edge)
+        vec3d  n    = m.poly_data(pid).normal;
+        uint   nvp  = m.verts_per_poly(pid);
+
+        for(uint off=0; off<nvp; ++off)
+        {
+            uint  prev = m.poly_vert_id(pid,off);
+            uint  curr = m.poly_vert_id(pid,(off+1)%nvp);
+            uint  next = m.poly_vert_id(pid,(off+2)%nvp);
+            vec3d u    = m.vert(next) - m.vert(curr);
+            vec3d v    = m.vert(curr) - m.vert(prev);
+            vec3d u_90 = u.cross(n); u_90.normalize();
+            vec3d v_90 = v.cross(n); v_90.normalize();
+
+            vec3d per_vert_sum_over_edge_normals = u_90 * u.norm() + v_90 * v.norm();
+            per_vert_sum_over_edge_normals /= area;
+            contrib[p2v_off[pid] + (off+1)%nvp] = per_vert_sum_over_edge_normals;
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same formulas as gradient_matrix (per poly), see gradient.cpp
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void OperatorAssembler::gradient_contributions(const AbstractPolyhedralMesh<M,V,E,F,P> & m)
+{
+    if(G_pattern.cols != m.num_verts() || p2v_off.size() != m.num_polys()+1)
+    {
+        init_element_patterns(m);
+    }
+
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
+    {
+        double vol = std::max(m.poly_volume(pid), 1e-5);
+        uint   k   = p2v_off[pid];
+
+        for(uint vid : m.adj_p2v(pid))
+        {
+            vec3d per_vert_sum_over_f_normals(0,0,0);
+            for(uint fid : m.adj_p2f(pid))
+            {
+                if (m.face_contains_vert(fid,vid))
+                {
+                    vec3d  n   = m.poly_face_normal(pid,fid);
+                    double a   = m.face_area(fid);
+                    double avg = static_cast<double>(m.verts_per_face(fid));
+                    per_vert_sum_over_f_normals += (n*a)/avg;
+                }
+            }
+            per_vert_sum_over_f_normals /= vol;
+            contrib[k++] = per_vert_sum_over_f_normals;
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void OperatorAssembler::scatter_gradient(Eigen::SparseMatrix<double> & G) const
+{
+    double * val = init_matrix(G_pattern, 1, G);
+    PARALLEL_FOR(0, uint(contrib.size()), 1000, [&](const uint s)
+    {
+        for(int c=0; c<3; ++c) val[G_slot[s]+c] = contrib[s][c];
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void OperatorAssembler::scatter_divergence(Eigen::SparseMatrix<double> & D) const
+{
+    double * val = init_matrix(D_pattern, 1, D);
+    PARALLEL_FOR(0, uint(p2v_off.size()-1), 1000, [&](const uint pid)
+    {
+        uint k = p2v_off[pid+1] - p2v_off[pid];
+        for(uint s=p2v_off[pid]; s<p2v_off[pid+1]; ++s)
+        for(uint c=0; c<3; ++c)
+        {
+            val[D_slot[s] + c*k] = contrib[s][c];
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorAssembler::gradient_matrix(const AbstractPolygonMesh<M,V,E,P> & m, Eigen::SparseMatrix<double> & G)
+{
+    gradient_contributions(m);
+    scatter_gradient(G);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void OperatorAssembler::gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, Eigen::SparseMatrix<double> & G)
+{
+    gradient_contributions(m);
+    scatter_gradient(G);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorAssembler::divergence_matrix(const AbstractPolygonMesh<M,V,E,P> & m, Eigen::SparseMatrix<double> & D)
+{
+    gradient_contributions(m);
+    scatter_divergence(D);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void OperatorAssembler::divergence_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, Eigen::SparseMatrix<double> & D)
+{
+    gradient_contributions(m);
+    scatter_divergence(D);
+}
+
+}
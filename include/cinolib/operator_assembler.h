@@ -0,0 +1,169 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_OPERATOR_ASSEMBLER_H
+#define CINO_OPERATOR_ASSEMBLER_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+#include <Eigen/Sparse>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Assembly of the discrete differential operators of a mesh (Laplacian,
+ * mass, per element gradient and divergence) directly in compressed sparse
+ * format, without going through triplet lists and setFromTriplets.
+ *
+ * The sparsity pattern of each operator only depends on the connectivity.
+ * It is computed at the first request and kept, together with the position
+ * that each geometric contribution occupies in the compressed arrays, so
+ * that re-assembling the operators after the mesh geometry has changed
+ * (e.g. at each iteration of a flow or of a deformation loop) only costs
+ * the evaluation of the coefficients, which happens in parallel:
+ *
+ *  - Laplacian: edge weights are evaluated once per edge (and not once per
+ *    edge endpoint, as in laplacian_matrix_entries), then each column is
+ *    filled independently;
+ *  - gradient/divergence: contributions are evaluated once per element, and
+ *    scattered in both the gradient matrix (one column per vertex) and its
+ *    transpose (one column per element coordinate).
+ *
+ * Coefficients are computed with the same formulas used by laplacian(),
+ * mass_matrix() and gradient_matrix(), hence the output is the same, bit by
+ * bit. If the output matrix already has the right size and number of non
+ * zeros, its memory is reused.
+ *
+ * Patterns are NOT updated automatically if the connectivity changes (only
+ * element counts are checked). Call clear() after topological edits.
+*/
+
+class OperatorAssembler
+{
+    public:
+
+        explicit OperatorAssembler() {}
+
+        void clear();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // same as laplacian(m,mode,n), see laplacian.h
+        template<class M, class V, class E, class P>
+        void laplacian(const AbstractMesh<M,V,E,P> & m,
+                       const int                     mode,
+                             Eigen::SparseMatrix<double> & L,
+                       const int                     n = 1);
+
+        // same as mass_matrix(m,n), see vertex_mass.h
+        template<class M, class V, class E, class P>
+        void mass_matrix(const AbstractMesh<M,V,E,P> & m,
+                               Eigen::SparseMatrix<double> & MM,
+                         const int                     n = 1);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // same as gradient_matrix(m,true), see gradient.h (3 #polys x #verts)
+        template<class M, class V, class E, class P>
+        void gradient_matrix(const AbstractPolygonMesh<M,V,E,P> & m, Eigen::SparseMatrix<double> & G);
+
+        template<class M, class V, class E, class F, class P>
+        void gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, Eigen::SparseMatrix<double> & G);
+
+        // transpose of the per element gradient (#verts x 3 #polys), see divergence.h
+        template<class M, class V, class E, class P>
+        void divergence_matrix(const AbstractPolygonMesh<M,V,E,P> & m, Eigen::SparseMatrix<double> & D);
+
+        template<class M, class V, class E, class F, class P>
+        void divergence_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, Eigen::SparseMatrix<double> & D);
+
+    protected:
+
+        // compressed column arrays of a sparse matrix
+        struct Pattern
+        {
+            uint             rows = 0;
+            uint             cols = 0;
+            std::vector<int> outer;
+            std::vector<int> inner;
+        };
+
+        template<class M, class V, class E, class P>
+        void init_laplacian_pattern(const AbstractMesh<M,V,E,P> & m);
+
+        template<class M, class V, class E, class P>
+        void init_element_patterns(const AbstractMesh<M,V,E,P> & m);
+
+        template<class M, class V, class E, class P>
+        void gradient_contributions(const AbstractPolygonMesh<M,V,E,P> & m);
+
+        template<class M, class V, class E, class F, class P>
+        void gradient_contributions(const AbstractPolyhedralMesh<M,V,E,F,P> & m);
+
+        void scatter_gradient  (Eigen::SparseMatrix<double> & G) const;
+        void scatter_divergence(Eigen::SparseMatrix<double> & D) const;
+
+        // copies the pattern into A (replicated n times along the diagonal)
+        // and returns a pointer to the values of the first block
+        static double * init_matrix(const Pattern & p, const int n, Eigen::SparseMatrix<double> & A);
+
+        // Laplacian: vertex columns (one ring + diagonal), and the position
+        // of each entry of adj_v2e (flattened) and of each diagonal element
+        Pattern             L_pattern;
+        std::vector<uint>   v2e_off;
+        std::vector<int>    v2e_slot;
+        std::vector<int>    diag_slot;
+        std::vector<double> edge_wgt;
+
+        // per element operators: the k-th vertex of element pid is element
+        // slot p2v_off[pid]+k. For each slot, the position of its first
+        // coefficient in the gradient (3 consecutive rows in the column of
+        // the vertex) and in the divergence (one per coordinate column)
+        Pattern             G_pattern, D_pattern;
+        std::vector<uint>   p2v_off;
+        std::vector<int>    G_slot;
+        std::vector<int>    D_slot;
+        std::vector<vec3d>  contrib;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "operator_assembler.cpp"
+#endif
+
+#endif // CINO_OPERATOR_ASSEMBLER_H
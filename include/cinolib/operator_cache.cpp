@@ -0,0 +1,187 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/operator_cache.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/vertex_mass.h>
+#include <algorithm>
+#include <tuple>
+
+namespace cinolib
+{
+
+namespace
+{
+enum
+{
+    HEAT_FLOW_SYSTEM,
+    POLYHARMONIC_SYSTEM,
+};
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool OperatorCache::SystemKey::operator<(const SystemKey & k) const
+{
+    return std::tie(  type,   laplacian_mode,   param,   solver,   constrained) <
+           std::tie(k.type, k.laplacian_mode, k.param, k.solver, k.constrained);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void OperatorCache::clear()
+{
+    has_mesh   = false;
+    mesh_hash  = 0;
+    has_MM     = false;
+    MM         = Eigen::SparseMatrix<double>();
+    L.clear();
+    systems.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void OperatorCache::sync(const AbstractMesh<M,V,E,P> & m)
+{
+    uint64_t h = m.content_hash();
+    if(has_mesh && mesh_hash == h) return;
+    clear();
+    has_mesh  = true;
+    mesh_hash = h;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & OperatorCache::laplacian(const AbstractMesh<M,V,E,P> & m,
+                                                             const int                     mode)
+{
+    sync(m);
+    auto it = L.find(mode);
+    if(it == L.end()) it = L.emplace(mode, cinolib::laplacian(m, mode)).first;
+    return it->second;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & OperatorCache::mass_matrix(const AbstractMesh<M,V,E,P> & m)
+{
+    sync(m);
+    if(!has_MM)
+    {
+        MM     = cinolib::mass_matrix(m);
+        has_MM = true;
+    }
+    return MM;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+PrefactoredSystem & OperatorCache::heat_flow_system(const AbstractMesh<M,V,E,P> & m,
+                                                    const double                  time,
+                                                    const int                     laplacian_mode,
+                                                    const std::vector<uint>     & constrained,
+                                                    const int                     solver)
+{
+    sync(m);
+    bool is_new;
+    PrefactoredSystem & sys = system({HEAT_FLOW_SYSTEM, laplacian_mode, time, solver, constrained}, is_new);
+    if(is_new)
+    {
+        sys.factorize(mass_matrix(m) - time * laplacian(m, laplacian_mode), constrained, solver);
+        ++n_factorizations;
+    }
+    return sys;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+PrefactoredSystem & OperatorCache::polyharmonic_system(const AbstractMesh<M,V,E,P> & m,
+                                                       const uint                    n,
+                                                       const int                     laplacian_mode,
+                                                       const std::vector<uint>     & constrained,
+                                                       const int                     solver)
+{
+    assert(n > 0);
+    sync(m);
+    bool is_new;
+    PrefactoredSystem & sys = system({POLYHARMONIC_SYSTEM, laplacian_mode, double(n), solver, constrained}, is_new);
+    if(is_new)
+    {
+        const Eigen::SparseMatrix<double> & Lm = laplacian(m, laplacian_mode);
+        Eigen::SparseMatrix<double> Ln = -Lm;
+        for(uint i=1; i<n; ++i) Ln = Ln * (-Lm); // keep it PSD
+        sys.factorize(Ln, constrained, solver);
+        ++n_factorizations;
+    }
+    return sys;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+PrefactoredSystem & OperatorCache::system(const SystemKey & key, bool & is_new)
+{
+    auto it = systems.find(key);
+    is_new  = (it == systems.end());
+    if(is_new)
+    {
+        if(max_systems > 0 && systems.size() >= max_systems)
+        {
+            auto lru = systems.begin();
+            for(auto jt=systems.begin(); jt!=systems.end(); ++jt)
+            {
+                if(jt->second.last_use < lru->second.last_use) lru = jt;
+            }
+            systems.erase(lru);
+        }
+        it = systems.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first;
+    }
+    it->second.last_use = ++clock;
+    return it->second.sys;
+}
+
+}
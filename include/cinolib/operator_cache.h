@@ -0,0 +1,159 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_OPERATOR_CACHE_H
+#define CINO_OPERATOR_CACHE_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/linear_solvers.h>
+#include <cinolib/meshes/abstract_mesh.h>
+#include <cinolib/symbols.h>
+#include <Eigen/Sparse>
+#include <map>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Cache of the differential operators of a mesh, and of the (prefactored)
+ * linear systems built on top of them. Routines that solve diffusion or
+ * harmonic problems (e.g. heat_flow, harmonic_map) accept a cache as an
+ * optional argument: the first call assembles and factorizes the system,
+ * subsequent calls with the same mesh, Laplacian mode, time step (or
+ * harmonic order), solver and set of constrained vertices only pay for the
+ * back substitution, regardless of the right hand side and boundary values.
+ *
+ * The cache refers to one mesh at a time, identified by its content (see
+ * AbstractMesh::content_hash, which is evaluated at each call). Whenever it
+ * is used with a mesh having different vertex positions or connectivity
+ * (because vertices were moved, the mesh was edited or reassigned, or it is
+ * another mesh altogether), all its content is dropped and recomputed.
+ * Factorized systems are kept up to max_systems; when the limit is exceeded
+ * the least recently used one is discarded. Neither the cache nor the systems
+ * it returns can be used by multiple threads at once (see PrefactoredSystem).
+ *
+ * Example: interactive harmonic field with fixed constraints and changing values
+ *
+ *     OperatorCache cache;
+ *     ...
+ *     ScalarField f = harmonic_map(m, cache, bc); // assembly + factorization
+ *     ...
+ *     ScalarField g = harmonic_map(m, cache, bc); // back substitution only
+*/
+
+class OperatorCache
+{
+    public:
+
+        explicit OperatorCache(const uint max_systems = 8) : max_systems(max_systems) {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void clear();
+
+        uint num_factorizations() const { return n_factorizations; } // total, since construction
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class P>
+        const Eigen::SparseMatrix<double> & laplacian(const AbstractMesh<M,V,E,P> & m,
+                                                      const int                     mode = COTANGENT);
+
+        template<class M, class V, class E, class P>
+        const Eigen::SparseMatrix<double> & mass_matrix(const AbstractMesh<M,V,E,P> & m);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // heat flow operator (M - time * L)
+        template<class M, class V, class E, class P>
+        PrefactoredSystem & heat_flow_system(const AbstractMesh<M,V,E,P> & m,
+                                             const double                  time,
+                                             const int                     laplacian_mode = COTANGENT,
+                                             const std::vector<uint>     & constrained = {},
+                                             const int                     solver = SIMPLICIAL_LLT);
+
+        // n-harmonic operator (-L)^n
+        template<class M, class V, class E, class P>
+        PrefactoredSystem & polyharmonic_system(const AbstractMesh<M,V,E,P> & m,
+                                                const uint                    n,
+                                                const int                     laplacian_mode = COTANGENT,
+                                                const std::vector<uint>     & constrained = {},
+                                                const int                     solver = SIMPLICIAL_LLT);
+
+    protected:
+
+        struct SystemKey
+        {
+            int               type;
+            int               laplacian_mode;
+            double            param; // time step, or harmonic order
+            int               solver;
+            std::vector<uint> constrained;
+            bool operator<(const SystemKey & k) const;
+        };
+
+        struct SystemEntry
+        {
+            PrefactoredSystem sys;
+            uint              last_use = 0;
+        };
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class P>
+        void sync(const AbstractMesh<M,V,E,P> & m); // drops everything if the content of m is not the cached one
+
+        PrefactoredSystem & system(const SystemKey & key, bool & is_new);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool                                        has_mesh         = false;
+        uint64_t                                    mesh_hash        = 0;
+        uint                                        max_systems;
+        uint                                        n_factorizations = 0;
+        uint                                        clock            = 0;
+        std::map<int,Eigen::SparseMatrix<double>>   L;              // per Laplacian mode
+        Eigen::SparseMatrix<double>                 MM;
+        bool                                        has_MM           = false;
+        std::map<SystemKey,SystemEntry>             systems;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "operator_cache.cpp"
+#endif
+
+#endif // CINO_OPERATOR_CACHE_H
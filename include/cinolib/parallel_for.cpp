@@ -37,6 +37,9 @@
 #include <thread>
 #include <vector>
 #include <cmath>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 namespace cinolib
 {
@@ -96,4 +99,73 @@ static void PARALLEL_FOR(      uint   beg,
 #endif
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename Task, typename Func>
+CINO_INLINE
+static void PARALLEL_TASKS(const std::vector<Task> & tasks,
+                           const Func              & func)
+{
+#ifndef SERIALIZE_PARALLEL_FOR
+
+    const static unsigned n_threads_hint = std::thread::hardware_concurrency();
+    const static unsigned n_threads      = (n_threads_hint==0u) ? 8u : n_threads_hint;
+
+    std::vector<Task>       queue(tasks);
+    std::mutex              mutex;
+    std::condition_variable cv;
+    uint                    busy = 0; // number of threads currently processing a task
+
+    std::function<void(const Task&)> spawn = [&](const Task & t)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(t);
+        }
+        cv.notify_one();
+    };
+
+    auto worker = [&]()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for(;;)
+        {
+            // wait for a task, or until there is no more work (i.e. the queue
+            // is empty and no running task can spawn new ones)
+            cv.wait(lock, [&]{ return !queue.empty() || busy==0; });
+            if(queue.empty()) break;
+
+            Task t = queue.back();
+            queue.pop_back();
+            ++busy;
+            lock.unlock();
+
+            func(t, spawn);
+
+            lock.lock();
+            --busy;
+            if(busy==0 && queue.empty()) cv.notify_all();
+        }
+        cv.notify_all();
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(n_threads);
+    for(unsigned i=0; i<n_threads; ++i) pool.emplace_back(worker);
+    for(std::thread & t : pool)
+    {
+        if(t.joinable()) t.join();
+    }
+#else
+    std::vector<Task> queue(tasks);
+    std::function<void(const Task&)> spawn = [&](const Task & t) { queue.push_back(t); };
+    while(!queue.empty())
+    {
+        Task t = queue.back();
+        queue.pop_back();
+        func(t, spawn);
+    }
+#endif
+}
+
 }
@@ -38,6 +38,7 @@
 
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <vector>
 
 namespace cinolib
 {
@@ -85,6 +86,47 @@ static void PARALLEL_FOR(      uint   beg,
                                uint   end,
                          const uint   serial_if_less_than,
                          const Func & func);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Dynamic task scheduling, meant for workloads that cannot be split evenly in
+ * advance (e.g. the recursive construction of a spatial data structure, where
+ * the size of each subtree is not known a priori). A pool of threads consumes
+ * a shared list of tasks, and each task can spawn new tasks while running.
+ * Idle threads pick up spawned tasks as soon as they are available, hence the
+ * work is balanced across all the available cores.
+ *
+ * PARALLEL_TASKS has two arguments
+ *
+ *     tasks : initial list of tasks
+ *     func  : function that processes a task. It takes as arguments the task
+ *             and a spawn function, that can be called as spawn(new_task) to
+ *             schedule additional work
+ *
+ * Example of usage: visit a tree, processing small subtrees inline and
+ * spawning a new task for each large subtree
+ *
+ * PARALLEL_TASKS(roots, [&](Node *node, const std::function<void(Node*)> & spawn)
+ * {
+ *    ...
+ *    for(Node *child : node->children)
+ *    {
+ *        if(child->size() > 1000) spawn(child); else process(child);
+ *    }
+ * });
+ *
+ * NOTE: all threads share a single LIFO queue. This is good for coarse grained
+ * tasks, but too fine grained tasks (e.g. a few microseconds each) will suffer
+ * from contention. Small chunks of work should be processed inline instead.
+ *
+ * NOTE: if symbol SERIALIZE_PARALLEL_FOR is defined at compilation time,
+ * tasks will be executed serially, in LIFO order.
+*/
+
+template<typename Task, typename Func>
+CINO_INLINE
+static void PARALLEL_TASKS(const std::vector<Task> & tasks,
+                           const Func              & func);
 }
 
 #ifndef  CINO_STATIC_LIB
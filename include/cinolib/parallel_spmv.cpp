@@ -0,0 +1,84 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/parallel_spmv.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+namespace
+{
+// y[i] = dot product between x and the i-th outer vector of A
+template<class Matrix>
+CINO_INLINE
+void outer_spmv(const Matrix & A, const Eigen::VectorXd & x, Eigen::VectorXd & y)
+{
+    assert(x.size() == A.innerSize());
+    y.resize(A.outerSize());
+    PARALLEL_FOR(0, uint(A.outerSize()), 50000, [&](const uint i)
+    {
+        double sum = 0.0;
+        for(typename Matrix::InnerIterator it(A,i); it; ++it)
+        {
+            sum += it.value() * x[it.index()];
+        }
+        y[i] = sum;
+    });
+}
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void parallel_spmv(const Eigen::SparseMatrix<double,Eigen::RowMajor> & A,
+                   const Eigen::VectorXd                             & x,
+                         Eigen::VectorXd                             & y)
+{
+    outer_spmv(A,x,y);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void parallel_symmetric_spmv(const Eigen::SparseMatrix<double> & A,
+                             const Eigen::VectorXd             & x,
+                                   Eigen::VectorXd             & y)
+{
+    assert(A.rows() == A.cols());
+    outer_spmv(A,x,y);
+}
+
+}
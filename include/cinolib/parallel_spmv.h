@@ -0,0 +1,71 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_PARALLEL_SPMV_H
+#define CINO_PARALLEL_SPMV_H
+
+#include <cinolib/cino_inline.h>
+#include <Eigen/Sparse>
+
+namespace cinolib
+{
+
+/* Multithreaded sparse matrix - vector products y = A x, meant for the inner
+ * loops of iterative solvers. Each thread computes an independent block of
+ * entries of y, hence the product is only parallel when the matrix can be
+ * traversed by rows: this is the case of row major matrices, and of column
+ * major matrices that are symmetric (columns are the same as rows).
+ * Small products are executed serially (see PARALLEL_FOR)
+*/
+
+CINO_INLINE
+void parallel_spmv(const Eigen::SparseMatrix<double,Eigen::RowMajor> & A,
+                   const Eigen::VectorXd                             & x,
+                         Eigen::VectorXd                             & y);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// A must be symmetric
+CINO_INLINE
+void parallel_symmetric_spmv(const Eigen::SparseMatrix<double> & A,
+                             const Eigen::VectorXd             & x,
+                                   Eigen::VectorXd             & y);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "parallel_spmv.cpp"
+#endif
+
+#endif // CINO_PARALLEL_SPMV_H
@@ -54,6 +54,11 @@ namespace cinolib
  * CINOLIB_USES_SHEWCHUK_PREDICATES at compilation time.
  * *********************************************************************
  *
+ * Statically filtered versions of the basic predicates, as well as batch
+ * versions to test many points at once, are available in:
+ *
+ *   #include <cinolib/filtered_predicates.h>
+ *
  * Return values for the point_in_{segment | triangle | tet} predicates:
  * an integer flag which indicates exactly where, in the input simplex, the
  * point is located is returned. Note that a point tipically belongs to
@@ -35,10 +35,205 @@
 *********************************************************************************/
 #include <cinolib/shortest_path_tree.h>
 #include <cinolib/dijkstra.h>
+#include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <thread>
 
 namespace cinolib
 {
 
+namespace
+{
+    // non negative doubles have the same ordering of their bit patterns,
+    // hence distances can be updated with integer atomics
+    CINO_INLINE
+    uint64_t dist_bits(const double d)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(double));
+        return bits;
+    }
+
+    CINO_INLINE
+    double bits_dist(const uint64_t bits)
+    {
+        double d;
+        std::memcpy(&d, &bits, sizeof(double));
+        return d;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // Delta-stepping on a graph with n_nodes nodes, whose arcs are edges with
+    // non negative weights. inc(node) returns the edges incident to node, and
+    // other(eid,node) the node at the other side of edge eid (or -1, if the
+    // edge cannot be traversed). Within a bucket, the nodes to be relaxed are
+    // split in blocks, and each block collects the nodes it improves in its
+    // own list. Nodes improved into later buckets are parked there
+    template<typename Inc, typename Other>
+    CINO_INLINE
+    void delta_stepping(const uint                  n_nodes,
+                        const uint                  root,
+                        const std::vector<double> & weights,
+                        const Inc                 & inc,
+                        const Other               & other,
+                              std::vector<double> & dist)
+    {
+        assert(root < n_nodes);
+
+        double delta = 0;
+        for(double w : weights) { assert(w>=0); delta += w; }
+        delta = (weights.empty() || delta==0) ? 1.0 : delta/weights.size();
+
+        std::vector<std::atomic<uint64_t>> d(n_nodes);
+        PARALLEL_FOR(0, n_nodes, 10000, [&](uint i){ d[i].store(dist_bits(inf_double), std::memory_order_relaxed); });
+        d[root].store(dist_bits(0.0), std::memory_order_relaxed);
+
+        auto bucket_of = [&](const uint node)
+        {
+            return size_t(std::floor(bits_dist(d[node].load(std::memory_order_relaxed))/delta));
+        };
+
+        const uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+        const uint min_block = 256; // nodes per block
+
+        std::vector<std::vector<uint>> buckets(1, std::vector<uint>(1,root));
+        std::vector<uint>              stamp(n_nodes, 0); // last pass in which a node was scheduled
+        std::vector<uint>              frontier;
+        std::vector<std::vector<uint>> found;
+        uint pass = 0;
+        for(size_t k=0; k<buckets.size(); ++k)
+        {
+            ++pass;
+            frontier.clear();
+            for(uint node : buckets[k])
+            {
+                if(stamp[node]!=pass && bucket_of(node)==k) // skip stale entries and duplicates
+                {
+                    stamp[node] = pass;
+                    frontier.push_back(node);
+                }
+            }
+            std::vector<uint>().swap(buckets[k]);
+
+            while(!frontier.empty())
+            {
+                uint n_blocks = std::min(4*n_threads, uint(frontier.size()+min_block-1)/min_block);
+                found.assign(n_blocks, std::vector<uint>());
+                PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+                {
+                    for(size_t i=frontier.size()*b/n_blocks; i<frontier.size()*(b+1)/n_blocks; ++i)
+                    {
+                        uint   node = frontier[i];
+                        double dn   = bits_dist(d[node].load(std::memory_order_relaxed));
+                        for(uint eid : inc(node))
+                        {
+                            int nbr = other(eid,node);
+                            if(nbr<0) continue;
+                            uint64_t cand = dist_bits(dn + weights[eid]);
+                            uint64_t curr = d[nbr].load(std::memory_order_relaxed);
+                            bool improved = false;
+                            while(cand<curr && !(improved = d[nbr].compare_exchange_weak(curr, cand, std::memory_order_relaxed)));
+                            if(improved) found[b].push_back(uint(nbr));
+                        }
+                    }
+                });
+
+                // improved nodes either stay in the current bucket, or are parked in a later one
+                ++pass;
+                frontier.clear();
+                for(const auto & list : found)
+                for(uint node : list)
+                {
+                    size_t b = bucket_of(node);
+                    if(b==k)
+                    {
+                        if(stamp[node]==pass) continue;
+                        stamp[node] = pass;
+                        frontier.push_back(node);
+                    }
+                    else
+                    {
+                        if(b>=buckets.size()) buckets.resize(b+1);
+                        buckets[b].push_back(node);
+                    }
+                }
+            }
+        }
+
+        dist.resize(n_nodes);
+        PARALLEL_FOR(0, n_nodes, 10000, [&](uint i){ dist[i] = bits_dist(d[i].load(std::memory_order_relaxed)); });
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // each node picks as parent the neighbor with lowest ID among the ones that realize
+    // its shortest distance (and the lowest edge ID, if they are connected by multiple edges).
+    // Parents must be strictly closer to the root, otherwise arcs with zero weight could
+    // close loops: nodes that can be reached only through such arcs are attached afterwards
+    template<typename Inc, typename Other>
+    CINO_INLINE
+    void shortest_path_parents(const uint                  n_nodes,
+                               const uint                  root,
+                               const std::vector<double> & weights,
+                               const Inc                 & inc,
+                               const Other               & other,
+                               const std::vector<double> & dist,
+                                     std::vector<bool>   & tree,
+                                     std::vector<int>    & prev)
+    {
+        std::vector<int> prev_edge(n_nodes, -1);
+        prev.assign(n_nodes, -1);
+        PARALLEL_FOR(0, n_nodes, 10000, [&](uint node)
+        {
+            if(node==root || dist[node]==inf_double) return;
+            for(uint eid : inc(node))
+            {
+                int nbr = other(eid,node);
+                if(nbr<0 || dist[node] != weights[eid] + dist[nbr] || !(dist[nbr] < dist[node])) continue;
+                if(prev[node]<0 || nbr<prev[node] || (nbr==prev[node] && int(eid)<prev_edge[node]))
+                {
+                    prev[node]      = nbr;
+                    prev_edge[node] = int(eid);
+                }
+            }
+        });
+
+        auto pending = [&](const uint node) { return node!=root && dist[node]!=inf_double && prev[node]<0; };
+        bool any_pending = false;
+        for(uint node=0; node<n_nodes && !any_pending; ++node) any_pending = pending(node);
+        if(any_pending)
+        {
+            // BFS through zero weight arcs, starting from the nodes already in the tree
+            std::queue<uint> q;
+            for(uint node=0; node<n_nodes; ++node) if(node==root || prev[node]>=0) q.push(node);
+            while(!q.empty())
+            {
+                uint node = q.front();
+                q.pop();
+                for(uint eid : inc(node))
+                {
+                    int nbr = other(eid,node);
+                    if(nbr<0 || !pending(nbr) || dist[nbr] != weights[eid] + dist[node]) continue;
+                    prev[nbr]      = int(node);
+                    prev_edge[nbr] = int(eid);
+                    q.push(nbr);
+                }
+            }
+        }
+
+        tree.assign(weights.size(), false);
+        for(uint node=0; node<n_nodes; ++node) if(prev_edge[node]>=0) tree[prev_edge[node]] = true;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 /* Given a mesh and source vertex, computes the tree of shortest paths connecting
  * any vertex in the mesh with the root. The algorithm internally uses Dijkstra to
  * compute point to point distances, and generates the tree as described in
@@ -79,4 +274,69 @@ void shortest_path_tree(AbstractMesh<M,V,E,P> & m, const uint root, std::vector<
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_shortest_path_tree(const AbstractMesh<M,V,E,P> & m,
+                                 const uint                    root,
+                                       std::vector<bool>     & tree)
+{
+    std::vector<double> weights(m.num_edges());
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](uint eid){ weights[eid] = m.edge_length(eid); });
+
+    std::vector<double> dist;
+    std::vector<int>    prev;
+    parallel_shortest_path_tree(m, root, weights, std::vector<bool>(m.num_edges(),false), tree, dist, prev);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_shortest_path_tree(const AbstractMesh<M,V,E,P> & m,
+                                 const uint                    root,
+                                 const std::vector<double>   & weights,
+                                 const std::vector<bool>     & mask,
+                                       std::vector<bool>     & tree,
+                                       std::vector<double>   & dist,
+                                       std::vector<int>      & prev)
+{
+    assert(weights.size()==m.num_edges());
+    assert(mask.size()==m.num_edges());
+
+    auto inc   = [&](uint vid) -> const std::vector<uint> & { return m.adj_v2e(vid); };
+    auto other = [&](uint eid, uint vid) { return mask[eid] ? -1 : int(m.vert_opposite_to(eid,vid)); };
+
+    delta_stepping(m.num_verts(), root, weights, inc, other, dist);
+    shortest_path_parents(m.num_verts(), root, weights, inc, other, dist, tree, prev);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_shortest_path_tree_on_dual(const AbstractPolygonMesh<M,V,E,P> & m,
+                                         const uint                           root,
+                                         const std::vector<double>          & weights,
+                                         const std::vector<bool>            & mask,
+                                               std::vector<bool>            & tree,
+                                               std::vector<double>          & dist,
+                                               std::vector<int>             & prev)
+{
+    assert(weights.size()==m.num_edges());
+    assert(mask.size()==m.num_edges());
+
+    auto inc   = [&](uint pid) -> const std::vector<uint> & { return m.adj_p2e(pid); };
+    auto other = [&](uint eid, uint pid)
+    {
+        const std::vector<uint> & polys = m.adj_e2p(eid);
+        if(mask[eid] || polys.size()!=2) return -1;
+        return int(polys.front()==pid ? polys.back() : polys.front());
+    };
+
+    delta_stepping(m.num_polys(), root, weights, inc, other, dist);
+    shortest_path_parents(m.num_polys(), root, weights, inc, other, dist, tree, prev);
+}
+
 }
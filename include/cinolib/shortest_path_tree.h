@@ -52,6 +52,61 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void shortest_path_tree(AbstractMesh<M,V,E,P> & m, const uint root, std::vector<bool> & tree);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Parallel shortest path trees, meant for very large meshes. Distances are
+ * computed with delta-stepping (Meyer and Sanders, 2003): nodes are sorted in
+ * buckets of width delta (the average arc weight) according to their tentative
+ * distance, and all the nodes in the current bucket are relaxed in parallel,
+ * updating distances with atomic operations, until the bucket is empty.
+ *
+ * Distances are the same computed by Dijkstra's algorithm, bit by bit: for
+ * each node they are the minimum over the same set of sums, regardless of the
+ * order in which relaxations happen. The tree is then extracted as in the
+ * serial version: among the neighbors that realize the shortest distance the
+ * one with lowest ID becomes the parent (nodes reached only through arcs with
+ * zero weight, which could otherwise close loops, are attached with a BFS
+ * along such arcs). Hence trees are deterministic, and
+ * parallel_shortest_path_tree(m,root,tree) gives the same tree as the serial
+ * shortest_path_tree(m,root,tree).
+ *
+ * Besides the tree (tree[e] = true if edge e is in it) the distance from the
+ * root (inf_double for unreached nodes) and the parent of each node (-1 for
+ * the root and for unreached nodes) can be retrieved.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_shortest_path_tree(const AbstractMesh<M,V,E,P> & m,
+                                 const uint                    root,
+                                       std::vector<bool>     & tree);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_shortest_path_tree(const AbstractMesh<M,V,E,P> & m,
+                                 const uint                    root,
+                                 const std::vector<double>   & weights, // per edge weights (e.g. edge lengths)
+                                 const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
+                                       std::vector<bool>     & tree,
+                                       std::vector<double>   & dist,
+                                       std::vector<int>      & prev);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// shortest path tree of the polygons, rooted at polygon root. Dual edges are identified by the
+// (manifold) edge shared by their polygons: tree[e] = true if the dual edge crossing e is in the tree
+template<class M, class V, class E, class P>
+CINO_INLINE
+void parallel_shortest_path_tree_on_dual(const AbstractPolygonMesh<M,V,E,P> & m,
+                                         const uint                           root,
+                                         const std::vector<double>          & weights, // per edge weights (length of the dual edges)
+                                         const std::vector<bool>            & mask,    // if mask[e] = true, path cannot cross edge e
+                                               std::vector<bool>            & tree,
+                                               std::vector<double>          & dist,
+                                               std::vector<int>             & prev);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,864 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/signed_distance_field.h>
+#include <cinolib/fast_winding_number.h>
+#include <cinolib/serialize_index.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/predicates.h>
+#include <cinolib/geometry/triangle_utils.h>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <atomic>
+#include <limits>
+
+namespace cinolib
+{
+
+namespace
+{
+    // Sets up a grid with cubic voxels that contains the input points, padded
+    // by (at least) one voxel. The number of voxels along each axis is rounded
+    // up to a multiple of multiple_of
+    CINO_INLINE
+    void sdf_grid(const std::vector<vec3d> & verts,
+                  const SDFOptions         & opt,
+                  const uint                 multiple_of,
+                        AABB               & bbox,
+                        double             & len,
+                        uint                 dim[3])
+    {
+        assert(!verts.empty());
+        AABB box(verts);
+        len = box.delta().max_entry() / std::max(1u, opt.max_voxels_per_side);
+        if(len<=0) len = 1.0; // degenerate input (e.g. a single point)
+
+        uint pad = std::max(1u, opt.padding);
+        bbox.min = box.min - vec3d(pad*len, pad*len, pad*len);
+        for(int i=0; i<3; ++i)
+        {
+            dim[i] = uint(std::ceil(box.delta()[i]/len)) + 2*pad;
+            dim[i] = ((dim[i] + multiple_of - 1) / multiple_of) * multiple_of;
+            bbox.max[i] = bbox.min[i] + dim[i]*len;
+        }
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // range [beg,end] of the voxel centers o+(i+0.5)*len falling within the interval [a,b]
+    // (not clamped to the grid, and empty if beg>end)
+    CINO_INLINE
+    void sdf_center_range(const double a,
+                          const double b,
+                          const double o,
+                          const double len,
+                                int  & beg,
+                                int  & end)
+    {
+        beg = int(std::ceil ((a-o)/len - 0.5));
+        end = int(std::floor((b-o)/len - 0.5));
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // Finds all the segments connecting the centers of adjacent voxels that intersect
+    // the surface. Each segment is returned as a quadruple (i,j,k,axis), where (i,j,k)
+    // is the voxel with lowest coordinates. Triangles are processed in parallel chunks,
+    // hence the same segment may appear multiple times
+    CINO_INLINE
+    void sdf_crossed_segments(const std::vector<vec3d> & verts,
+                              const std::vector<uint>  & tris,
+                              const AABB               & bbox,
+                              const double               len,
+                              const uint                 dim[3],
+                                    std::vector<uint>  & segs)
+    {
+        const uint chunk    = 1000;
+        const uint n_tris   = uint(tris.size()/3);
+        const uint n_chunks = (n_tris + chunk - 1) / chunk;
+        std::vector<std::vector<uint>> buffers(n_chunks);
+        PARALLEL_FOR(0, n_chunks, 2, [&](uint c)
+        {
+            for(uint tid=c*chunk; tid<std::min(n_tris,(c+1)*chunk); ++tid)
+            {
+                const vec3d & t0 = verts.at(tris.at(3*tid+0));
+                const vec3d & t1 = verts.at(tris.at(3*tid+1));
+                const vec3d & t2 = verts.at(tris.at(3*tid+2));
+                AABB box(std::vector<vec3d>{t0,t1,t2});
+
+                int beg[3], end[3];
+                for(int d=0; d<3; ++d) sdf_center_range(box.min[d], box.max[d], bbox.min[d], len, beg[d], end[d]);
+
+                for(uint axis=0; axis<3; ++axis)
+                {
+                    // segments along axis: centers on the other two axes must fall within
+                    // the triangle bbox, and segments along axis must overlap with it
+                    int lo[3], hi[3];
+                    for(int d=0; d<3; ++d)
+                    {
+                        if(d==int(axis)) { lo[d] = std::max(0, beg[d]-1); hi[d] = std::min(int(dim[d])-2, end[d]); }
+                        else             { lo[d] = std::max(0, beg[d]);   hi[d] = std::min(int(dim[d])-1, end[d]); }
+                    }
+                    for(int i=lo[0]; i<=hi[0]; ++i)
+                    for(int j=lo[1]; j<=hi[1]; ++j)
+                    for(int k=lo[2]; k<=hi[2]; ++k)
+                    {
+                        vec3d s0 = bbox.min + vec3d(i+0.5, j+0.5, k+0.5)*len;
+                        vec3d s1 = s0;
+                        s1[axis] += len;
+                        if(segment_triangle_intersect_3d(s0, s1, t0, t1, t2)!=DO_NOT_INTERSECT)
+                        {
+                            buffers.at(c).insert(buffers.at(c).end(), {uint(i), uint(j), uint(k), axis});
+                        }
+                    }
+                }
+            }
+        });
+        segs.clear();
+        for(const auto & b : buffers) segs.insert(segs.end(), b.begin(), b.end());
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // For each triangle, computes the range of voxels whose center is within its bounding
+    // box, enlarged by the band width. Ranges are stored as boxes in voxel coordinates,
+    // already clamped to the grid (the padding ensures they are never empty)
+    CINO_INLINE
+    void sdf_band_boxes(const std::vector<vec3d> & verts,
+                        const std::vector<uint>  & tris,
+                        const AABB               & bbox,
+                        const double               len,
+                        const double               band,
+                        const uint                 dim[3],
+                              std::vector<AABB>  & boxes)
+    {
+        boxes.resize(tris.size()/3);
+        PARALLEL_FOR(0, uint(boxes.size()), 1000, [&](uint tid)
+        {
+            AABB box(std::vector<vec3d>{verts.at(tris.at(3*tid+0)),
+                                        verts.at(tris.at(3*tid+1)),
+                                        verts.at(tris.at(3*tid+2))});
+            for(int d=0; d<3; ++d)
+            {
+                int beg, end;
+                sdf_center_range(box.min[d]-band, box.max[d]+band, bbox.min[d], len, beg, end);
+                boxes[tid].min[d] = std::max(0, beg);
+                boxes[tid].max[d] = std::min(int(dim[d])-1, end);
+            }
+        });
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    vec3d sdf_closest_point(const std::vector<vec3d> & verts,
+                            const std::vector<uint>  & tris,
+                            const uint                 tid,
+                            const vec3d              & p)
+    {
+        return triangle_closest_point(p, verts[tris[3*tid+0]],
+                                         verts[tris[3*tid+1]],
+                                         verts[tris[3*tid+2]]);
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // Labels the connected components of a graph. The function nbrs(node,list) fills
+    // list with the neighbors of node, and returns false for ids that do not correspond
+    // to a node of the graph (their label will be -1)
+    template<typename Nbrs>
+    CINO_INLINE
+    uint sdf_connected_components(const size_t              n_nodes,
+                                  const Nbrs              & nbrs,
+                                        std::vector<uint> & comp)
+    {
+        comp.assign(n_nodes, uint(-1));
+        uint n_comps = 0;
+        std::vector<size_t> lifo, list;
+        for(size_t seed=0; seed<n_nodes; ++seed)
+        {
+            if(comp.at(seed)!=uint(-1) || !nbrs(seed,list)) continue;
+            comp.at(seed) = n_comps;
+            lifo.push_back(seed);
+            while(!lifo.empty())
+            {
+                size_t node = lifo.back();
+                lifo.pop_back();
+                nbrs(node,list);
+                for(size_t nbr : list)
+                {
+                    if(comp.at(nbr)==uint(-1))
+                    {
+                        comp.at(nbr) = n_comps;
+                        lifo.push_back(nbr);
+                    }
+                }
+            }
+            ++n_comps;
+        }
+        return n_comps;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // Classifies each connected component as inside (-1) or outside (+1).
+    // With SDF_SIGN_FLOOD_FILL, components containing at least one node on the grid boundary
+    // are outside. With SDF_SIGN_WINDING_NUMBER, each component is classified by evaluating
+    // the winding number at the position of its node farthest from the surface
+    template<typename OnBoundary, typename Dist, typename Pos>
+    CINO_INLINE
+    void sdf_component_signs(const std::vector<vec3d>       & verts,
+                             const std::vector<uint>        & tris,
+                             const int                        sign_mode,
+                             const std::vector<uint>        & comp,
+                             const uint                       n_comps,
+                             const OnBoundary               & on_boundary,
+                             const Dist                     & dist,
+                             const Pos                      & pos,
+                                   std::vector<signed char> & sign)
+    {
+        if(sign_mode==SDF_SIGN_WINDING_NUMBER)
+        {
+            std::vector<size_t> best(n_comps, 0);
+            std::vector<double> best_dist(n_comps, -1);
+            for(size_t node=0; node<comp.size(); ++node)
+            {
+                if(comp.at(node)==uint(-1)) continue;
+                double d = dist(node);
+                if(d>best_dist.at(comp.at(node)))
+                {
+                    best_dist.at(comp.at(node)) = d;
+                    best.at(comp.at(node))      = node;
+                }
+            }
+            std::vector<vec3d> points(n_comps);
+            for(uint c=0; c<n_comps; ++c) points.at(c) = pos(best.at(c));
+            std::vector<bool> inside;
+            FastWindingNumber(verts,tris).is_inside(points, inside);
+            sign.resize(n_comps);
+            for(uint c=0; c<n_comps; ++c) sign.at(c) = inside.at(c) ? -1 : 1;
+        }
+        else
+        {
+            sign.assign(n_comps, -1);
+            for(size_t node=0; node<comp.size(); ++node)
+            {
+                if(comp.at(node)!=uint(-1) && on_boundary(node)) sign.at(comp.at(node)) = 1;
+            }
+        }
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // Fast sweeping for the eikonal equation |grad(u)|=1 on a regular grid with spacing h.
+    // Frozen voxels are not updated. The grid is split into tiles, and within each sweep
+    // tiles on the same diagonal plane (ti+tj+tk=const) do not depend on each other, hence
+    // they are processed in parallel. Each tile is swept in memory order, to retain locality
+    CINO_INLINE
+    void sdf_fast_sweeping(      std::vector<float>   & u,
+                           const std::vector<uint8_t> & frozen,
+                           const uint                   dim[3],
+                           const double                 h)
+    {
+        const int    T         = 8; // tile size
+        const int    n[3]      = { int(dim[0]), int(dim[1]), int(dim[2]) };
+        const int    nt[3]     = { (n[0]+T-1)/T, (n[1]+T-1)/T, (n[2]+T-1)/T };
+        const int    stride[3] = { n[1]*n[2], n[2], 1 };
+        const float  inf       = std::numeric_limits<float>::max();
+        const double tol       = 1e-3*h; // smaller updates are not worth another round of sweeps
+
+        auto update = [&](const int ijk[3]) -> bool
+        {
+            int index = ijk[0]*stride[0] + ijk[1]*stride[1] + ijk[2];
+            if(frozen[index]) return false;
+
+            // smallest neighbor along each axis
+            double a[3];
+            for(int d=0; d<3; ++d)
+            {
+                float ad = inf;
+                if(ijk[d]>0)      ad = std::min(ad, u[index-stride[d]]);
+                if(ijk[d]<n[d]-1) ad = std::min(ad, u[index+stride[d]]);
+                a[d] = ad;
+            }
+            if(a[0]>a[1]) std::swap(a[0],a[1]);
+            if(a[1]>a[2]) std::swap(a[1],a[2]);
+            if(a[0]>a[1]) std::swap(a[0],a[1]);
+            if(a[0]==inf) return false;
+
+            // Godunov upwind discretization
+            double x = a[0] + h;
+            if(x>a[1])
+            {
+                x = 0.5*(a[0] + a[1] + std::sqrt(2*h*h - (a[0]-a[1])*(a[0]-a[1])));
+                if(x>a[2])
+                {
+                    double s  = a[0] + a[1] + a[2];
+                    double s2 = a[0]*a[0] + a[1]*a[1] + a[2]*a[2];
+                    x = (s + std::sqrt(s*s - 3*(s2 - h*h)))/3.0;
+                }
+            }
+            if(x<u[index]-tol)
+            {
+                u[index] = float(x);
+                return true;
+            }
+            return false;
+        };
+
+        for(uint round=0; round<4; ++round)
+        {
+            std::atomic<bool> changed(false);
+            for(int dir=0; dir<8; ++dir)
+            {
+                const bool flip[3] = { bool(dir&1), bool(dir&2), bool(dir&4) };
+                for(int P=0; P<=nt[0]+nt[1]+nt[2]-3; ++P)
+                {
+                    // tiles on plane P (in sweep order coordinates)
+                    std::vector<vec3i> tiles;
+                    for(int ti=std::max(0,P-(nt[1]-1)-(nt[2]-1)); ti<=std::min(nt[0]-1,P); ++ti)
+                    for(int tj=std::max(0,P-ti-(nt[2]-1));        tj<=std::min(nt[1]-1,P-ti); ++tj)
+                    {
+                        tiles.push_back(vec3i(ti, tj, P-ti-tj));
+                    }
+                    PARALLEL_FOR(0, uint(tiles.size()), 2, [&](uint t)
+                    {
+                        bool tile_changed = false;
+                        int  beg[3], end[3];
+                        for(int d=0; d<3; ++d)
+                        {
+                            beg[d] = tiles[t][d]*T;
+                            end[d] = std::min(n[d], beg[d]+T);
+                        }
+                        int ijk[3];
+                        for(int ii=beg[0]; ii<end[0]; ++ii)
+                        for(int jj=beg[1]; jj<end[1]; ++jj)
+                        for(int kk=beg[2]; kk<end[2]; ++kk)
+                        {
+                            ijk[0] = flip[0] ? n[0]-1-ii : ii;
+                            ijk[1] = flip[1] ? n[1]-1-jj : jj;
+                            ijk[2] = flip[2] ? n[2]-1-kk : kk;
+                            if(update(ijk)) tile_changed = true;
+                        }
+                        if(tile_changed) changed = true;
+                    });
+                }
+            }
+            if(!changed) break;
+        }
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    double sdf_trilinear(const AABB                                    & bbox,
+                         const double                                    len,
+                         const uint                                      dim[3],
+                         const std::function<float(uint,uint,uint)>    & at,
+                         const vec3d                                   & p)
+    {
+        uint   i0[3], i1[3];
+        double t[3];
+        for(int d=0; d<3; ++d)
+        {
+            double x = (p[d]-bbox.min[d])/len - 0.5;
+            x = std::max(0.0, std::min(double(dim[d]-1), x));
+            i0[d] = std::min(uint(x), dim[d]-1);
+            i1[d] = std::min(i0[d]+1, dim[d]-1);
+            t[d]  = x - i0[d];
+        }
+        double v = 0;
+        for(uint c=0; c<8; ++c)
+        {
+            double w = ((c&1) ? t[0] : 1-t[0]) *
+                       ((c&2) ? t[1] : 1-t[1]) *
+                       ((c&4) ? t[2] : 1-t[2]);
+            if(w==0) continue;
+            v += w * at((c&1) ? i1[0] : i0[0],
+                        (c&2) ? i1[1] : i0[1],
+                        (c&4) ? i1[2] : i0[2]);
+        }
+        return v;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    template<class M, class V, class E, class P>
+    CINO_INLINE
+    std::vector<uint> sdf_tessellation(const AbstractPolygonMesh<M,V,E,P> & m)
+    {
+        std::vector<uint> tris;
+        for(uint pid=0; pid<m.num_polys(); ++pid)
+        {
+            const std::vector<uint> & tess = m.poly_tessellation(pid);
+            tris.insert(tris.end(), tess.begin(), tess.end());
+        }
+        return tris;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    void sdf_classify_voxels(const AABB                                 & bbox,
+                             const double                                 len,
+                             const uint                                   dim[3],
+                             const std::function<float(uint,uint,uint)> & at,
+                             const double                                 iso,
+                                   VoxelGrid                            & g)
+    {
+        g.bbox   = bbox;
+        g.len    = len;
+        g.dim[0] = dim[0];
+        g.dim[1] = dim[1];
+        g.dim[2] = dim[2];
+        uint size = dim[0]*dim[1]*dim[2];
+        delete[] g.voxels;
+        g.voxels = new int[size];
+        const double half_diag = 0.5*std::sqrt(3.0)*len;
+        PARALLEL_FOR(0, size, 100000, [&](uint index)
+        {
+            vec3u  ijk = deserialize_3D_index(index, dim[1], dim[2]);
+            double d   = at(ijk[0], ijk[1], ijk[2]) - iso;
+            if(d < -half_diag) g.voxels[index] = VOXEL_INSIDE;  else
+            if(d >  half_diag) g.voxels[index] = VOXEL_OUTSIDE; else
+                               g.voxels[index] = VOXEL_BOUNDARY;
+        });
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+float SignedDistanceField::at(const uint i, const uint j, const uint k) const
+{
+    return dist.at(serialize_3D_index(i, j, k, dim[1], dim[2]));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+vec3d SignedDistanceField::voxel_center(const uint i, const uint j, const uint k) const
+{
+    return bbox.min + vec3d(i+0.5, j+0.5, k+0.5)*len;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double SignedDistanceField::sample(const vec3d & p) const
+{
+    return sdf_trilinear(bbox, len, dim, [this](uint i, uint j, uint k){ return at(i,j,k); }, p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+float SparseSignedDistanceField::at(const uint i, const uint j, const uint k) const
+{
+    uint block = serialize_3D_index(i/block_size, j/block_size, k/block_size, block_dim[1], block_dim[2]);
+    int  slot  = block_index.at(block);
+    if(slot<0) return block_sign.at(block)*background;
+    uint local = serialize_3D_index(i%block_size, j%block_size, k%block_size, block_size, block_size);
+    return values.at(size_t(slot)*block_size*block_size*block_size + local);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+vec3d SparseSignedDistanceField::voxel_center(const uint i, const uint j, const uint k) const
+{
+    return bbox.min + vec3d(i+0.5, j+0.5, k+0.5)*len;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double SparseSignedDistanceField::sample(const vec3d & p) const
+{
+    return sdf_trilinear(bbox, len, dim, [this](uint i, uint j, uint k){ return at(i,j,k); }, p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint SparseSignedDistanceField::num_allocated_blocks() const
+{
+    return uint(values.size()/(block_size*block_size*block_size));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void signed_distance_field(const AbstractPolygonMesh<M,V,E,P> & m,
+                                 SignedDistanceField          & sdf,
+                           const SDFOptions                   & opt)
+{
+    signed_distance_field(m.vector_verts(), sdf_tessellation(m), sdf, opt);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void signed_distance_field(const std::vector<vec3d> & verts,
+                           const std::vector<uint>  & tris,
+                                 SignedDistanceField & sdf,
+                           const SDFOptions          & opt)
+{
+    sdf_grid(verts, opt, 1, sdf.bbox, sdf.len, sdf.dim);
+    const uint * dim  = sdf.dim;
+    const uint   size = dim[0]*dim[1]*dim[2];
+    sdf.dist.assign(size, std::numeric_limits<float>::max());
+
+    // exact (unsigned) distances within the narrow band. Each triangle updates
+    // the voxels whose center falls within its bounding box, enlarged by the band
+    // width. To avoid races, triangles are bucketed by the voxel slabs (i=const)
+    // they overlap, and slabs are processed in parallel
+    const double band = std::max(1u, opt.narrow_band) * sdf.len;
+    std::vector<AABB> boxes;
+    std::vector<std::vector<uint>> slab_tris(dim[0]);
+    sdf_band_boxes(verts, tris, sdf.bbox, sdf.len, band, dim, boxes);
+    for(uint tid=0; tid<boxes.size(); ++tid)
+    {
+        for(uint i=uint(boxes[tid].min[0]); i<=uint(boxes[tid].max[0]); ++i) slab_tris[i].push_back(tid);
+    }
+    std::vector<uint8_t> in_band(size, 0);
+    PARALLEL_FOR(0, dim[0], 1, [&](uint i)
+    {
+        for(uint tid : slab_tris[i])
+        {
+            const AABB & b = boxes[tid];
+            for(uint j=uint(b.min[1]); j<=uint(b.max[1]); ++j)
+            for(uint k=uint(b.min[2]); k<=uint(b.max[2]); ++k)
+            {
+                uint  index = serialize_3D_index(i, j, k, dim[1], dim[2]);
+                vec3d p     = sdf.voxel_center(i, j, k);
+                float d     = float(p.dist(sdf_closest_point(verts, tris, tid, p)));
+                sdf.dist[index] = std::min(sdf.dist[index], d);
+            }
+        }
+        // a voxel at distance d<=band from a triangle is within its enlarged bbox, hence
+        // values below the band width are exact. Larger values are just upper bounds
+        for(uint index=i*dim[1]*dim[2]; index<(i+1)*dim[1]*dim[2]; ++index)
+        {
+            in_band[index] = (sdf.dist[index]<=band);
+        }
+    });
+
+    // propagate distances to the rest of the grid
+    sdf_fast_sweeping(sdf.dist, in_band, dim, sdf.len);
+
+    // sign computation: voxels are grouped into clusters that can be connected
+    // without crossing the surface, and each cluster is then classified at once
+    std::vector<uint> segs;
+    sdf_crossed_segments(verts, tris, sdf.bbox, sdf.len, dim, segs);
+    std::vector<uint8_t> crossed(size, 0); // bit i: the segment towards the next voxel along axis i is crossed
+    for(uint i=0; i<segs.size(); i+=4)
+    {
+        crossed[serialize_3D_index(segs[i], segs[i+1], segs[i+2], dim[1], dim[2])] |= uint8_t(1 << segs[i+3]);
+    }
+    segs.clear();
+
+    const uint stride[3] = { dim[1]*dim[2], dim[2], 1 };
+    std::vector<uint> comp;
+    uint n_comps = sdf_connected_components(size, [&](size_t index, std::vector<size_t> & nbrs)
+    {
+        nbrs.clear();
+        vec3u ijk = deserialize_3D_index(uint(index), dim[1], dim[2]);
+        for(int d=0; d<3; ++d)
+        {
+            if(ijk[d]+1<dim[d] && !(crossed[index] & (1<<d)))         nbrs.push_back(index+stride[d]);
+            if(ijk[d]>0 && !(crossed[index-stride[d]] & (1<<d))) nbrs.push_back(index-stride[d]);
+        }
+        return true;
+    }, comp);
+
+    std::vector<signed char> sign;
+    sdf_component_signs(verts, tris, opt.sign_mode, comp, n_comps,
+    [&](size_t index)
+    {
+        vec3u ijk = deserialize_3D_index(uint(index), dim[1], dim[2]);
+        return ijk[0]==0 || ijk[1]==0 || ijk[2]==0 || ijk[0]==dim[0]-1 || ijk[1]==dim[1]-1 || ijk[2]==dim[2]-1;
+    },
+    [&](size_t index)
+    {
+        return double(sdf.dist[index]);
+    },
+    [&](size_t index)
+    {
+        vec3u ijk = deserialize_3D_index(uint(index), dim[1], dim[2]);
+        return sdf.voxel_center(ijk[0], ijk[1], ijk[2]);
+    }, sign);
+
+    PARALLEL_FOR(0, size, 100000, [&](uint index)
+    {
+        sdf.dist[index] *= sign[comp[index]];
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void signed_distance_field(const AbstractPolygonMesh<M,V,E,P> & m,
+                                 SparseSignedDistanceField    & sdf,
+                           const SDFOptions                   & opt)
+{
+    signed_distance_field(m.vector_verts(), sdf_tessellation(m), sdf, opt);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void signed_distance_field(const std::vector<vec3d>        & verts,
+                           const std::vector<uint>         & tris,
+                                 SparseSignedDistanceField & sdf,
+                           const SDFOptions                & opt)
+{
+    const uint B  = std::max(1u, opt.block_size);
+    const uint B3 = B*B*B;
+    sdf.block_size = B;
+    sdf_grid(verts, opt, B, sdf.bbox, sdf.len, sdf.dim);
+    const uint * dim  = sdf.dim;
+    uint       * bdim = sdf.block_dim;
+    for(int d=0; d<3; ++d) bdim[d] = dim[d]/B;
+    const uint n_blocks = bdim[0]*bdim[1]*bdim[2];
+
+    // allocate all the blocks that intersect the enlarged bounding box of some triangle.
+    // The remaining blocks are farther than the band width from the surface
+    const double band = std::max(1u, opt.narrow_band) * sdf.len;
+    const double blen = B*sdf.len;
+    sdf.background = float(band);
+    sdf.block_index.assign(n_blocks, -1);
+    std::vector<AABB> boxes;
+    sdf_band_boxes(verts, tris, sdf.bbox, sdf.len, band, dim, boxes);
+    std::vector<uint> alloc_blocks;
+    std::vector<std::vector<uint>> block_tris;
+    for(uint tid=0; tid<boxes.size(); ++tid)
+    {
+        const AABB & b = boxes[tid];
+        for(uint i=uint(b.min[0])/B; i<=uint(b.max[0])/B; ++i)
+        for(uint j=uint(b.min[1])/B; j<=uint(b.max[1])/B; ++j)
+        for(uint k=uint(b.min[2])/B; k<=uint(b.max[2])/B; ++k)
+        {
+            uint bid = serialize_3D_index(i, j, k, bdim[1], bdim[2]);
+            if(sdf.block_index[bid]<0)
+            {
+                sdf.block_index[bid] = int(alloc_blocks.size());
+                alloc_blocks.push_back(bid);
+                block_tris.push_back({});
+            }
+            block_tris[sdf.block_index[bid]].push_back(tid);
+        }
+    }
+    const size_t n_alloc_voxels = alloc_blocks.size()*size_t(B3);
+    sdf.values.assign(n_alloc_voxels, sdf.background);
+
+    // global coordinates of a voxel in an allocated block
+    auto alloc_voxel_ijk = [&](const size_t node, uint ijk[3])
+    {
+        vec3u b = deserialize_3D_index(alloc_blocks[node/B3], bdim[1], bdim[2]);
+        vec3u l = deserialize_3D_index(uint(node%B3), B, B);
+        for(int d=0; d<3; ++d) ijk[d] = b[d]*B + l[d];
+    };
+
+    // exact (unsigned) distances within the band. Blocks are processed in parallel,
+    // each one considering only the triangles whose enlarged bbox overlaps with it
+    PARALLEL_FOR(0, uint(alloc_blocks.size()), 1, [&](uint slot)
+    {
+        vec3u  o     = deserialize_3D_index(alloc_blocks[slot], bdim[1], bdim[2])*B;
+        float *block = &sdf.values[size_t(slot)*B3];
+        for(uint tid : block_tris[slot])
+        {
+            const AABB & b = boxes[tid];
+            uint beg[3], end[3];
+            for(int d=0; d<3; ++d)
+            {
+                beg[d] = std::max(o[d],       uint(b.min[d]));
+                end[d] = std::min(o[d]+B-1,   uint(b.max[d]));
+            }
+            for(uint i=beg[0]; i<=end[0]; ++i)
+            for(uint j=beg[1]; j<=end[1]; ++j)
+            for(uint k=beg[2]; k<=end[2]; ++k)
+            {
+                uint  l = serialize_3D_index(i-o[0], j-o[1], k-o[2], B, B);
+                vec3d p = sdf.voxel_center(i, j, k);
+                block[l] = std::min(block[l], float(p.dist(sdf_closest_point(verts, tris, tid, p))));
+            }
+        }
+    });
+
+    // sign computation: graph nodes are all the voxels in allocated blocks
+    // (with ids in [0,n_alloc_voxels)) and all the non allocated blocks (with
+    // ids n_alloc_voxels + block id). Segments between adjacent voxels can
+    // be crossed by the surface only if both voxels are in allocated blocks
+    std::vector<uint> segs;
+    sdf_crossed_segments(verts, tris, sdf.bbox, sdf.len, dim, segs);
+    auto node_of = [&](const uint i, const uint j, const uint k) -> size_t
+    {
+        uint bid  = serialize_3D_index(i/B, j/B, k/B, bdim[1], bdim[2]);
+        int  slot = sdf.block_index[bid];
+        if(slot<0) return n_alloc_voxels + bid;
+        return size_t(slot)*B3 + serialize_3D_index(i%B, j%B, k%B, B, B);
+    };
+    std::vector<uint8_t> crossed(n_alloc_voxels, 0);
+    for(uint i=0; i<segs.size(); i+=4)
+    {
+        size_t node = node_of(segs[i], segs[i+1], segs[i+2]);
+        if(node<n_alloc_voxels) crossed[node] |= uint8_t(1 << segs[i+3]);
+    }
+    segs.clear();
+
+    std::vector<uint> comp;
+    uint n_comps = sdf_connected_components(n_alloc_voxels + n_blocks, [&](size_t node, std::vector<size_t> & nbrs)
+    {
+        nbrs.clear();
+        if(node<n_alloc_voxels)
+        {
+            uint ijk[3];
+            alloc_voxel_ijk(node, ijk);
+            for(int d=0; d<3; ++d)
+            {
+                if(ijk[d]+1<dim[d] && !(crossed[node] & (1<<d)))
+                {
+                    uint n[3] = { ijk[0], ijk[1], ijk[2] };
+                    ++n[d];
+                    nbrs.push_back(node_of(n[0], n[1], n[2]));
+                }
+                if(ijk[d]>0)
+                {
+                    uint n[3] = { ijk[0], ijk[1], ijk[2] };
+                    --n[d];
+                    size_t nbr = node_of(n[0], n[1], n[2]);
+                    if(nbr>=n_alloc_voxels || !(crossed[nbr] & (1<<d))) nbrs.push_back(nbr);
+                }
+            }
+            return true;
+        }
+        uint bid = uint(node - n_alloc_voxels);
+        if(sdf.block_index[bid]>=0) return false; // allocated blocks are represented by their voxels
+        vec3u b = deserialize_3D_index(bid, bdim[1], bdim[2]);
+        for(int d=0; d<3; ++d)
+        for(int dir=-1; dir<=1; dir+=2)
+        {
+            if((dir<0 && b[d]==0) || (dir>0 && b[d]+1==bdim[d])) continue;
+            uint nb[3] = { b[0], b[1], b[2] };
+            nb[d] += dir;
+            uint nbid = serialize_3D_index(nb[0], nb[1], nb[2], bdim[1], bdim[2]);
+            if(sdf.block_index[nbid]<0)
+            {
+                nbrs.push_back(n_alloc_voxels + nbid);
+                continue;
+            }
+            // add the voxels on the face of the allocated block facing this one
+            uint l[3];
+            l[d] = (dir>0) ? 0 : B-1;
+            int d1 = (d+1)%3, d2 = (d+2)%3;
+            for(l[d1]=0; l[d1]<B; ++l[d1])
+            for(l[d2]=0; l[d2]<B; ++l[d2])
+            {
+                nbrs.push_back(node_of(nb[0]*B+l[0], nb[1]*B+l[1], nb[2]*B+l[2]));
+            }
+        }
+        return true;
+    }, comp);
+
+    std::vector<signed char> sign;
+    sdf_component_signs(verts, tris, opt.sign_mode, comp, n_comps,
+    [&](size_t node)
+    {
+        if(node<n_alloc_voxels)
+        {
+            uint ijk[3];
+            alloc_voxel_ijk(node, ijk);
+            return ijk[0]==0 || ijk[1]==0 || ijk[2]==0 || ijk[0]==dim[0]-1 || ijk[1]==dim[1]-1 || ijk[2]==dim[2]-1;
+        }
+        vec3u b = deserialize_3D_index(uint(node-n_alloc_voxels), bdim[1], bdim[2]);
+        return b[0]==0 || b[1]==0 || b[2]==0 || b[0]==bdim[0]-1 || b[1]==bdim[1]-1 || b[2]==bdim[2]-1;
+    },
+    [&](size_t node)
+    {
+        return (node<n_alloc_voxels) ? double(sdf.values[node]) : band;
+    },
+    [&](size_t node)
+    {
+        if(node<n_alloc_voxels)
+        {
+            uint ijk[3];
+            alloc_voxel_ijk(node, ijk);
+            return sdf.voxel_center(ijk[0], ijk[1], ijk[2]);
+        }
+        vec3u b = deserialize_3D_index(uint(node-n_alloc_voxels), bdim[1], bdim[2]);
+        return vec3d(sdf.bbox.min + vec3d(b[0]+0.5, b[1]+0.5, b[2]+0.5)*blen);
+    }, sign);
+
+    PARALLEL_FOR(0, uint(alloc_blocks.size()), 1, [&](uint slot)
+    {
+        for(size_t node=size_t(slot)*B3; node<size_t(slot+1)*B3; ++node)
+        {
+            sdf.values[node] *= sign[comp[node]];
+        }
+    });
+    sdf.block_sign.assign(n_blocks, 0);
+    for(uint bid=0; bid<n_blocks; ++bid)
+    {
+        if(sdf.block_index[bid]<0) sdf.block_sign[bid] = sign[comp[n_alloc_voxels + bid]];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void sdf_to_voxel_grid(const SignedDistanceField & sdf,
+                             VoxelGrid           & g,
+                       const double                iso)
+{
+    sdf_classify_voxels(sdf.bbox, sdf.len, sdf.dim, [&](uint i, uint j, uint k){ return sdf.at(i,j,k); }, iso, g);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void sdf_to_voxel_grid(const SparseSignedDistanceField & sdf,
+                             VoxelGrid                 & g,
+                       const double                      iso)
+{
+    // outside the band values are clamped, hence the classification is reliable only near the surface
+    assert(std::fabs(iso) + 0.5*std::sqrt(3.0)*sdf.len < sdf.background);
+    sdf_classify_voxels(sdf.bbox, sdf.len, sdf.dim, [&](uint i, uint j, uint k){ return sdf.at(i,j,k); }, iso, g);
+}
+
+}
@@ -0,0 +1,195 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SIGNED_DISTANCE_FIELD_H
+#define CINO_SIGNED_DISTANCE_FIELD_H
+
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/voxel_grid.h>
+
+namespace cinolib
+{
+
+/* Signed distance fields of surface meshes, sampled at the centers of the
+ * voxels of a regular grid. Distances are negative inside and positive outside.
+ *
+ * Distances are computed as follows:
+ *
+ *  - voxels in a narrow band around the surface receive their exact distance
+ *    from the surface, computed by scattering each triangle onto the voxels
+ *    that fall within its bounding box, enlarged by the band width;
+ *
+ *  - outside the band, the dense field is completed by solving the eikonal
+ *    equation |grad(u)|=1 with the fast sweeping method described in
+ *
+ *        A fast sweeping method for Eikonal equations
+ *        Hongkai Zhao
+ *        Mathematics of Computation, 2005
+ *
+ *    Sweeps are parallelized by updating all voxels on the same diagonal plane
+ *    (i+j+k=const) concurrently, as they do not depend on each other. Far from
+ *    the surface the field is a first order approximation of the true distance;
+ *
+ *  - the sparse field only stores the blocks of voxels that intersect the narrow
+ *    band. Voxels in all other blocks are at least one band away from the surface,
+ *    and are assigned a constant (background) value, with the proper sign.
+ *    Values inside allocated blocks are clamped to the background value as well.
+ *
+ * The sign is determined by splitting the grid into the connected components
+ * of voxels that can be connected without crossing the surface (the segments
+ * between adjacent voxel centers are tested against the triangles of the mesh).
+ * A whole component is then classified as inside or outside, either:
+ *
+ *  - SDF_SIGN_FLOOD_FILL: components touching the grid boundary (which is padded
+ *    to be outside the object) are outside, all the others are inside. This is
+ *    correct only for watertight meshes;
+ *
+ *  - SDF_SIGN_WINDING_NUMBER: the generalized winding number is evaluated at
+ *    one voxel per component. This gives meaningful results also for meshes
+ *    with holes and triangle soups (see FastWindingNumber).
+ *
+ * NOTE: for non simplicial meshes (e.g. quads, exagons) the interior
+ * triangulation of each facet will be used for the computation.
+*/
+
+enum
+{
+    SDF_SIGN_FLOOD_FILL,
+    SDF_SIGN_WINDING_NUMBER,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct SDFOptions
+{
+    uint max_voxels_per_side = 128;                 // resolution along the longest side of the mesh bbox
+    uint narrow_band         = 3;                   // half width of the band of exact distances (in voxels)
+    uint padding             = 2;                   // empty voxels added around the mesh bbox
+    uint block_size          = 8;                   // voxels per side of each block (sparse fields only)
+    int  sign_mode           = SDF_SIGN_FLOOD_FILL; // SDF_SIGN_FLOOD_FILL or SDF_SIGN_WINDING_NUMBER
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct SignedDistanceField
+{
+    AABB               bbox;   // bounding box of the grid
+    double             len;    // per voxel edge length
+    uint               dim[3]; // number of voxels along XYZ axis
+    std::vector<float> dist;   // per voxel signed distance (voxels are serialized with serialize_3D_index)
+
+    float  at          (const uint i, const uint j, const uint k) const;
+    vec3d  voxel_center(const uint i, const uint j, const uint k) const;
+    double sample      (const vec3d & p) const; // trilinear interpolation of the voxel values
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct SparseSignedDistanceField
+{
+    AABB                     bbox;          // bounding box of the grid
+    double                   len;           // per voxel edge length
+    uint                     dim[3];        // number of voxels along XYZ axis (multiple of block_size)
+    uint                     block_size;    // number of voxels per side of each block
+    uint                     block_dim[3];  // number of blocks along XYZ axis
+    float                    background;    // absolute value of the distance of voxels in non allocated blocks
+    std::vector<int>         block_index;   // per block: position of its voxels in values (in blocks), or -1
+    std::vector<signed char> block_sign;    // per block: sign of the voxels, if the block is not allocated
+    std::vector<float>       values;        // voxels of allocated blocks (block_size^3 consecutive values per block)
+
+    float  at          (const uint i, const uint j, const uint k) const;
+    vec3d  voxel_center(const uint i, const uint j, const uint k) const;
+    double sample      (const vec3d & p) const; // trilinear interpolation of the voxel values
+    uint   num_allocated_blocks() const;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void signed_distance_field(const AbstractPolygonMesh<M,V,E,P> & m,
+                                 SignedDistanceField          & sdf,
+                           const SDFOptions                   & opt = SDFOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void signed_distance_field(const std::vector<vec3d> & verts,
+                           const std::vector<uint>  & tris,
+                                 SignedDistanceField & sdf,
+                           const SDFOptions          & opt = SDFOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void signed_distance_field(const AbstractPolygonMesh<M,V,E,P> & m,
+                                 SparseSignedDistanceField    & sdf,
+                           const SDFOptions                   & opt = SDFOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void signed_distance_field(const std::vector<vec3d>        & verts,
+                           const std::vector<uint>         & tris,
+                                 SparseSignedDistanceField & sdf,
+                           const SDFOptions                & opt = SDFOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Converts a distance field into a voxel grid, classifying voxels w.r.t. the
+// iso surface sdf=iso (use iso>0 for offsets, iso<0 for insets). Since the
+// field is 1-Lipschitz, voxels whose value differs from iso more than half
+// their diagonal are deemed fully inside or outside. All others are marked as
+// VOXEL_BOUNDARY. The result can be converted into a hexmesh with voxel_grid_to_hexmesh()
+//
+CINO_INLINE
+void sdf_to_voxel_grid(const SignedDistanceField & sdf,
+                             VoxelGrid           & g,
+                       const double                iso = 0.0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void sdf_to_voxel_grid(const SparseSignedDistanceField & sdf,
+                             VoxelGrid                 & g,
+                       const double                      iso = 0.0);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "signed_distance_field.cpp"
+#endif
+
+#endif // CINO_SIGNED_DISTANCE_FIELD_H
@@ -94,6 +94,36 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
         }
     }
 
+    // closest point on the target for each vertex (on o_srf, o_line or o_corner, depending on its label).
+    // Projections are computed in batch, and since vertices move only slightly between iterations, the
+    // items found at the previous iteration are used to warm start the next search
+    std::vector<uint>  proj_item(m.num_verts(), uint(-1)); // position of the closest item in its octree
+    std::vector<vec3d> proj_pos (m.num_verts());
+    auto project = [&](const std::vector<vec3d> & points)
+    {
+        for(int label : {REGULAR, CORNER, FEATURE})
+        {
+            const Octree & o = (label==REGULAR) ? o_srf : ((label==FEATURE) ? o_line : o_corner);
+            std::vector<uint>  vids, hint, index;
+            std::vector<vec3d> p, pos;
+            std::vector<vec4d> bc;
+            for(uint vid=0; vid<m.num_verts(); ++vid)
+            {
+                if(m.vert_data(vid).label!=label) continue;
+                vids.push_back(vid);
+                p.push_back(points.at(vid));
+                hint.push_back(proj_item.at(vid));
+            }
+            if(vids.empty()) continue;
+            o.closest_points(p, index, pos, bc, hint);
+            for(uint i=0; i<vids.size(); ++i)
+            {
+                proj_item.at(vids.at(i)) = index.at(i);
+                proj_pos.at(vids.at(i))  = pos.at(i);
+            }
+        }
+    };
+
     std::vector<Entry>  entries; // coeff matrix
     std::vector<double> w;       // weights matrix
     std::vector<double> rhs;     // right hand side
@@ -123,11 +153,10 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
     // where <n,d> is the plane tangent to the mesh at v_i
     auto tangent_space = [&](const uint vid)
     {
-        vec3d  p;
-        double dist;
-        uint   pid;
-        o_srf.closest_point(m.vert(vid), pid, p, dist);
-        vec3d n = target.poly_data(pid).normal;
+        vec3d  p    = proj_pos.at(vid);
+        double dist = p.dist_sqrd(m.vert(vid)); // squared, as in Octree::closest_point
+        uint   pid  = o_srf.items.at(proj_item.at(vid))->id;
+        vec3d  n    = target.poly_data(pid).normal;
 
         // reduces energy for mapping to distant points
         // because they are likely to be wrong assignments
@@ -152,10 +181,8 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
     // parameterized by the extra varaible t
     auto tangent_line = [&](const uint vid)
     {
-        vec3d  p;
-        double dist;
-        uint   eid;
-        o_line.closest_point(m.vert(vid), eid, p, dist);
+        vec3d p   = proj_pos.at(vid);
+        uint  eid = o_line.items.at(proj_item.at(vid))->id;
         vec3d dir = target.edge_vec(eid,true);
 
         uint  nv    = m.num_verts();
@@ -193,10 +220,8 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
     // where v_i* is the current position of v_i
     auto corner = [&](const uint vid)
     {
-        vec3d  p;
-        double dist;
-        uint   pid;
-        o_corner.closest_point(m.vert(vid), pid, p, dist);
+        vec3d  p    = proj_pos.at(vid);
+        double dist = p.dist_sqrd(m.vert(vid)); // squared, as in Octree::closest_point
 
         // discards mappings to distant corners because they are likely to be wrong assignments
         // (e.g. if the feature networks of source and target meshes mismatch)
@@ -223,10 +248,16 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
         ++row;
     };
 
+    // the sparsity pattern of the system changes only if vertices switch between
+    // being constrained or not (e.g. corners too far from their target). In all
+    // the other iterations only the numerical factorization is recomputed
+    SparseFactorization factorization;
+
     // SMOOTHING ITERATIONS
     for(uint i=0; i<opt.n_iters; ++i)
     {
         laplacian();
+        project(m.vector_verts());
         for(uint vid=0; vid<m.num_verts(); ++vid)
         {
             switch(m.vert_data(vid).label)
@@ -243,27 +274,25 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
         Eigen::VectorXd RHS = Eigen::Map<Eigen::VectorXd>(rhs.data(), rhs.size());
         Eigen::VectorXd W   = Eigen::Map<Eigen::VectorXd>(w.data(), w.size());
         Eigen::VectorXd res;
-        solve_weighted_least_squares(A, W, RHS, res);
+        solve_weighted_least_squares(A, W, RHS, res, factorization);
 
         uint nv = m.num_verts();
+        std::vector<vec3d> new_pos(nv);
         for(uint vid=0; vid<nv; ++vid)
         {
-            vec3d p(res[vid], res[nv+vid], res[2*nv+vid]);
-
-            switch(m.vert_data(vid).label)
+            new_pos.at(vid) = vec3d(res[vid], res[nv+vid], res[2*nv+vid]);
+            if(m.vert_data(vid).label==FEATURE)
             {
-                case REGULAR: m.vert(vid) = (opt.reproject_on_target) ? o_srf.closest_point(p)    : p; break;
-                case CORNER:  m.vert(vid) = (opt.reproject_on_target) ? o_corner.closest_point(p) : p; break;
-                case FEATURE:
-                {
-                    const auto & line = feature_data.at(vid);
-                    p += line.first * res[line.second];
-                    m.vert(vid) = (opt.reproject_on_target) ? o_line.closest_point(p) : p;
-                    break;
-                }
-                default: assert(false && "unknown vertex type");
+                const auto & line = feature_data.at(vid);
+                new_pos.at(vid) += line.first * res[line.second];
             }
         }
+        if(opt.reproject_on_target)
+        {
+            project(new_pos);
+            new_pos = proj_pos;
+        }
+        for(uint vid=0; vid<nv; ++vid) m.vert(vid) = new_pos.at(vid);
 
         if(i<opt.n_iters)
         {
@@ -0,0 +1,314 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/spatial_hash.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace cinolib
+{
+
+CINO_INLINE
+SpatialHash::SpatialHash(const std::vector<vec3d> & points,
+                         const double               cell_size)
+{
+    build(points, cell_size);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+SpatialHash::SpatialHash(const std::vector<AABB> & boxes,
+                         const double              cell_size)
+{
+    std::vector<vec3d> centers(boxes.size());
+    for(uint i=0; i<boxes.size(); ++i)
+    {
+        centers.at(i)   = boxes.at(i).center();
+        max_half_extent = std::max(max_half_extent, 0.5*boxes.at(i).diag());
+    }
+    build(centers, cell_size);
+
+    this->boxes.resize(boxes.size());
+    PARALLEL_FOR(0, uint(ids.size()), 10000, [&](uint i)
+    {
+        this->boxes.at(i) = boxes.at(ids.at(i));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double SpatialHash::default_cell_size(const AABB & bbox, const uint n)
+{
+    double l = bbox.delta().max_entry();
+    if(n==0 || l<=0) return 1.0;
+    return l/std::sqrt(double(n));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SpatialHash::build(const std::vector<vec3d> & centers, const double cell_size)
+{
+    uint n = uint(centers.size());
+
+    bbox.reset();
+    for(const vec3d & p : centers) bbox.push(p);
+    cell = (cell_size>0) ? cell_size : default_cell_size(bbox,n);
+
+    uint n_buckets = 1;
+    while(n_buckets<n) n_buckets <<= 1;
+    mask = n_buckets-1;
+
+    // counting sort of the items by bucket
+    std::vector<uint> item_bucket(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        const vec3d & p = centers.at(i);
+        item_bucket.at(i) = bucket(cell_coord(p[0],0), cell_coord(p[1],1), cell_coord(p[2],2));
+    });
+
+    bucket_beg.assign(n_buckets+1, 0);
+    for(uint b : item_bucket) ++bucket_beg.at(b+1);
+    for(uint b=0; b<n_buckets; ++b) bucket_beg.at(b+1) += bucket_beg.at(b);
+
+    std::vector<std::atomic<uint>> offset(n_buckets);
+    for(uint b=0; b<n_buckets; ++b) offset.at(b).store(bucket_beg.at(b));
+
+    ids.resize(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        ids.at(offset.at(item_bucket.at(i)).fetch_add(1)) = i;
+    });
+
+    // parallel scattering does not preserve the order of the items in each bucket: restore it
+    PARALLEL_FOR(0, n_buckets, 10000, [&](uint b)
+    {
+        if(bucket_beg.at(b+1)-bucket_beg.at(b)>1)
+        {
+            std::sort(ids.begin()+bucket_beg.at(b), ids.begin()+bucket_beg.at(b+1));
+        }
+    });
+
+    pos.resize(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        pos.at(i) = centers.at(ids.at(i));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+long long SpatialHash::cell_coord(const double x, const uint axis) const
+{
+    return (long long)std::floor((x-bbox.min[axis])/cell);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// https://matthias-research.github.io/pages/publications/tetraederCollision.pdf
+CINO_INLINE
+uint SpatialHash::bucket(const long long i, const long long j, const long long k) const
+{
+    unsigned long long h = ((unsigned long long)i * 73856093ull) ^
+                           ((unsigned long long)j * 19349663ull) ^
+                           ((unsigned long long)k * 83492791ull);
+    return uint(h & mask);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double SpatialHash::dist_sqrd(const uint pos_index, const vec3d & p) const
+{
+    if(boxes.empty()) return pos[pos_index].dist_sqrd(p);
+    return boxes[pos_index].dist_sqrd(p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// calls func(b) once for each bucket b that may contain items within distance radius from p
+template<class Func>
+CINO_INLINE
+void SpatialHash::visit_bucket_range(const vec3d & p, const double radius, const Func & func) const
+{
+    if(ids.empty()) return;
+
+    double    r = radius + max_half_extent;
+    long long beg[3], end[3];
+    double    n_cells = 1;
+    for(uint i=0; i<3; ++i)
+    {
+        beg[i]   = cell_coord(p[i]-r,i);
+        end[i]   = cell_coord(p[i]+r,i);
+        n_cells *= double(end[i]-beg[i]+1);
+    }
+
+    if(n_cells>mask)
+    {
+        // the query range spans more cells than buckets: visit them all
+        for(uint b=0; b<=mask; ++b) func(b);
+        return;
+    }
+
+    // different cells may collide in the same bucket. Make sure each bucket is visited once
+    // (query ranges are usually made of a handful of cells, hence a linear search is fine)
+    uint small_list[64];
+    uint small_size = 0;
+    std::vector<uint> large_list;
+    for(long long i=beg[0]; i<=end[0]; ++i)
+    for(long long j=beg[1]; j<=end[1]; ++j)
+    for(long long k=beg[2]; k<=end[2]; ++k)
+    {
+        uint b = bucket(i,j,k);
+        if(n_cells<=64)
+        {
+            if(std::find(small_list, small_list+small_size, b)==small_list+small_size)
+            {
+                small_list[small_size++] = b;
+                func(b);
+            }
+        }
+        else large_list.push_back(b);
+    }
+    if(!large_list.empty())
+    {
+        std::sort(large_list.begin(), large_list.end());
+        large_list.erase(std::unique(large_list.begin(), large_list.end()), large_list.end());
+        for(uint b : large_list) func(b);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SpatialHash::query_radius(const vec3d & p, const double radius, std::vector<uint> & ids) const
+{
+    ids.clear();
+    double r2 = radius*radius;
+    visit_bucket_range(p, radius, [&](const uint b)
+    {
+        for(uint i=bucket_beg[b]; i<bucket_beg[b+1]; ++i)
+        {
+            if(dist_sqrd(i,p)<=r2) ids.push_back(this->ids[i]);
+        }
+    });
+    std::sort(ids.begin(), ids.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SpatialHash::closest_within(const vec3d & p, const double radius, uint & id) const
+{
+    double best = radius*radius;
+    bool   found = false;
+    visit_bucket_range(p, radius, [&](const uint b)
+    {
+        for(uint i=bucket_beg[b]; i<bucket_beg[b+1]; ++i)
+        {
+            double d = dist_sqrd(i,p);
+            if(d<best || (d==best && (!found || ids[i]<id)))
+            {
+                best  = d;
+                id    = ids[i];
+                found = true;
+            }
+        }
+    });
+    return found;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SpatialHash::first_within(const vec3d & p, const double radius, uint & id) const
+{
+    double r2    = radius*radius;
+    bool   found = false;
+    visit_bucket_range(p, radius, [&](const uint b)
+    {
+        for(uint i=bucket_beg[b]; i<bucket_beg[b+1]; ++i)
+        {
+            if((!found || ids[i]<id) && dist_sqrd(i,p)<=r2)
+            {
+                id    = ids[i];
+                found = true;
+            }
+        }
+    });
+    return found;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void weld_points(const std::vector<vec3d> & points,
+                 const double               eps,
+                       std::vector<vec3d> & unique_points,
+                       std::vector<uint>  & old2new)
+{
+    uint n = uint(points.size());
+
+    AABB bbox(points);
+    SpatialHash grid(points, std::max(eps, SpatialHash::default_cell_size(bbox,n)));
+
+    // for each point, find the lowest index point within distance eps (possibly itself)
+    std::vector<uint> first(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        grid.first_within(points.at(i), eps, first.at(i)); // always true (the point itself is in range)
+        assert(first.at(i)<=i);
+    });
+
+    // follow chains of merges, and enumerate unique points in order of first appearance
+    unique_points.clear();
+    old2new.resize(n);
+    for(uint i=0; i<n; ++i)
+    {
+        if(first.at(i)==i)
+        {
+            old2new.at(i) = uint(unique_points.size());
+            unique_points.push_back(points.at(i));
+        }
+        else old2new.at(i) = old2new.at(first.at(i));
+    }
+}
+
+}
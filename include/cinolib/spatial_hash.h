@@ -0,0 +1,133 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SPATIAL_HASH_H
+#define CINO_SPATIAL_HASH_H
+
+#include <cinolib/geometry/aabb.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Uniform grid for fast proximity queries on points (or small primitives, such as
+ * spheres, segments or triangles, represented by their AABBs). Grid cells are not
+ * stored densely, but hashed into a table with as many buckets as items, hence
+ * memory consumption does not depend on the number of cells, which can be arbitrarily
+ * high. Items are sorted by bucket with a (parallel) counting sort, and their
+ * positions are stored contiguously, so that items in the same cell are close also
+ * in memory. Construction is linear in the number of items.
+ *
+ * The cell size should be comparable to the radius of the queries (e.g. the welding
+ * threshold). If no cell size is specified, a size giving about one item per cell
+ * on a surface sampling of the bounding box is used.
+*/
+
+class SpatialHash
+{
+    public:
+
+        explicit SpatialHash(const std::vector<vec3d> & points,
+                             const double               cell_size = 0);
+
+        explicit SpatialHash(const std::vector<AABB>  & boxes,
+                             const double               cell_size = 0);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns (in ascending order) the ids of all items within distance radius from p.
+        // For boxes, the distance between p and the box is considered
+        void query_radius(const vec3d & p, const double radius, std::vector<uint> & ids) const;
+
+        // returns the id of the item closest to p, provided it is within distance radius
+        bool closest_within(const vec3d & p, const double radius, uint & id) const;
+
+        // returns the lowest id among the items within distance radius from p
+        bool first_within(const vec3d & p, const double radius, uint & id) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // cell size giving about one item per cell for n items sampling a surface within bbox
+        static double default_cell_size(const AABB & bbox, const uint n);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        double cell_size() const { return cell; }
+        uint   num_items() const { return uint(ids.size()); }
+
+    protected:
+
+        void build(const std::vector<vec3d> & centers, const double cell_size);
+
+        uint      bucket    (const long long i, const long long j, const long long k) const;
+        long long cell_coord(const double x, const uint axis) const;
+        double    dist_sqrd (const uint pos_index, const vec3d & p) const;
+
+        template<class Func>
+        void visit_bucket_range(const vec3d & p, const double radius, const Func & func) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        AABB               bbox;
+        double             cell;
+        double             max_half_extent = 0;  // max half diagonal of the input boxes (0 for points)
+        uint               mask;                 // #buckets - 1 (#buckets is a power of two)
+        std::vector<uint>  bucket_beg;           // items in bucket b are in range [bucket_beg[b], bucket_beg[b+1])
+        std::vector<uint>  ids;                  // item ids, sorted by bucket
+        std::vector<vec3d> pos;                  // item positions (or box centers), sorted by bucket
+        std::vector<AABB>  boxes;                // item boxes, sorted by bucket (empty for points)
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Welds points closer than eps. Each point is merged with the lowest index point
+ * within distance eps (chains of merges are followed, so that the result does not
+ * depend on the order in which points are processed). For eps=0 only points with
+ * identical coordinates are merged. Unique points are returned in order of first
+ * appearance, and old2new maps each input point to its position in unique_points.
+*/
+CINO_INLINE
+void weld_points(const std::vector<vec3d> & points,
+                 const double               eps,
+                       std::vector<vec3d> & unique_points,
+                       std::vector<uint>  & old2new);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "spatial_hash.cpp"
+#endif
+
+#endif // CINO_SPATIAL_HASH_H
@@ -0,0 +1,316 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/tet_locator.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace cinolib
+{
+
+namespace
+{
+    // spreads the lowest 10 bits of x, leaving two zeros between consecutive bits
+    CINO_INLINE
+    uint spread_bits(uint x)
+    {
+        x &= 0x3ff;
+        x = (x | (x << 16)) & 0x030000ff;
+        x = (x | (x <<  8)) & 0x0300f00f;
+        x = (x | (x <<  4)) & 0x030c30c3;
+        x = (x | (x <<  2)) & 0x09249249;
+        return x;
+    }
+
+    // position of p along a Morton curve spanning box b (1024 cells per side)
+    CINO_INLINE
+    uint morton_code(const vec3d & p, const AABB & b)
+    {
+        uint ijk[3];
+        for(int i=0; i<3; ++i)
+        {
+            double d = b.max[i] - b.min[i];
+            double t = (d>0) ? (p[i] - b.min[i]) / d : 0.0;
+            ijk[i] = uint(std::min(1023.0, std::max(0.0, t*1024.0)));
+        }
+        return (spread_bits(ijk[0]) << 2) | (spread_bits(ijk[1]) << 1) | spread_bits(ijk[2]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+TetLocator::TetLocator(const Tetmesh<M,V,E,F,P> & m)
+    : verts(m.vector_verts())
+    , filter(verts)
+{
+    tets.reserve(4*m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    for(uint off=0; off<4; ++off)
+    {
+        tets.push_back(m.poly_vert_id(pid,off));
+    }
+    init();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+TetLocator::TetLocator(const std::vector<vec3d> & verts,
+                       const std::vector<uint>  & tets)
+    : verts(verts)
+    , tets(tets)
+    , filter(verts)
+{
+    init();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void TetLocator::init()
+{
+    assert(tets.size()%4==0);
+    uint nt = num_tets();
+    bbox = AABB(verts);
+
+    // make all tets positively oriented, so that p is inside a tet iff
+    // replacing any of its vertices with p never gives a negative orient3d
+    flipped.resize(nt);
+    for(uint pid=0; pid<nt; ++pid)
+    {
+        uint *t = &tets.at(4*pid);
+        flipped.at(pid) = filter.orient3d(verts.at(t[0]), verts.at(t[1]), verts.at(t[2]), verts.at(t[3])) < 0;
+        if(flipped.at(pid)) std::swap(t[0],t[1]);
+    }
+
+    // face adjacency: faces are identified by their (sorted) vertex ids, and matched by sorting
+    std::vector<std::pair<std::array<uint,3>,uint>> faces(4*nt);
+    PARALLEL_FOR(0, nt, 10000, [&](uint pid)
+    {
+        const uint *t = &tets.at(4*pid);
+        for(uint i=0; i<4; ++i)
+        {
+            std::array<uint,3> f = {{ t[(i+1)%4], t[(i+2)%4], t[(i+3)%4] }};
+            std::sort(f.begin(), f.end());
+            faces.at(4*pid+i) = std::make_pair(f, 4*pid+i);
+        }
+    });
+    std::sort(faces.begin(), faces.end());
+    adj.assign(4*nt, -1);
+    for(uint i=0; i+1<faces.size(); ++i)
+    {
+        if(faces.at(i).first==faces.at(i+1).first)
+        {
+            adj.at(faces.at(i  ).second) = faces.at(i+1).second/4;
+            adj.at(faces.at(i+1).second) = faces.at(i  ).second/4;
+            ++i;
+        }
+    }
+
+    // walks on coherent queries take few steps. Longer walks are likely
+    // to be stuck (e.g. cycling around badly shaped elements)
+    max_steps = 32 + 8*uint(std::cbrt(double(nt)));
+
+    octree.items.reserve(nt);
+    for(uint pid=0; pid<nt; ++pid)
+    {
+        const uint *t = &tets.at(4*pid);
+        octree.push_tetrahedron(pid, verts.at(t[0]), verts.at(t[1]), verts.at(t[2]), verts.at(t[3]));
+    }
+    octree.build();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int TetLocator::walk(const vec3d & p, const uint start, double bc[4]) const
+{
+    uint curr = start;
+    int  prev = -1;
+    for(uint step=0; step<max_steps; ++step)
+    {
+        const uint *t = &tets.at(4*curr);
+        const vec3d *v[4] = { &verts.at(t[0]), &verts.at(t[1]), &verts.at(t[2]), &verts.at(t[3]) };
+
+        // the face to check first is chosen pseudo randomly, which prevents the walk from cycling
+        uint first = (step*2654435761u + curr) & 3;
+        int  exit  = -1;
+        for(uint k=0; k<4; ++k)
+        {
+            uint i = (first+k)%4;
+            if(adj.at(4*curr+i)==prev && prev!=-1) continue; // p is on this side of the face it came from
+            const vec3d *w[4] = { v[0], v[1], v[2], v[3] };
+            w[i] = &p;
+            if(filter.orient3d(*w[0], *w[1], *w[2], *w[3]) < 0)
+            {
+                exit = int(i);
+                break;
+            }
+        }
+
+        if(exit==-1)
+        {
+            bary_coords(p, curr, bc);
+            return int(curr);
+        }
+
+        int next = adj.at(4*curr+exit);
+        if(next<0) return -1; // reached the boundary
+        prev = int(curr);
+        curr = uint(next);
+    }
+    return -1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void TetLocator::bary_coords(const vec3d & p, const uint pid, double bc[4]) const
+{
+    const uint *t = &tets.at(4*pid);
+    double sum = 0;
+    for(uint i=0; i<4; ++i)
+    {
+        const vec3d *w[4] = { &verts.at(t[0]), &verts.at(t[1]), &verts.at(t[2]), &verts.at(t[3]) };
+        w[i] = &p;
+        bc[i] = std::max(0.0, filter.orient3d(*w[0], *w[1], *w[2], *w[3]));
+        sum  += bc[i];
+    }
+    if(sum>0) for(uint i=0; i<4; ++i) bc[i] /= sum;
+    else      for(uint i=0; i<4; ++i) bc[i]  = 0.25; // degenerate tet
+
+    // back to the original vertex order
+    if(flipped.at(pid)) std::swap(bc[0],bc[1]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int TetLocator::locate(const vec3d & p, double bc[4], const int hint) const
+{
+    // the filter is valid only within the bbox (and there is nothing to find outside anyway)
+    if(!bbox.contains(p,false)) return -1;
+
+    if(hint>=0 && hint<int(num_tets()))
+    {
+        int pid = walk(p, uint(hint), bc);
+        if(pid>=0) return pid;
+    }
+
+    uint id;
+    if(octree.contains(p, false, id))
+    {
+        bary_coords(p, id, bc);
+        return int(id);
+    }
+    return -1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void TetLocator::locate(const std::vector<vec3d> & p,
+                              std::vector<int>   & pids,
+                              std::vector<vec4d> & bc) const
+{
+    uint n = uint(p.size());
+    pids.assign(n, -1);
+    bc.assign(n, vec4d(0.0));
+    if(n==0) return;
+
+    // sort queries along a Morton curve, so that consecutive queries are close in space
+    AABB qbox(p);
+    std::vector<std::pair<uint,uint>> order(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        order.at(i) = std::make_pair(morton_code(p.at(i),qbox), i);
+    });
+    std::sort(order.begin(), order.end());
+
+    // each chunk starts with a jump (octree), then each query walks from the previous one
+    const uint chunk_size = 1024;
+    uint n_chunks = (n + chunk_size - 1) / chunk_size;
+    PARALLEL_FOR(0, n_chunks, 1, [&](uint c)
+    {
+        int hint = -1;
+        uint end = std::min(n, (c+1)*chunk_size);
+        for(uint k=c*chunk_size; k<end; ++k)
+        {
+            uint i   = order.at(k).second;
+            int  pid = locate(p.at(i), bc.at(i).ptr(), hint);
+            if(pid>=0)
+            {
+                pids.at(i) = pid;
+                hint = pid;
+            }
+            else bc.at(i) = vec4d(0.0);
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void TetLocator::sample(const std::vector<T>     & field,
+                        const std::vector<vec3d> & p,
+                              std::vector<T>     & values,
+                        const T                  & outside_value) const
+{
+    assert(field.size()==verts.size());
+
+    std::vector<int>   pids;
+    std::vector<vec4d> bc;
+    locate(p, pids, bc);
+
+    values.assign(p.size(), outside_value);
+    PARALLEL_FOR(0, uint(p.size()), 10000, [&](uint i)
+    {
+        int pid = pids.at(i);
+        if(pid<0) return;
+        uint t[4] = { tets.at(4*pid), tets.at(4*pid+1), tets.at(4*pid+2), tets.at(4*pid+3) };
+        if(flipped.at(pid)) std::swap(t[0],t[1]); // bc refer to the original vertex order
+        values.at(i) = field.at(t[0]) * bc.at(i)[0] +
+                       field.at(t[1]) * bc.at(i)[1] +
+                       field.at(t[2]) * bc.at(i)[2] +
+                       field.at(t[3]) * bc.at(i)[3];
+    });
+}
+
+}
@@ -0,0 +1,132 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_TET_LOCATOR_H
+#define CINO_TET_LOCATOR_H
+
+#include <cinolib/meshes/tetmesh.h>
+#include <cinolib/filtered_predicates.h>
+#include <cinolib/octree.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Point location in tetrahedral meshes, for bulk sampling of fields defined
+ * on tetmeshes (e.g. resampling on a grid, tracing curves, transferring
+ * attributes between meshes).
+ *
+ * Queries walk from tet to tet through face adjacencies, starting from a
+ * hint tet and moving towards the query point (visibility walk). At each
+ * step, the walk exits through a face that separates the current tet from
+ * the query point, which is detected with orient3d (statically filtered,
+ * and exact if CINOLIB_USES_SHEWCHUK_PREDICATES is defined). Since the mesh
+ * is not assumed to be convex (nor Delaunay), a walk may reach the boundary
+ * or take too many steps. In these cases, as well as when no hint is given,
+ * the query is resolved with an octree, which also serves as a jump start.
+ *
+ * The batch version sorts the queries along a Morton curve and splits them
+ * into chunks that are processed in parallel. Within each chunk, each query
+ * walks from the tet that contains the previous one, hence coherent queries
+ * take a (small) constant number of steps.
+*/
+
+class TetLocator
+{
+    public:
+
+        template<class M, class V, class E, class F, class P>
+        explicit TetLocator(const Tetmesh<M,V,E,F,P> & m);
+
+        // tets are serialized (4 vertex ids per tet)
+        explicit TetLocator(const std::vector<vec3d> & verts,
+                            const std::vector<uint>  & tets);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns the id of a tet containing p (borders included) and the barycentric
+        // coordinates of p w.r.t. its vertices, or -1 if p is outside the mesh. The
+        // search starts from tet hint (if any)
+        int locate(const vec3d & p, double bc[4], const int hint = -1) const;
+
+        // batch version: pids[i] is the tet containing p[i] (-1 if outside), and bc[i]
+        // the barycentric coordinates of p[i] w.r.t. its vertices (zero if outside)
+        void locate(const std::vector<vec3d> & p,
+                          std::vector<int>   & pids,
+                          std::vector<vec4d> & bc) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // linearly interpolates a per vertex field (e.g. double or vec3d) at points p.
+        // Points outside the mesh get outside_value
+        template<typename T>
+        void sample(const std::vector<T>     & field,
+                    const std::vector<vec3d> & p,
+                          std::vector<T>     & values,
+                    const T                  & outside_value) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_tets() const { return uint(tets.size()/4); }
+
+    protected:
+
+        void init();
+
+        // visibility walk from tet start. Returns -1 if the walk fails
+        int  walk(const vec3d & p, const uint start, double bc[4]) const;
+
+        // barycentric coordinates of p w.r.t. tet pid (from the same orient3d used to walk)
+        void bary_coords(const vec3d & p, const uint pid, double bc[4]) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        std::vector<vec3d> verts;
+        std::vector<uint>  tets;         // 4 vertex ids per tet, positively oriented
+        std::vector<int>   adj;          // 4 entries per tet: the tet adjacent through the face opposite to each vertex (-1 on the boundary)
+        std::vector<bool>  flipped;      // true for tets whose first two vertices were swapped to make them positively oriented
+        AABB               bbox;
+        FilteredPredicates filter;
+        Octree             octree;       // for jump starts and fallbacks
+        uint               max_steps;    // walks longer than this are considered failed
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "tet_locator.cpp"
+#endif
+
+#endif // CINO_TET_LOCATOR_H
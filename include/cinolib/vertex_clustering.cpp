@@ -35,6 +35,8 @@
 *********************************************************************************/
 #include <cinolib/vertex_clustering.h>
 #include <cinolib/bfs.h>
+#include <cinolib/spatial_hash.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -57,10 +59,44 @@ void vertex_clustering(const std::vector<Vertex>             & points,
         }
     }
 
-    // visit the resulting graph with BFS to
+    vertex_clustering(v2v, clusters);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void vertex_clustering(const std::vector<vec3d>              & points,
+                       const double                            proximity_thresh,
+                       std::vector<std::unordered_set<uint>> & clusters)
+{
+    // build v2v connectivity based on point proximity
+    SpatialHash grid(points, proximity_thresh);
+    std::vector<std::vector<uint>> v2v(points.size());
+    PARALLEL_FOR(0, uint(points.size()), 10000, [&](uint vid)
+    {
+        grid.query_radius(points.at(vid), proximity_thresh, v2v.at(vid));
+        // remove self and points exactly at distance proximity_thresh (the test is strict)
+        auto & nbrs = v2v.at(vid);
+        nbrs.erase(std::remove_if(nbrs.begin(), nbrs.end(), [&](const uint nbr)
+        {
+            return nbr==vid || !(points.at(vid).dist(points.at(nbr)) < proximity_thresh);
+        }), nbrs.end());
+    });
+
+    vertex_clustering(v2v, clusters);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void vertex_clustering(const std::vector<std::vector<uint>>  & v2v,
+                       std::vector<std::unordered_set<uint>> & clusters)
+{
+    // visit the proximity graph with BFS to
     // isolate clusters of adjacent vertices
-    uint nv   = points.size();
+    uint nv   = v2v.size();
     uint seed = 0;
+    if(nv==0) return;
     std::vector<bool> visited(nv, false);
     do
     {
@@ -70,12 +106,11 @@ void vertex_clustering(const std::vector<Vertex>             & points,
         clusters.push_back(cluster);
         for(uint vid : cluster) visited.at(vid) = true;
 
-        seed = 0;
+        // all vertices before seed have already been visited
         while (seed < nv && visited.at(seed)) ++seed;
     }
     while (seed < nv);
 }
 
-
 }
 
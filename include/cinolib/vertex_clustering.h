@@ -40,6 +40,7 @@
 #include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
 
 
 namespace cinolib
@@ -57,6 +58,22 @@ void vertex_clustering(const std::vector<Vertex>             & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// specialized version for 3D points, which uses a spatial hash to find
+// pairs of close points in linear time (rather than testing all pairs)
+CINO_INLINE
+void vertex_clustering(const std::vector<vec3d>              & points,
+                       const double                            proximity_thresh,
+                       std::vector<std::unordered_set<uint>> & clusters);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// groups vertices in the connected components of a proximity graph
+CINO_INLINE
+void vertex_clustering(const std::vector<std::vector<uint>>  & v2v,
+                       std::vector<std::unordered_set<uint>> & clusters);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/vertex_mass.h>
+#include <cinolib/operator_assembler.h>
 
 namespace cinolib
 {
@@ -42,26 +43,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 Eigen::SparseMatrix<double> mass_matrix(const AbstractMesh<M,V,E,P> & m, const int n)
 {
-    typedef Eigen::Triplet<double> Entry;
-
-    uint nv = m.num_verts();
-    std::vector<uint> base(n);
-    for(int i=0; i<n; ++i) base[i] = nv*i;
-
-    std::vector<Entry>  entries;
-    for(uint vid=0; vid<m.num_verts(); ++vid)
-    {
-        double mass = m.vert_mass(vid);
-        for(int i=0; i<n; ++i) entries.push_back(Entry(base[i] + vid, base[i] + vid, mass));
-    }
-
-    nv = n*m.num_verts();
-    Eigen::SparseMatrix<double> MM(nv, nv);
-    MM.setFromTriplets(entries.begin(), entries.end());
-
+    Eigen::SparseMatrix<double> MM;
+    OperatorAssembler assembler;
+    assembler.mass_matrix(m, MM, n);
     return MM;
 }
 
-
 }
-
@@ -36,7 +36,10 @@
 #include <cinolib/voxelize.h>
 #include <cinolib/serialize_index.h>
 #include <cinolib/parallel_for.h>
+#include <cinolib/fast_winding_number.h>
+#include <cinolib/batch_intersection_tests.h>
 #include <mutex>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -45,11 +48,18 @@ namespace cinolib
 // as being entirely inside, outside or traversed by the boundary of the
 // input surface mesh, which can contain triangles, quads or general polygons.
 //
+// By default, voxels not traversed by the boundary are classified as inside
+// or outside by flooding the outside, which is correct only for watertight
+// meshes. If use_winding_number is true, each voxel is rather classified by
+// evaluating the generalized winding number at its center, which gives
+// meaningful results also for meshes with holes or triangle soups.
+//
 template<class M, class V, class E, class P>
 CINO_INLINE
 void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
               const uint                           max_voxels_per_side,
-                    VoxelGrid                    & g)
+                    VoxelGrid                    & g,
+              const bool                           use_winding_number)
 {
     // pad the bbox to ease the subsequent inside/outside labeling
     g.bbox = m.bbox();
@@ -71,36 +81,58 @@ void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
     std::mutex mutex;
     PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
     {
-        AABB  box = m.poly_aabb(pid);
-        vec3d beg = (box.min - g.bbox.min)/g.len;
-        vec3d end = (box.max - g.bbox.min)/g.len;
-
-        for(uint i=uint(floor(beg[0])); i<uint(ceil(end[0])); ++i)
-        for(uint j=uint(floor(beg[1])); j<uint(ceil(end[1])); ++j)
-        for(uint k=uint(floor(beg[2])); k<uint(ceil(end[2])); ++k)
+        std::vector<uint> voxel_ids;
+        std::vector<AABB> voxel_boxes;
+        std::vector<bool> hits;
+        for(uint tid=0; tid<m.poly_tessellation(pid).size()/3; ++tid)
         {
-            uint index = serialize_3D_index(i,j,k,g.dim[1],g.dim[2]);
-            if(g.voxels[index]==VOXEL_UNKNOWN)
+            vec3d t[3] = { m.vert(m.poly_tessellation(pid).at(3*tid+0)),
+                           m.vert(m.poly_tessellation(pid).at(3*tid+1)),
+                           m.vert(m.poly_tessellation(pid).at(3*tid+2)) };
+
+            // gather the voxels overlapping with the triangle bbox, and test them all at once
+            AABB  box(std::vector<vec3d>({t[0],t[1],t[2]}));
+            vec3d beg = (box.min - g.bbox.min)/g.len;
+            vec3d end = (box.max - g.bbox.min)/g.len;
+            voxel_ids.clear();
+            voxel_boxes.clear();
+            for(uint i=uint(floor(beg[0])); i<uint(ceil(end[0])); ++i)
+            for(uint j=uint(floor(beg[1])); j<uint(ceil(end[1])); ++j)
+            for(uint k=uint(floor(beg[2])); k<uint(ceil(end[2])); ++k)
             {
-                vec3u ijk(i,j,k);
-                AABB voxel = voxel_bbox(g,ijk.ptr());
-                for(uint i=0; i<m.poly_tessellation(pid).size()/3; ++i)
+                uint index = serialize_3D_index(i,j,k,g.dim[1],g.dim[2]);
+                if(g.voxels[index]==VOXEL_UNKNOWN) // do not test voxels already known to be on the boundary
                 {
-                    vec3d t[3] = { m.vert(m.poly_tessellation(pid).at(3*i+0)),
-                                   m.vert(m.poly_tessellation(pid).at(3*i+1)),
-                                   m.vert(m.poly_tessellation(pid).at(3*i+2)) };
-
-                    if(voxel.intersects_triangle(t))
-                    {
-                        std::lock_guard<std::mutex> guard(mutex);
-                        g.voxels[index] = VOXEL_BOUNDARY;
-                        break; // do not test other triangles for this boundary voxel...
-                    }
+                    vec3u ijk(i,j,k);
+                    voxel_ids.push_back(index);
+                    voxel_boxes.push_back(voxel_bbox(g,ijk.ptr()));
                 }
             }
+            triangle_boxes_intersect(t, voxel_boxes, hits);
+
+            if(std::find(hits.begin(), hits.end(), true)==hits.end()) continue;
+            std::lock_guard<std::mutex> guard(mutex);
+            for(uint j=0; j<voxel_ids.size(); ++j)
+            {
+                if(hits.at(j)) g.voxels[voxel_ids.at(j)] = VOXEL_BOUNDARY;
+            }
         }
     });
 
+    if(use_winding_number)
+    {
+        FastWindingNumber fwn(m);
+        PARALLEL_FOR(0, size, 1000, [&](uint index)
+        {
+            if(g.voxels[index]==VOXEL_UNKNOWN)
+            {
+                vec3d c = voxel_bbox(g,index).center();
+                g.voxels[index] = fwn.is_inside(c) ? VOXEL_INSIDE : VOXEL_OUTSIDE;
+            }
+        });
+        return;
+    }
+
     // flood the outside
     std::queue<uint> q;
     q.push(0); // voxel zero is guaranteed to be outside (due to the previous padding)
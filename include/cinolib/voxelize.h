@@ -46,11 +46,18 @@ namespace cinolib
 // as being entirely inside, outside or traversed by the boundary of the
 // input surface mesh, which can contain triangles, quads or general polygons.
 //
+// By default, voxels not traversed by the boundary are classified as inside
+// or outside by flooding the outside, which is correct only for watertight
+// meshes. If use_winding_number is true, each voxel is rather classified by
+// evaluating the generalized winding number at its center, which gives
+// meaningful results also for meshes with holes or triangle soups.
+//
 template<class M, class V, class E, class P>
 CINO_INLINE
 void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
               const uint                           max_voxels_per_side,
-                    VoxelGrid                    & g);
+                    VoxelGrid                    & g,
+              const bool                           use_winding_number = false);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
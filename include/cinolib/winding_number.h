@@ -33,8 +33,8 @@
 *     16149 Genoa,                                                              *
 *     Italy                                                                     *
 *********************************************************************************/
-#ifndef CINO_VERTEX_MASS_H
-#define CINO_VERTEX_MASS_H
+#ifndef CINO_WINDING_NUMBER_H
+#define CINO_WINDING_NUMBER_H
 
 #include <cinolib/meshes/abstract_polygonmesh.h>
 
@@ -52,6 +52,10 @@ namespace cinolib
  *
  * WARNING: input meshes are assumed to be watertight 2 manifolds.
  * No explicit checks are performed.
+ *
+ * NOTE: these functions cost O(#tris) per query point. To classify
+ * many points (or to handle non watertight meshes) use the hierarchical
+ * evaluator FastWindingNumber (see fast_winding_number.h)
 */
 
 CINO_INLINE
@@ -71,4 +75,4 @@ int winding_number(const AbstractPolygonMesh<M,V,E,P> & m,
 #include "winding_number.cpp"
 #endif
 
-#endif // CINO_VERTEX_MASS_H
+#endif // CINO_WINDING_NUMBER_H